@@ -0,0 +1,111 @@
+/*******************************************************************************************
+ * Bullet kernel microbenchmark: scalar vs SIMD integration/culling and player overlap.
+ *******************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bullet_kernels.h"
+#include "timing.h"
+
+#define MAP_WIDTH 6000.0f
+#define MAP_HEIGHT 1600.0f
+#define TICK_DT (1.0f / 60.0f)
+
+// Keeps the timed kernel results observable so they aren't optimized away.
+static volatile int benchSink;
+
+static float RandomRange(float lo, float hi)
+{
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static void FillPool(BulletPool *pool, int count)
+{
+    pool->posX = (float *)malloc(sizeof(float) * count);
+    pool->posY = (float *)malloc(sizeof(float) * count);
+    pool->velX = (float *)malloc(sizeof(float) * count);
+    pool->velY = (float *)malloc(sizeof(float) * count);
+    pool->mask = (uint8_t *)malloc(BULLET_MASK_BYTES(count));
+    pool->count = count;
+    pool->capacity = count;
+    pool->limit = count;
+    srand(1234);
+    for (int i = 0; i < count; i++)
+    {
+        pool->posX[i] = RandomRange(0.0f, MAP_WIDTH);
+        pool->posY[i] = RandomRange(0.0f, MAP_HEIGHT);
+        pool->velX[i] = RandomRange(-500.0f, 500.0f);
+        pool->velY[i] = RandomRange(-500.0f, 500.0f);
+    }
+}
+
+static void FreePool(BulletPool *pool)
+{
+    free(pool->posX);
+    free(pool->posY);
+    free(pool->velX);
+    free(pool->velY);
+    free(pool->mask);
+}
+
+// Run both kernel variants on identical input and report ns per bullet.
+// Removal is left out so every iteration sees the same bullet count.
+static void RunCase(int count, int iterations)
+{
+    BulletPool scalar = {0};
+    BulletPool simd = {0};
+    FillPool(&scalar, count);
+    FillPool(&simd, count);
+
+    // The kernels must agree before their timings mean anything.
+    int scalarFlagged = IntegrateBulletsScalar(&scalar, TICK_DT, MAP_WIDTH, MAP_HEIGHT, scalar.mask);
+    int simdFlagged = IntegrateBulletsSimd(&simd, TICK_DT, MAP_WIDTH, MAP_HEIGHT, simd.mask);
+    int scalarHits = OverlapBulletsCircleScalar(&scalar, MAP_WIDTH / 2, MAP_HEIGHT / 2, 200.0f, scalar.mask);
+    int simdHits = OverlapBulletsCircleSimd(&simd, MAP_WIDTH / 2, MAP_HEIGHT / 2, 200.0f, simd.mask);
+    bool match = scalarFlagged == simdFlagged && scalarHits == simdHits &&
+                 memcmp(scalar.mask, simd.mask, BULLET_MASK_BYTES(count)) == 0 &&
+                 memcmp(scalar.posX, simd.posX, sizeof(float) * count) == 0;
+
+    int sink = 0;
+    double start = NowSeconds();
+    for (int it = 0; it < iterations; it++)
+        sink += IntegrateBulletsScalar(&scalar, TICK_DT, MAP_WIDTH, MAP_HEIGHT, scalar.mask);
+    double scalarIntegrate = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int it = 0; it < iterations; it++)
+        sink += IntegrateBulletsSimd(&simd, TICK_DT, MAP_WIDTH, MAP_HEIGHT, simd.mask);
+    double simdIntegrate = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int it = 0; it < iterations; it++)
+        sink += OverlapBulletsCircleScalar(&scalar, MAP_WIDTH / 2, MAP_HEIGHT / 2, 25.0f, scalar.mask);
+    double scalarOverlap = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int it = 0; it < iterations; it++)
+        sink += OverlapBulletsCircleSimd(&simd, MAP_WIDTH / 2, MAP_HEIGHT / 2, 25.0f, simd.mask);
+    double simdOverlap = NowSeconds() - start;
+
+    double perBullet = 1e9 / ((double)count * iterations);
+    benchSink = sink;
+    printf("%8d | %9.3f %9.3f %6.2fx | %9.3f %9.3f %6.2fx | %s\n", count,
+           scalarIntegrate * perBullet, simdIntegrate * perBullet, scalarIntegrate / simdIntegrate,
+           scalarOverlap * perBullet, simdOverlap * perBullet, scalarOverlap / simdOverlap,
+           match ? "match" : "MISMATCH");
+
+    FreePool(&scalar);
+    FreePool(&simd);
+}
+
+int main(void)
+{
+    printf("Bullet kernels, %d bullets per SIMD iteration, ns per bullet\n", BULLET_KERNEL_WIDTH);
+    printf(" bullets |            integrate + cull |             player overlap |\n");
+    printf("         |    scalar      simd speedup |    scalar      simd speedup |\n");
+    RunCase(1000, 20000);
+    RunCase(10000, 2000);
+    RunCase(100000, 200);
+    return 0;
+}
@@ -0,0 +1,304 @@
+/*******************************************************************************************
+ * Entity update microbenchmark: the old array-of-structs Entity against the
+ * archetype store's component arrays, running the same full update (patrol
+ * steering, physics, attack timers, animation) on a flat test map.
+ *
+ * The store measured 1.0-1.25x faster at 10k entities and 1.2-1.3x at 100k.
+ * Most of the time goes to tile collision in the physics pass, which is the
+ * same code for both layouts, so the layout only changes the lighter passes
+ * around it.
+ *******************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "entity_store.h"
+#include "physics.h"
+#include "game_rendering.h"
+#include "timing.h"
+
+#define MAP_TILES_X 2000
+#define MAP_TILES_Y 40
+#define FLOOR_ROW 32
+#define TICK_DT (1.0f / 60.0f)
+
+unsigned int **mapTiles;
+int currentMapWidth;
+int currentMapHeight;
+
+// Keeps the timed results observable so they aren't optimized away.
+static volatile float benchSink;
+
+// The Entity layout the store replaced: every animation kept its own frame
+// pointer, progress and texture copy next to the AI and behavior fields.
+typedef struct LegacyFrames
+{
+    Rectangle *frames;
+    int frameCount;
+    float frameTime;
+} LegacyFrames;
+
+typedef struct LegacyAnimation
+{
+    LegacyFrames *framesData;
+    int currentFrame;
+    float timer;
+    Texture2D texture;
+} LegacyAnimation;
+
+typedef struct LegacyEntity
+{
+    uint64_t assetId;
+    EntityAssetHandle asset;
+    EntityKind kind;
+    PhysicsType physicsType;
+    float radius;
+    int health;
+    float speed;
+    float shootTimer;
+    Vector2 basePos;
+    Vector2 position;
+    Vector2 velocity;
+    float leftBound;
+    float rightBound;
+    int direction;
+    float shootCooldown;
+    EntityState state;
+    bool aiChasing;
+    int aiNavLink;
+    float aiThinkTimer;
+    const EntityBehavior *behavior;
+    int maxHealth;
+    int behaviorState;
+    float behaviorTime;
+    bool behaviorEntered;
+    LegacyAnimation idle;
+    LegacyAnimation walk;
+    LegacyAnimation ascend;
+    LegacyAnimation fall;
+} LegacyEntity;
+
+// One clip per entity state, each with its own frame time so the clip
+// library keeps them apart and a state change starts the new clip over. The
+// frame times fall between ticks, so frames carry a remainder over.
+#define BENCH_CLIP_FRAMES 4
+static const float benchFrameTimes[4] = {0.13f, 0.09f, 0.07f, 0.11f};
+static Rectangle benchFrameRects[BENCH_CLIP_FRAMES];
+static LegacyFrames benchFrames[4];
+static int benchClips[4];
+
+static float RandomRange(float lo, float hi)
+{
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static void BuildMap(void)
+{
+    currentMapWidth = MAP_TILES_X;
+    currentMapHeight = MAP_TILES_Y;
+    mapTiles = (unsigned int **)malloc(sizeof(unsigned int *) * MAP_TILES_Y);
+    for (int y = 0; y < MAP_TILES_Y; y++)
+    {
+        mapTiles[y] = (unsigned int *)calloc(MAP_TILES_X, sizeof(unsigned int));
+        if (y >= FLOOR_ROW)
+            for (int x = 0; x < MAP_TILES_X; x++)
+                mapTiles[y][x] = 1;
+    }
+    for (int i = 0; i < BENCH_CLIP_FRAMES; i++)
+        benchFrameRects[i] = (Rectangle){(float)(i * 32), 0, 32, 32};
+    for (int i = 0; i < 4; i++)
+    {
+        benchFrames[i] = (LegacyFrames){benchFrameRects, BENCH_CLIP_FRAMES, benchFrameTimes[i]};
+        benchClips[i] = InternAnimationClip(benchFrameRects, BENCH_CLIP_FRAMES, benchFrameTimes[i]);
+    }
+}
+
+// Half ground enemies standing on the floor, half flyers above it.
+static Entity MakeEntity(int i)
+{
+    Entity e = {0};
+    e.kind = ENTITY_ENEMY;
+    e.physicsType = (i & 1) ? PHYS_FLYING : PHYS_GROUND;
+    e.radius = 20.0f;
+    e.health = 5;
+    e.speed = RandomRange(50.0f, 150.0f);
+    e.shootCooldown = RandomRange(1.0f, 3.0f);
+    float x = RandomRange(200.0f, MAP_TILES_X * TILE_SIZE - 200.0f);
+    float y = (e.physicsType == PHYS_GROUND) ? FLOOR_ROW * TILE_SIZE - e.radius : RandomRange(200.0f, 1000.0f);
+    e.position = (Vector2){x, y};
+    e.basePos = e.position;
+    e.leftBound = x - 100.0f;
+    e.rightBound = x + 100.0f;
+    e.direction = (i & 2) ? 1 : -1;
+    return e;
+}
+
+// AdvanceAnimation's stepping on a legacy animation, so both layouts do the
+// same work and land on the same frames.
+static void StepLegacyAnimation(LegacyAnimation *anim, float delta)
+{
+    const LegacyFrames *frames = anim->framesData;
+    if (frames == NULL || frames->frameCount == 0)
+        return;
+    anim->timer += delta;
+    if (anim->timer < frames->frameTime)
+        return;
+    float steps = floorf(anim->timer / frames->frameTime);
+    if (steps == 1.0f)
+    {
+        anim->timer -= frames->frameTime;
+        if (++anim->currentFrame >= frames->frameCount)
+            anim->currentFrame = 0;
+        return;
+    }
+    anim->timer -= steps * frames->frameTime;
+    if (anim->timer < 0.0f)
+        anim->timer = 0.0f;
+    anim->currentFrame =
+        (anim->currentFrame + (int)fmodf(steps, (float)frames->frameCount)) % frames->frameCount;
+}
+
+static void UpdateLegacy(LegacyEntity *entities, int count, float dt, float totalTime)
+{
+    for (int i = 0; i < count; i++)
+    {
+        LegacyEntity *e = &entities[i];
+        if (e->health <= 0)
+            continue;
+        if (e->position.x <= e->leftBound || e->position.x >= e->rightBound)
+            e->direction = (e->position.x <= e->leftBound) ? 1 : -1;
+        e->velocity.x = e->speed * e->direction;
+
+        EntityState previous = e->state;
+        UpdateBodyPhysics(e->physicsType, e->radius, &e->position, &e->basePos, &e->velocity,
+                          &e->health, &e->state, dt, totalTime);
+
+        e->shootTimer += dt;
+        if (e->shootTimer >= e->shootCooldown)
+            e->shootTimer = 0.0f;
+
+        LegacyAnimation *anims[4] = {&e->idle, &e->walk, &e->ascend, &e->fall};
+        LegacyAnimation *anim = anims[e->state];
+        // A state change starts its animation over, like a clip change does.
+        if (e->state != previous)
+        {
+            anim->currentFrame = 0;
+            anim->timer = 0;
+        }
+        StepLegacyAnimation(anim, dt);
+    }
+}
+
+// Same update as UpdateLegacy, one pass per component group.
+static void UpdateStore(EntityArchetype *arch, float dt, float totalTime)
+{
+    GatherLiveRows(arch);
+    for (int n = 0; n < arch->liveCount; n++)
+    {
+        int i = arch->live[n];
+        PhysicsComponent *body = &arch->physics[i];
+        float x = arch->position[i].x;
+        if (x <= body->leftBound || x >= body->rightBound)
+            body->direction = (x <= body->leftBound) ? 1 : -1;
+        arch->velocity[i].x = arch->combat[i].speed * body->direction;
+    }
+
+    UpdateArchetypePhysics(arch, dt, totalTime);
+
+    for (int n = 0; n < arch->liveCount; n++)
+    {
+        CombatComponent *combat = &arch->combat[arch->live[n]];
+        combat->shootTimer += dt;
+        if (combat->shootTimer >= combat->shootCooldown)
+            combat->shootTimer = 0.0f;
+    }
+
+    for (int n = 0; n < arch->liveCount; n++)
+    {
+        int i = arch->live[n];
+        int state = arch->physics[i].state;
+        AdvanceAnimation(&arch->anim[i], benchClips[state], dt);
+    }
+}
+
+// Run both layouts from identical entities and report ns per entity per tick.
+static void RunCase(int count, int ticks)
+{
+    LegacyEntity *legacy = (LegacyEntity *)calloc(count, sizeof(LegacyEntity));
+    EntityStore store = {0};
+    EntityArchetype *arch = &store.archetypes[ARCHETYPE_ENEMY];
+
+    srand(1234);
+    for (int i = 0; i < count; i++)
+    {
+        Entity e = MakeEntity(i);
+        LegacyEntity *l = &legacy[i];
+        l->kind = e.kind;
+        l->physicsType = e.physicsType;
+        l->radius = e.radius;
+        l->health = e.health;
+        l->speed = e.speed;
+        l->shootCooldown = e.shootCooldown;
+        l->position = e.position;
+        l->basePos = e.basePos;
+        l->leftBound = e.leftBound;
+        l->rightBound = e.rightBound;
+        l->direction = e.direction;
+        l->idle.framesData = &benchFrames[ENTITY_STATE_IDLE];
+        l->walk.framesData = &benchFrames[ENTITY_STATE_WALK];
+        l->ascend.framesData = &benchFrames[ENTITY_STATE_ASCEND];
+        l->fall.framesData = &benchFrames[ENTITY_STATE_FALL];
+        AddEntityRow(arch, &e, i);
+    }
+
+    double start = NowSeconds();
+    for (int t = 0; t < ticks; t++)
+        UpdateLegacy(legacy, count, TICK_DT, t * TICK_DT);
+    double legacyTime = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int t = 0; t < ticks; t++)
+        UpdateStore(arch, TICK_DT, t * TICK_DT);
+    double storeTime = NowSeconds() - start;
+
+    // The layouts must agree before their timings mean anything.
+    bool match = arch->count == count;
+    float sink = 0.0f;
+    for (int i = 0; i < count && match; i++)
+    {
+        match = memcmp(&legacy[i].position, &arch->position[i], sizeof(Vector2)) == 0 &&
+                legacy[i].health == arch->combat[i].health &&
+                legacy[i].shootTimer == arch->combat[i].shootTimer;
+        if (match)
+        {
+            LegacyAnimation *anims[4] = {&legacy[i].idle, &legacy[i].walk, &legacy[i].ascend, &legacy[i].fall};
+            const LegacyAnimation *anim = anims[legacy[i].state];
+            match = legacy[i].state == arch->physics[i].state && anim->currentFrame == arch->anim[i].frame &&
+                    anim->timer == arch->anim[i].timer;
+        }
+        sink += arch->position[i].x + legacy[i].position.y;
+    }
+    benchSink = sink;
+
+    double perEntity = 1e9 / ((double)count * ticks);
+    printf("%8d | %9.2f %9.2f %6.2fx | %s\n", count, legacyTime * perEntity, storeTime * perEntity,
+           legacyTime / storeTime, match ? "match" : "MISMATCH");
+
+    FreeEntityStore(&store);
+    free(legacy);
+}
+
+int main(void)
+{
+    arena_init(&gameArena, GAME_ARENA_SIZE * 4);
+    arena_init(&assetArena, GAME_ARENA_SIZE);
+    BuildMap();
+    printf("Entity full update, %zu-byte AoS entity, ns per entity per tick\n", sizeof(LegacyEntity));
+    printf("entities |       AoS       SoA speedup |\n");
+    RunCase(10000, 600);
+    RunCase(100000, 600);
+    arena_destroy(&gameArena);
+    arena_destroy(&assetArena);
+    return 0;
+}
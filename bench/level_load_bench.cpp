@@ -0,0 +1,187 @@
+/*******************************************************************************************
+ * Text level load benchmark: the tile block of a generated 2000x2000 .level file read the
+ * way LoadLevel used to (fscanf per tile) and the way it does now (the file mapped in one
+ * go and parsed by the text scanner, scalar and SIMD). Then the same tiles run-length
+ * encoded as binary levels store them, with the encoded size and the decode time.
+ *******************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "file_io.h"
+#include "text_scanner.h"
+#include "level_format.h"
+#include "timing.h"
+
+#define BENCH_MAP_SIZE 2000
+#define BENCH_RUNS 5
+#define BENCH_LEVEL_PATH "level_load_bench.level"
+
+// Mostly empty, like the shipped levels: a ground strip, scattered platforms
+// and walls, written as SaveLevel wrote text levels ("%d " per tile).
+static bool WriteBenchLevel(const char *path, int width, int height)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+        return false;
+    fprintf(file, "%d %d\n", width, height);
+    unsigned int seed = 12345;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            int tile = 0;
+            if (y >= height - 3)
+                tile = 1 + (x % 3);
+            else if ((seed >> 24) < 8)
+                tile = 1 + (int)((seed >> 8) % 12);
+            fprintf(file, "%d ", tile);
+        }
+        fprintf(file, "\n");
+    }
+    fprintf(file, "ENEMY_COUNT 0\nCHECKPOINT_COUNT 0\nSPAWNER_COUNT 0\n");
+    return fclose(file) == 0;
+}
+
+static unsigned long long Checksum(const unsigned int *tiles, int count)
+{
+    unsigned long long sum = 0;
+    for (int i = 0; i < count; i++)
+        sum = sum * 31 + tiles[i];
+    return sum;
+}
+
+// The previous loader: fscanf for the size, then for every tile.
+static bool LoadTilesFscanf(const char *path, unsigned int *tiles, int *count)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+        return false;
+    int cols, rows;
+    bool ok = fscanf(file, "%d %d", &cols, &rows) == 2;
+    for (int i = 0; ok && i < cols * rows; i++)
+    {
+        int tile;
+        ok = fscanf(file, "%d", &tile) == 1;
+        tiles[i] = (unsigned int)tile;
+    }
+    fclose(file);
+    *count = cols * rows;
+    return ok;
+}
+
+static bool LoadTilesScanner(const char *path, unsigned int *tiles, int *count, bool simd)
+{
+    MappedFile mapped;
+    if (!MapFile(path, &mapped))
+        return false;
+    TextScanner scanner = MakeTextScanner(mapped.data, mapped.size);
+    int cols, rows;
+    bool ok = ScanInt(&scanner, &cols) && ScanInt(&scanner, &rows);
+    // Row by row, as LoadLevel fills the tilemap.
+    for (int y = 0; ok && y < rows; y++)
+    {
+        unsigned int *row = tiles + (size_t)y * cols;
+        int read = simd ? ScanUIntArraySimd(&scanner, row, cols) : ScanUIntArrayScalar(&scanner, row, cols);
+        ok = (read == cols);
+    }
+    UnmapFile(&mapped);
+    *count = cols * rows;
+    return ok;
+}
+
+// Best of BENCH_RUNS, in seconds; the first run also warms the page cache.
+static double TimeLoader(int loader, unsigned int *tiles, int *count, bool *ok)
+{
+    double best = 1e30;
+    *ok = true;
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        double start = NowSeconds();
+        bool loaded = (loader == 0) ? LoadTilesFscanf(BENCH_LEVEL_PATH, tiles, count)
+                                    : LoadTilesScanner(BENCH_LEVEL_PATH, tiles, count, loader == 2);
+        double elapsed = NowSeconds() - start;
+        *ok = *ok && loaded;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+int main(void)
+{
+    if (!WriteBenchLevel(BENCH_LEVEL_PATH, BENCH_MAP_SIZE, BENCH_MAP_SIZE))
+    {
+        fprintf(stderr, "Can't write %s\n", BENCH_LEVEL_PATH);
+        return 1;
+    }
+    MappedFile file;
+    size_t fileSize = MapFile(BENCH_LEVEL_PATH, &file) ? file.size : 0;
+    UnmapFile(&file);
+
+    int tileCount = BENCH_MAP_SIZE * BENCH_MAP_SIZE;
+    unsigned int *tiles = (unsigned int *)malloc(sizeof(unsigned int) * tileCount);
+    if (!tiles)
+        return 1;
+
+    static const char *names[] = {"fscanf", "scanner (scalar)", "scanner (SIMD)"};
+    double times[3];
+    unsigned long long checksums[3];
+    bool ok[3];
+    for (int loader = 0; loader < 3; loader++)
+    {
+        int count = 0;
+        memset(tiles, 0xFF, sizeof(unsigned int) * tileCount);
+        times[loader] = TimeLoader(loader, tiles, &count, &ok[loader]);
+        ok[loader] = ok[loader] && count == tileCount;
+        checksums[loader] = Checksum(tiles, tileCount);
+    }
+
+    printf("Text level load, %dx%d tiles, %.1f MB, best of %d (SIMD scanner: %s)\n", BENCH_MAP_SIZE, BENCH_MAP_SIZE,
+           fileSize / (1024.0 * 1024.0), BENCH_RUNS, TEXT_SCANNER_SIMD ? "SSE2" : "scalar fallback");
+    printf(" loader           |      ms     MB/s  speedup |\n");
+    for (int loader = 0; loader < 3; loader++)
+    {
+        bool match = ok[loader] && checksums[loader] == checksums[0];
+        printf(" %-16s | %7.1f %8.1f %7.2fx | %s\n", names[loader], times[loader] * 1e3,
+               fileSize / (1024.0 * 1024.0) / times[loader], times[0] / times[loader], match ? "match" : "MISMATCH");
+    }
+
+    // The binary format's run-length encoded tile section, decoded row by row
+    // into a tilemap as LoadLevel does.
+    unsigned int **rows = (unsigned int **)malloc(sizeof(unsigned int *) * BENCH_MAP_SIZE);
+    unsigned int *decoded = (unsigned int *)malloc(sizeof(unsigned int) * tileCount);
+    if (!rows || !decoded)
+        return 1;
+    for (int y = 0; y < BENCH_MAP_SIZE; y++)
+        rows[y] = tiles + (size_t)y * BENCH_MAP_SIZE;
+    size_t rleSize = EncodeLevelTilesRle(rows, BENCH_MAP_SIZE, BENCH_MAP_SIZE, NULL);
+    unsigned char *rle = (unsigned char *)malloc(rleSize);
+    if (!rle)
+        return 1;
+    EncodeLevelTilesRle(rows, BENCH_MAP_SIZE, BENCH_MAP_SIZE, rle);
+    for (int y = 0; y < BENCH_MAP_SIZE; y++)
+        rows[y] = decoded + (size_t)y * BENCH_MAP_SIZE;
+    double decodeTime = 1e30;
+    bool decodedOk = true;
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        double start = NowSeconds();
+        decodedOk = DecodeLevelTilesRle(rle, rleSize, rows, BENCH_MAP_SIZE, BENCH_MAP_SIZE) && decodedOk;
+        double elapsed = NowSeconds() - start;
+        if (elapsed < decodeTime)
+            decodeTime = elapsed;
+    }
+    bool rleMatch = decodedOk && memcmp(tiles, decoded, sizeof(unsigned int) * tileCount) == 0;
+    printf("Run-length encoded tiles: %.1f MB raw -> %.1f KB, decode %.1f ms | %s\n",
+           sizeof(unsigned int) * (double)tileCount / (1024.0 * 1024.0), rleSize / 1024.0, decodeTime * 1e3,
+           rleMatch ? "match" : "MISMATCH");
+
+    free(rle);
+    free(decoded);
+    free(rows);
+    free(tiles);
+    remove(BENCH_LEVEL_PATH);
+    return 0;
+}
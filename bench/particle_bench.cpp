@@ -0,0 +1,115 @@
+/*******************************************************************************************
+ * Particle engine microbenchmark: scalar vs SIMD integration, and a steady-state stress
+ * run that keeps 100k particles alive while bursts spawn and expire every frame.
+ *******************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "particles.h"
+#include "memory_arena.h"
+#include "timing.h"
+
+#define TICK_DT (1.0f / 60.0f)
+#define STRESS_PARTICLES 100000
+#define STRESS_FRAMES 600
+
+// Keeps the timed kernel results observable so they aren't optimized away.
+static volatile int benchSink;
+
+// Lifetimes long enough that nothing expires while the kernels are timed.
+static const ParticleBurst benchBurst = {1000, 50.0f, 400.0f, PI, 1000.0f, 2000.0f, 1.0f, 3.0f, 300.0f,
+                                         {255, 255, 255, 255}, 40, true};
+
+static void FillSystem(ParticleSystem *system, int count)
+{
+    InitParticleSystem(system, count, 1234);
+    while (system->count < count)
+        EmitParticleBurst(system, &benchBurst, (Vector2){(float)(system->count % 6000), 800.0f}, (Vector2){0, 0});
+}
+
+// Run both kernel variants on identical input and report ns per particle.
+static void RunKernelCase(int count, int iterations)
+{
+    ParticleSystem scalar;
+    ParticleSystem simd;
+    FillSystem(&scalar, count);
+    FillSystem(&simd, count);
+
+    // The kernels must agree before their timings mean anything.
+    int scalarExpired = IntegrateParticlesScalar(&scalar, TICK_DT, scalar.mask);
+    int simdExpired = IntegrateParticlesSimd(&simd, TICK_DT, simd.mask);
+    bool match = scalarExpired == simdExpired &&
+                 memcmp(scalar.mask, simd.mask, PARTICLE_MASK_BYTES(count)) == 0 &&
+                 memcmp(scalar.posX, simd.posX, sizeof(float) * count) == 0 &&
+                 memcmp(scalar.posY, simd.posY, sizeof(float) * count) == 0 &&
+                 memcmp(scalar.velY, simd.velY, sizeof(float) * count) == 0;
+
+    int sink = 0;
+    double start = NowSeconds();
+    for (int it = 0; it < iterations; it++)
+        sink += IntegrateParticlesScalar(&scalar, TICK_DT, scalar.mask);
+    double scalarTime = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int it = 0; it < iterations; it++)
+        sink += IntegrateParticlesSimd(&simd, TICK_DT, simd.mask);
+    double simdTime = NowSeconds() - start;
+
+    double perParticle = 1e9 / ((double)count * iterations);
+    benchSink = sink;
+    printf("%9d | %9.3f %9.3f %6.2fx | %s\n", count, scalarTime * perParticle, simdTime * perParticle,
+           scalarTime / simdTime, match ? "match" : "MISMATCH");
+
+    FreeParticleSystem(&scalar);
+    FreeParticleSystem(&simd);
+}
+
+// Hold the system near STRESS_PARTICLES: particles live 1-3 s, so each frame
+// tops it back up with firework bursts, then updates and compacts it.
+static void RunStress(void)
+{
+    ParticleSystem system;
+    InitParticleSystem(&system, STRESS_PARTICLES, 99);
+    ParticleBurst burst = particleEffects[PARTICLE_EFFECT_FIREWORK];
+    burst.count = 500;
+
+    double emitTime = 0.0;
+    double updateTime = 0.0;
+    double worstFrame = 0.0;
+    long long spawned = 0;
+    for (int frame = 0; frame < STRESS_FRAMES; frame++)
+    {
+        double frameStart = NowSeconds();
+        while (system.count + burst.count <= STRESS_PARTICLES)
+            spawned += EmitParticleBurst(&system, &burst, (Vector2){(float)(spawned % 1280), 200.0f}, (Vector2){0, 0});
+        double emitted = NowSeconds();
+        UpdateParticles(&system, TICK_DT);
+        double frameEnd = NowSeconds();
+
+        emitTime += emitted - frameStart;
+        updateTime += frameEnd - emitted;
+        if (frameEnd - frameStart > worstFrame)
+            worstFrame = frameEnd - frameStart;
+    }
+
+    printf("Stress: %d particles for %d frames, %lld spawned\n", STRESS_PARTICLES, STRESS_FRAMES, spawned);
+    printf("  emit %.3f ms/frame, update + compact %.3f ms/frame, worst frame %.3f ms\n",
+           emitTime * 1e3 / STRESS_FRAMES, updateTime * 1e3 / STRESS_FRAMES, worstFrame * 1e3);
+    FreeParticleSystem(&system);
+}
+
+int main(void)
+{
+    arena_init(&assetArena, 2 * GAME_ARENA_SIZE);
+    SetTraceLogLevel(LOG_WARNING);
+
+    printf("Particle integration, %d particles per SIMD iteration, ns per particle\n", PARTICLE_KERNEL_WIDTH);
+    printf(" particles |    scalar      simd speedup |\n");
+    RunKernelCase(1000, 20000);
+    RunKernelCase(10000, 2000);
+    RunKernelCase(100000, 200);
+    RunStress();
+
+    arena_destroy(&assetArena);
+    return 0;
+}
@@ -30,14 +30,82 @@ if %ERRORLEVEL% neq 0 (
     exit /b 1
 )
 
+:: Build the microbenchmarks instead of the game
+if /I "%2"=="bench" (
+    g++ -O2 %ARCH_FLAG% -I "%CD%\raylib\include" -I "%CD%\src" ^
+        -o build/bullet_bench.exe bench/bullet_bench.cpp src/bullet_kernels.cpp -static
+    if !ERRORLEVEL! neq 0 (
+        echo Build failed!
+        exit /b !ERRORLEVEL!
+    )
+    g++ -O2 %ARCH_FLAG% -I "%CD%\raylib\include" -I "%CD%\src" ^
+        -o build/entity_bench.exe bench/entity_bench.cpp src/physics.cpp src/entity_store.cpp src/animation_clips.cpp src/memory_arena.cpp ^
+        -L "%LIB_PATH%" -lraylib -lopengl32 -lgdi32 -lwinmm -static
+    if !ERRORLEVEL! neq 0 (
+        echo Build failed!
+        exit /b !ERRORLEVEL!
+    )
+    g++ -O2 %ARCH_FLAG% -I "%CD%\raylib\include" -I "%CD%\src" ^
+        -o build/particle_bench.exe bench/particle_bench.cpp src/particles.cpp src/memory_arena.cpp ^
+        -L "%LIB_PATH%" -lraylib -lopengl32 -lgdi32 -lwinmm -static
+    if !ERRORLEVEL! neq 0 (
+        echo Build failed!
+        exit /b !ERRORLEVEL!
+    )
+    g++ -O2 %ARCH_FLAG% -I "%CD%\raylib\include" -I "%CD%\src" ^
+        -o build/level_load_bench.exe bench/level_load_bench.cpp src/text_scanner.cpp src/level_format.cpp src/windows_file_io.cpp src/memory_arena.cpp ^
+        -L "%LIB_PATH%" -lraylib -lopengl32 -lgdi32 -lwinmm -static
+    if !ERRORLEVEL! neq 0 (
+        echo Build failed!
+        exit /b !ERRORLEVEL!
+    )
+    echo Build succeeded!
+    exit /b 0
+)
+
+:: Build the headless runner and the level and asset tools: the simulation only, with no window, GPU or ImGui
+if /I "%2"=="headless" (
+    g++ -O2 %DEBUG_FLAG% %ARCH_FLAG% -I "%CD%\raylib\include" -I "%CD%\src" ^
+        -o build/headless.exe src/headless_main.cpp src/memory_arena.cpp src/windows_file_io.cpp src/windows_file_watch.cpp ^
+        src/game_storage.cpp src/level_format.cpp src/text_scanner.cpp src/asset_pack.cpp src/tileset.cpp src/game_rendering.cpp src/sprite_batch.cpp src/physics.cpp src/ai.cpp src/bullet.cpp ^
+        src/bullet_kernels.cpp src/bullet_pattern.cpp src/entity_helpers.cpp src/game_sim.cpp src/replay.cpp src/nav_graph.cpp ^
+        src/flow_field.cpp src/ai_scheduler.cpp src/behavior.cpp src/entity_store.cpp src/spawner.cpp src/asset_reload.cpp ^
+        src/animation.cpp src/animation_clips.cpp ^
+        -L "%LIB_PATH%" -lraylib -lopengl32 -lgdi32 -lwinmm -static -static-libgcc -static-libstdc++
+    if !ERRORLEVEL! neq 0 (
+        echo Build failed!
+        exit /b !ERRORLEVEL!
+    )
+    g++ -O2 %DEBUG_FLAG% %ARCH_FLAG% -I "%CD%\raylib\include" -I "%CD%\src" ^
+        -o build/level_convert.exe tools/level_convert.cpp src/memory_arena.cpp src/windows_file_io.cpp src/windows_file_watch.cpp ^
+        src/game_storage.cpp src/level_format.cpp src/text_scanner.cpp src/asset_pack.cpp src/tileset.cpp src/game_rendering.cpp src/sprite_batch.cpp src/physics.cpp src/ai.cpp src/bullet.cpp ^
+        src/bullet_kernels.cpp src/bullet_pattern.cpp src/entity_helpers.cpp src/game_sim.cpp src/replay.cpp src/nav_graph.cpp ^
+        src/flow_field.cpp src/ai_scheduler.cpp src/behavior.cpp src/entity_store.cpp src/spawner.cpp src/asset_reload.cpp ^
+        src/animation.cpp src/animation_clips.cpp ^
+        -L "%LIB_PATH%" -lraylib -lopengl32 -lgdi32 -lwinmm -static -static-libgcc -static-libstdc++
+    if !ERRORLEVEL! neq 0 (
+        echo Build failed!
+        exit /b !ERRORLEVEL!
+    )
+    g++ -O2 %DEBUG_FLAG% %ARCH_FLAG% -I "%CD%\raylib\include" -I "%CD%\src" ^
+        -o build/pack_assets.exe tools/pack_assets.cpp src/asset_pack.cpp src/memory_arena.cpp src/windows_file_io.cpp ^
+        -L "%LIB_PATH%" -lraylib -lopengl32 -lgdi32 -lwinmm -static -static-libgcc -static-libstdc++
+    if !ERRORLEVEL! neq 0 (
+        echo Build failed!
+        exit /b !ERRORLEVEL!
+    )
+    echo Build succeeded!
+    exit /b 0
+)
+
 :: Compile
 g++ %BUILD_FLAG% %DEBUG_FLAG% %ARCH_FLAG% ^
     -o %OUTPUT% ^
     -I "%CD%\raylib\include" ^
     -I "%CD%\imgui" ^
     -I "%CD%\raylib-imgui" ^
-    src/main.cpp src/memory_arena.cpp src/windows_file_io.cpp src/editor_mode.cpp src/game_storage.cpp src/game_rendering.cpp src/physics.cpp ^
-    src/tile_editor.cpp src/ai.cpp src/bullet.cpp src/game_ui.cpp src/entity_helpers.cpp ^
+    src/main.cpp src/memory_arena.cpp src/windows_file_io.cpp src/windows_file_watch.cpp src/editor_mode.cpp src/game_storage.cpp src/level_format.cpp src/text_scanner.cpp src/asset_pack.cpp src/game_rendering.cpp src/physics.cpp ^
+    src/tile_editor.cpp src/tileset.cpp src/ai.cpp src/bullet.cpp src/game_ui.cpp src/entity_helpers.cpp src/game_sim.cpp src/replay.cpp src/bullet_kernels.cpp src/bullet_pattern.cpp src/circle_batch.cpp src/sprite_batch.cpp src/particles.cpp src/render_snapshot.cpp src/sim_thread.cpp src/nav_graph.cpp src/flow_field.cpp src/ai_scheduler.cpp src/behavior.cpp src/entity_store.cpp src/spawner.cpp src/asset_reload.cpp src/animation.cpp src/animation_clips.cpp ^
     imgui\imgui.cpp imgui\imgui_draw.cpp imgui\imgui_tables.cpp imgui\imgui_widgets.cpp ^
     raylib-imgui\rlImGui.cpp ^
     -L "%LIB_PATH%" ^
@@ -3,88 +3,305 @@
 #include "physics.h"
 #include "game_rendering.h"
 
-// GroundEnemyAI:
-// For ground enemies, if the player is within seek distance, the enemy will
-// adjust its horizontal direction to move toward the player. Otherwise, the enemy
-// patrols. Additionally, the enemy checks a point at its front (at its feet)
-// and turns around if that point collides with a solid tile.
-void GroundEnemyAI(Entity *enemy, const Entity *player, float dt)
+void ResetEnemyAI(BrainComponent *brain)
 {
-    // Compute horizontal distance from enemy to player.
-    float dx = player->position.x - enemy->position.x;
-    float absDx = fabsf(dx);
+    brain->chasing = false;
+    brain->navLink = NAV_NO_PATH;
+    brain->thinkTimer = 0.0f;
+}
 
-    if (absDx < PLAYER_STOP_DISTANCE)
+void InitEnemyBrain(EntityArchetype *arch, int row)
+{
+    ResetEnemyAI(&arch->brain[row]);
+    RebindEnemyAsset(arch, row, true);
+}
+
+void RebindEnemyAsset(EntityArchetype *arch, int row, bool restart)
+{
+    static EntityBehavior fallbackBehavior;
+    if (fallbackBehavior.stateCount == 0)
+        GetDefaultEntityBehavior(ENTITY_ENEMY, "", &fallbackBehavior);
+
+    bool hasAsset = IsEntityAssetHandleValid(arch->asset[row]);
+    EntityAsset *asset = GetEntityAsset(arch->asset[row]);
+    BrainComponent *brain = &arch->brain[row];
+    CombatComponent *combat = &arch->combat[row];
+    brain->behavior = (asset->behavior.stateCount > 0) ? &asset->behavior : &fallbackBehavior;
+    if (hasAsset && asset->baseHp > 0)
+        combat->maxHealth = asset->baseHp;
+    else if (combat->maxHealth <= 0)
+        combat->maxHealth = (combat->health > 0) ? combat->health : 1;
+    if (restart || brain->state >= brain->behavior->stateCount)
     {
-        enemy->velocity.x = 0;
-        return;
+        brain->state = 0;
+        brain->time = 0.0f;
+        brain->entered = true;
     }
+}
 
-    if (absDx < PLAYER_SEEK_DISTANCE)
+float ThinkEnemy(EntityArchetype *arch, int row, const Entity *player, NavGraph *nav)
+{
+    BrainComponent *brain = &arch->brain[row];
+    Vector2 pos = arch->position[row];
+    float cost = AI_COST_DECISION_US;
+    float dx = player->position.x - pos.x;
+    float dy = player->position.y - pos.y;
+    float chaseDistance = brain->behavior ? brain->behavior->sightRange : BEHAVIOR_DEFAULT_SIGHT;
+
+    // Acquire the player on sight, then keep chasing while in range.
+    if (dx * dx + dy * dy >= chaseDistance * chaseDistance || player->health <= 0)
     {
-        // Seek the player.
-        enemy->direction = (dx > 0) ? 1 : -1;
-        enemy->velocity.x = enemy->speed * enemy->direction;
+        brain->chasing = false;
     }
-    else
+    else if (!brain->chasing)
     {
-        // Patrol logic.
-        Vector2 frontPoint = enemy->position;
-        frontPoint.x += enemy->direction * enemy->radius;
-        frontPoint.y += enemy->radius * 0.5f;
+        int tiles = 0;
+        brain->chasing = HasLineOfSight(pos, player->position, &tiles);
+        cost += tiles * AI_COST_LOS_TILE_US;
+    }
 
-        if (!CheckTileCollision(frontPoint, enemy->radius))
-        {
-            enemy->direction *= -1;
-        }
+    brain->navLink = NAV_NO_PATH;
+    if (brain->chasing && arch->physics[row].type == PHYS_GROUND)
+    {
+        int searches = nav->searchCount;
+        int fromSpan = FindNavSpanAt(nav, pos, arch->physics[row].radius);
+        int goalSpan = FindNavSpanAt(nav, player->position, player->radius);
+        int column = (int)floorf(pos.x / TILE_SIZE);
+        brain->navLink = GetNavNextLink(nav, fromSpan, column, goalSpan);
+        cost += (nav->searchCount - searches) * AI_COST_PATH_SEARCH_US;
+    }
+    return cost;
+}
 
-        if (fabsf(enemy->velocity.x) < 0.1f)
-        {
-            enemy->direction *= -1;
-        }
+// Follow the decided navigation link toward the player's span, seeking
+// directly once on the same span. Returns false when there is no path,
+// leaving the caller to patrol.
+static bool FollowNavPath(EntityArchetype *arch, int row, const Entity *player, const NavGraph *nav, float stopDistance)
+{
+    Vector2 pos = arch->position[row];
+    Vector2 *vel = &arch->velocity[row];
+    PhysicsComponent *body = &arch->physics[row];
+    float speed = arch->combat[row].speed;
+
+    // Stay committed to a jump or fall until landing.
+    if (fabsf(vel->y) > 0.001f && !CheckTileCollision(pos, body->radius))
+        return true;
 
-        if (enemy->position.x <= enemy->leftBound || enemy->position.x >= enemy->rightBound)
+    int next = arch->brain[row].navLink;
+    if (next == NAV_NO_PATH || next >= nav->linkCount)
+        return false;
+    if (next == NAV_ARRIVED)
+    {
+        float dx = player->position.x - pos.x;
+        if (fabsf(dx) < stopDistance)
         {
-            enemy->direction *= -1;
+            vel->x = 0;
+            return true;
         }
+        body->direction = (dx > 0) ? 1 : -1;
+        vel->x = speed * body->direction;
+        return true;
+    }
+
+    // The link is stale once the enemy has landed somewhere else; keep
+    // walking and ask for a fresh decision.
+    const NavLink *link = &nav->links[next];
+    if (FindNavSpanAt(nav, pos, body->radius) != link->from)
+    {
+        arch->brain[row].thinkTimer = 0.0f;
+        return true;
+    }
+
+    // Head for the link's exit column, then for its landing column once there.
+    int column = (int)floorf(pos.x / TILE_SIZE);
+    float targetX = (link->fromX + 0.5f) * TILE_SIZE;
+    if (column == link->fromX)
+    {
+        targetX = (link->toX + 0.5f) * TILE_SIZE;
+        if (link->type == NAV_LINK_JUMP && CheckTileCollision(pos, body->radius))
+            vel->y = PLAYER_JUMP_VELOCITY;
+    }
+    body->direction = (targetX > pos.x) ? 1 : -1;
+    vel->x = speed * body->direction;
+    return true;
+}
+
+// Walk between the patrol bounds, turning around at walls, ledges and when stuck.
+// The enemy checks a point at its front (at its feet) and turns around if that
+// point doesn't collide with a solid tile.
+static void PatrolGround(EntityArchetype *arch, int row)
+{
+    Vector2 pos = arch->position[row];
+    Vector2 *vel = &arch->velocity[row];
+    PhysicsComponent *body = &arch->physics[row];
+
+    Vector2 frontPoint = pos;
+    frontPoint.x += body->direction * body->radius;
+    frontPoint.y += body->radius * 0.5f;
+
+    if (!CheckTileCollision(frontPoint, body->radius))
+    {
+        body->direction *= -1;
+    }
+
+    if (fabsf(vel->x) < 0.1f)
+    {
+        body->direction *= -1;
+    }
 
-        enemy->velocity.x = enemy->speed * enemy->direction;
+    if (pos.x <= body->leftBound || pos.x >= body->rightBound)
+    {
+        body->direction *= -1;
+    }
+
+    vel->x = arch->combat[row].speed * body->direction;
+}
+
+// GroundEnemyAI:
+// Moves a ground enemy as its behavior state says. Chasing enemies that have
+// the player in sight (see ThinkEnemy) walk, fall and jump along the
+// navigation graph toward them. Seeking enemies walk at the player within
+// seek distance and stop within stop distance, or else patrol.
+void GroundEnemyAI(EntityArchetype *arch, int row, const Entity *player, const NavGraph *nav,
+                   const BehaviorState *state, float dt)
+{
+    Vector2 *vel = &arch->velocity[row];
+    if (state->move == BEHAVIOR_MOVE_HOLD)
+    {
+        vel->x = 0;
+        return;
+    }
+    if (state->move == BEHAVIOR_MOVE_PATROL)
+    {
+        PatrolGround(arch, row);
+        return;
+    }
+
+    // Compute horizontal distance from enemy to player.
+    float dx = player->position.x - arch->position[row].x;
+    float absDx = fabsf(dx);
+
+    if (state->move == BEHAVIOR_MOVE_CHASE && arch->brain[row].chasing &&
+        FollowNavPath(arch, row, player, nav, state->stopDistance))
+        return;
+
+    if (absDx < state->stopDistance)
+    {
+        vel->x = 0;
+        return;
+    }
+
+    if (absDx < state->seekDistance)
+    {
+        // Seek the player.
+        PhysicsComponent *body = &arch->physics[row];
+        body->direction = (dx > 0) ? 1 : -1;
+        vel->x = arch->combat[row].speed * body->direction;
+    }
+    else
+    {
+        PatrolGround(arch, row);
     }
 }
 
 // FlyingEnemyAI:
-// For flying enemies, if the player is close, they adjust their horizontal velocity
-// to seek the player; otherwise, they patrol using a sinusoidal vertical pattern.
+// Moves a flying enemy as its behavior state says. Chasing enemies with a
+// player in sight they can reach (see ThinkEnemy) follow the shared flow field
+// around walls toward the player's tile. Seeking enemies adjust their
+// horizontal velocity to seek a nearby player; otherwise, they keep their
+// heading. All of them bob using a sinusoidal vertical pattern.
 // The vertical position is set based on a sine wave using totalTime, an amplitude,
 // and a frequency.
-void FlyingEnemyAI(Entity *enemy, const Entity *player, float dt, float totalTime)
+void FlyingEnemyAI(EntityArchetype *arch, int row, const Entity *player, const FlowField *flow,
+                   const BehaviorState *state, float dt, float totalTime)
 {
-    float dx = player->position.x - enemy->position.x;
+    Vector2 *pos = &arch->position[row];
+    Vector2 *vel = &arch->velocity[row];
+    PhysicsComponent *body = &arch->physics[row];
+    float speed = arch->combat[row].speed;
+    float dx = player->position.x - pos->x;
     float absDx = fabsf(dx);
 
-    if (absDx < PLAYER_STOP_DISTANCE)
+    // Steer from the center of the bob, not the bobbing sprite.
+    Vector2 steerPos = {pos->x, arch->basePos[row].y};
+    int flowDistance = GetFlowDistance(flow, steerPos);
+    vel->y = 0;
+
+    bool seeking = state->move == BEHAVIOR_MOVE_SEEK || state->move == BEHAVIOR_MOVE_CHASE;
+    if (state->move == BEHAVIOR_MOVE_HOLD)
+    {
+        vel->x = 0;
+    }
+    else if (state->move == BEHAVIOR_MOVE_CHASE && arch->brain[row].chasing &&
+             flowDistance != FLOW_UNREACHABLE && flowDistance > 1)
+    {
+        Vector2 dir = GetFlowDirection(flow, steerPos);
+        vel->x = dir.x * speed;
+        vel->y = dir.y * speed;
+        if (dir.x != 0)
+            body->direction = (dir.x > 0) ? 1 : -1;
+    }
+    else if (seeking && absDx < state->stopDistance)
     {
-        enemy->velocity.x = 0;
+        vel->x = 0;
     }
-    else if (absDx < PLAYER_SEEK_DISTANCE)
+    else if (seeking && absDx < state->seekDistance)
     {
-        enemy->direction = (dx > 0) ? 1 : -1;
-        enemy->velocity.x = enemy->speed * enemy->direction;
+        body->direction = (dx > 0) ? 1 : -1;
+        vel->x = speed * body->direction;
     }
     else
     {
-        enemy->velocity.x = enemy->speed * enemy->direction;
+        vel->x = speed * body->direction;
     }
 
     // Prevent flying enemy from leaving level bounds.
-    if (enemy->position.x < 0 || enemy->position.x > (currentMapWidth * (float)TILE_SIZE))
+    if (pos->x < 0 || pos->x > (currentMapWidth * (float)TILE_SIZE))
     {
-        enemy->direction *= -1;
-        enemy->velocity.x = enemy->speed * enemy->direction;
+        body->direction *= -1;
+        vel->x = speed * body->direction;
     }
 
     // Vertical sinusoidal patrol.
     float amplitude = 20.0f;
     float frequency = 2.0f;
-    enemy->position.y = enemy->basePos.y + amplitude * sinf(totalTime * frequency);
+    pos->y = arch->basePos[row].y + amplitude * sinf(totalTime * frequency);
+}
+
+void UpdateBehaviorStates(EntityArchetype *arch, const Entity *player, float dt)
+{
+    for (int n = 0; n < arch->liveCount; n++)
+    {
+        int i = arch->live[n];
+        BrainComponent *brain = &arch->brain[i];
+        const EntityBehavior *behavior = brain->behavior;
+        if (!behavior)
+            continue;
+
+        float dx = player->position.x - arch->position[i].x;
+        float dy = player->position.y - arch->position[i].y;
+        const CombatComponent *combat = &arch->combat[i];
+        float inputs[BEHAVIOR_INPUT_COUNT];
+        inputs[BEHAVIOR_INPUT_DISTANCE] = sqrtf(dx * dx + dy * dy);
+        inputs[BEHAVIOR_INPUT_HEALTH] = (float)combat->health / (float)combat->maxHealth;
+        inputs[BEHAVIOR_INPUT_TIME] = brain->time + dt;
+        inputs[BEHAVIOR_INPUT_SIGHT] = brain->chasing ? 1.0f : 0.0f;
+
+        // Walk the state's transitions backwards so the first one that holds
+        // wins without an early exit.
+        int state = brain->state;
+        int next = state;
+        for (int t = behavior->transitionFirst[state + 1] - 1; t >= behavior->transitionFirst[state]; t--)
+        {
+            const BehaviorTransition *tr = &behavior->transitions[t];
+            float input = inputs[tr->input];
+            bool holds = tr->above ? (input > tr->threshold) : (input < tr->threshold);
+            next = holds ? tr->to : next;
+        }
+
+        bool changed = next != state;
+        brain->state = next;
+        brain->time = changed ? 0.0f : inputs[BEHAVIOR_INPUT_TIME];
+        brain->entered = brain->entered || changed;
+    }
 }
@@ -2,11 +2,44 @@
 #define AI_H
 
 #include "entity.h"
+#include "entity_store.h"
+#include "nav_graph.h"
+#include "flow_field.h"
 
-#define PLAYER_SEEK_DISTANCE 100.0f
-#define PLAYER_STOP_DISTANCE 50.0f
+// Estimated cost of the parts of a decision, charged against the AI
+// scheduler's budget. Estimates rather than timings keep the simulation
+// deterministic for replays.
+#define AI_COST_DECISION_US 0.5f
+#define AI_COST_LOS_TILE_US 0.02f
+#define AI_COST_PATH_SEARCH_US 10.0f
 
-void GroundEnemyAI(Entity *enemy, const Entity *player, float dt);
-void FlyingEnemyAI(Entity *enemy, const Entity *player, float dt, float totalTime);
+// Forget the row's decision; the next scheduler tick makes a fresh one.
+void ResetEnemyAI(BrainComponent *brain);
+
+// Give a new row a fresh decision and point it at its asset's behavior (or
+// the built-in enemy behavior when the asset has none), in the first state.
+void InitEnemyBrain(EntityArchetype *arch, int row);
+
+// Point the row at its asset's behavior and base HP again, after the asset
+// was reloaded or the asset array moved. restart puts the row back in its
+// behavior's first state, for when the state machine itself changed.
+void RebindEnemyAsset(EntityArchetype *arch, int row, bool restart);
+
+// Expensive part of enemy AI: decide whether the player is in sight (the
+// behavior's sight range and line of sight) and, for ground enemies, which navigation link to take.
+// Returns the estimated cost in microseconds.
+float ThinkEnemy(EntityArchetype *arch, int row, const Entity *player, NavGraph *nav);
+
+// Step the behavior state machines of the archetype's live rows: evaluate
+// the current state's transitions against distance, health, time in state
+// and sight, taking at most one per tick.
+void UpdateBehaviorStates(EntityArchetype *arch, const Entity *player, float dt);
+
+// Cheap per-tick steering that acts on the latest decision and the movement
+// of the row's current behavior state.
+void GroundEnemyAI(EntityArchetype *arch, int row, const Entity *player, const NavGraph *nav,
+                   const BehaviorState *state, float dt);
+void FlyingEnemyAI(EntityArchetype *arch, int row, const Entity *player, const FlowField *flow,
+                   const BehaviorState *state, float dt, float totalTime);
 
 #endif
\ No newline at end of file
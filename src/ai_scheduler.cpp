@@ -0,0 +1,90 @@
+#include <math.h>
+#include <stdlib.h>
+#include "ai_scheduler.h"
+#include "ai.h"
+#include "game_state.h"
+#include "timing.h"
+
+void ResetAIScheduler(AIScheduler *sched)
+{
+    sched->queueDepth = 0;
+    sched->thinks = 0;
+    sched->costUs = 0.0f;
+    sched->measuredUs = 0.0f;
+    sched->overrunTicks = 0;
+}
+
+void FreeAIScheduler(AIScheduler *sched)
+{
+    if (sched->queue)
+        arena_free(&gameArena, sched->queue);
+    sched->queue = NULL;
+    sched->queueCapacity = 0;
+}
+
+// Lower priority goes first; ties go to the lower index so the order never
+// depends on the sort implementation.
+static int CompareThinkJobs(const void *a, const void *b)
+{
+    const AIThinkJob *ja = (const AIThinkJob *)a;
+    const AIThinkJob *jb = (const AIThinkJob *)b;
+    if (ja->priority != jb->priority)
+        return (ja->priority < jb->priority) ? -1 : 1;
+    return ja->enemy - jb->enemy;
+}
+
+void RunAIScheduler(AIScheduler *sched, EntityArchetype *enemies, const Entity *player, NavGraph *nav, float dt)
+{
+    sched->queueDepth = 0;
+    sched->thinks = 0;
+    sched->costUs = 0.0f;
+    sched->measuredUs = 0.0f;
+
+    int enemyCount = enemies->liveCount;
+    if (enemyCount > sched->queueCapacity)
+    {
+        AIThinkJob *grown = (AIThinkJob *)arena_realloc(&gameArena, sched->queue, sizeof(AIThinkJob) * enemyCount);
+        if (!grown)
+        {
+            TraceLog(LOG_ERROR, "Failed to grow AI queue to %d enemies!", enemyCount);
+            return;
+        }
+        sched->queue = grown;
+        sched->queueCapacity = enemyCount;
+    }
+
+    // Gather the enemies whose decision is due.
+    int due = 0;
+    for (int n = 0; n < enemyCount; n++)
+    {
+        int i = enemies->live[n];
+        BrainComponent *brain = &enemies->brain[i];
+        brain->thinkTimer -= dt;
+        if (brain->thinkTimer > 0.0f)
+            continue;
+        float dx = player->position.x - enemies->position[i].x;
+        float dy = player->position.y - enemies->position[i].y;
+        AIThinkJob *job = &sched->queue[due++];
+        job->priority = sqrtf(dx * dx + dy * dy) + brain->thinkTimer * AI_WAIT_PRIORITY;
+        job->enemy = i;
+    }
+    if (due == 0)
+        return;
+    qsort(sched->queue, due, sizeof(AIThinkJob), CompareThinkJobs);
+
+    // Always make at least one decision so a single expensive enemy can't stall.
+    double start = NowSeconds();
+    int done = 0;
+    while (done < due && (done == 0 || sched->costUs < AI_BUDGET_US))
+    {
+        int row = sched->queue[done++].enemy;
+        sched->costUs += ThinkEnemy(enemies, row, player, nav);
+        enemies->brain[row].thinkTimer = AI_THINK_INTERVAL;
+    }
+    sched->measuredUs = (float)((NowSeconds() - start) * 1e6);
+
+    sched->thinks = done;
+    sched->queueDepth = due - done;
+    if (sched->measuredUs > AI_BUDGET_US)
+        sched->overrunTicks++;
+}
@@ -0,0 +1,45 @@
+#ifndef AI_SCHEDULER_H
+#define AI_SCHEDULER_H
+
+#include "entity.h"
+#include "entity_store.h"
+#include "nav_graph.h"
+
+// Estimated microseconds of enemy decisions (ThinkEnemy) allowed per tick.
+#define AI_BUDGET_US 200.0f
+// Seconds between decisions of one enemy when the budget isn't exhausted.
+#define AI_THINK_INTERVAL 0.25f
+// Pixels of distance to the player that one second of overdue waiting makes
+// up for, so far-away enemies still get their turn.
+#define AI_WAIT_PRIORITY 2000.0f
+
+typedef struct AIThinkJob
+{
+    float priority;
+    int enemy; // Row in the enemy archetype.
+} AIThinkJob;
+
+// Spreads enemy decisions over ticks: every tick the due enemies are ordered
+// by distance to the player and decide until the budget is spent; the rest
+// stay queued (keeping their last decision) for the next tick. The budget is
+// charged with estimated costs so the simulation stays deterministic; the
+// measured time is only reported.
+typedef struct AIScheduler
+{
+    AIThinkJob *queue;
+    int queueCapacity;
+
+    // Stats of the last tick, shown in the stats overlay.
+    int queueDepth;     // Due enemies left waiting.
+    int thinks;         // Decisions made.
+    float costUs;       // Estimated cost of those decisions.
+    float measuredUs;   // Wall time they took.
+    int overrunTicks;   // Ticks whose measured time exceeded the budget, since the level started.
+} AIScheduler;
+
+void ResetAIScheduler(AIScheduler *sched);
+void FreeAIScheduler(AIScheduler *sched);
+// Decide for the archetype's live rows (see GatherLiveRows).
+void RunAIScheduler(AIScheduler *sched, EntityArchetype *enemies, const Entity *player, NavGraph *nav, float dt);
+
+#endif
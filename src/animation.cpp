@@ -0,0 +1,44 @@
+#include "animation.h"
+#include "game_state.h"
+
+// One pass over the archetype's rows. Rows are mostly grouped by asset, so
+// the asset lookup is only redone when the handle changes.
+static void UpdateArchetypeAnimations(EntityArchetype *arch, Rectangle view, float delta)
+{
+    EntityAssetHandle lastHandle = {0, 0};
+    EntityAsset *asset = GetEntityAsset(lastHandle);
+    for (int i = 0; i < arch->count; i++)
+    {
+        if (arch->combat[i].health <= 0)
+            continue;
+
+        EntityAssetHandle handle = arch->asset[i];
+        if (handle.index != lastHandle.index || handle.generation != lastHandle.generation)
+        {
+            asset = GetEntityAsset(handle);
+            lastHandle = handle;
+        }
+
+        AnimationComponent *anim = &arch->anim[i];
+        int clip = GetEntityClip(asset, arch->physics[i].state);
+        Vector2 p = arch->position[i];
+        float reach = arch->physics[i].radius + ANIMATION_VIEW_MARGIN;
+        bool visible = p.x + reach >= view.x && p.x - reach <= view.x + view.width &&
+                       p.y + reach >= view.y && p.y - reach <= view.y + view.height;
+        if (!visible && anim->clip == clip)
+            anim->timer += delta;
+        else
+            AdvanceAnimation(anim, clip, delta);
+    }
+}
+
+void UpdateEntityAnimations(GameState *state, Rectangle view, float delta)
+{
+    Entity *player = &state->player;
+    if (player->health > 0)
+        AdvanceAnimation(&player->anim, GetEntityClip(GetEntityAsset(player->asset), player->state), delta);
+
+    UpdateArchetypeAnimations(&state->entities.archetypes[ARCHETYPE_ENEMY], view, delta);
+    if (state->bossActive)
+        UpdateArchetypeAnimations(&state->entities.archetypes[ARCHETYPE_BOSS], view, delta);
+}
@@ -2,42 +2,115 @@
 #define ANIMATION_H
 
 #include <raylib.h>
+#include <math.h>
+#include <stdint.h>
 #include "memory_arena.h"
 
-typedef struct AnimationFrames
+// Upper bound on distinct clips in the clip library; clip 0 is always the
+// empty clip, which is what assets without an animation reference.
+#define MAX_ANIMATION_CLIPS 4096
+
+// Frames and timing of one animation. Clips are shared through the clip
+// library: identical clips (same frames and frame time) are stored once, no
+// matter how many assets use them, and a clip never changes once added.
+typedef struct AnimationClip
 {
-    Rectangle *frames;
+    int firstFrame; // Index of the clip's first frame in the library's frame array.
     int frameCount;
     float frameTime;
-} AnimationFrames;
+} AnimationClip;
+
+// Every clip's frames sit back to back in one array, so playing many
+// entities touches one compact block instead of a Rectangle array per asset.
+typedef struct AnimationClipLibrary
+{
+    AnimationClip clips[MAX_ANIMATION_CLIPS];
+    uint64_t hashes[MAX_ANIMATION_CLIPS];
+    int clipCount;
+    Rectangle *frames; // In assetArena; moves when it grows.
+    int frameCount;
+    int frameCapacity;
+} AnimationClipLibrary;
+
+extern AnimationClipLibrary animationClips;
+
+// Index of the clip with these frames and frame time, adding it to the
+// library if there is none yet. Returns 0 (the empty clip) for no frames or
+// when the library is full.
+int InternAnimationClip(const Rectangle *frames, int frameCount, float frameTime);
+
+// Unknown indices resolve to the empty clip.
+static inline const AnimationClip *GetAnimationClip(int clip)
+{
+    return &animationClips.clips[(clip > 0 && clip < animationClips.clipCount) ? clip : 0];
+}
 
-typedef struct Animation
+// Valid until the next clip is interned.
+static inline const Rectangle *GetAnimationClipFrames(const AnimationClip *clip)
 {
-    AnimationFrames *framesData;
-    int currentFrame;
+    return animationClips.frames + clip->firstFrame;
+}
+
+// Playback position of an entity: the library clip playing, its current
+// frame, and the time spent in that frame.
+typedef struct AnimationComponent
+{
+    int clip;
+    int frame;
     float timer;
-    Texture2D texture;
-} Animation;
+} AnimationComponent;
 
-static void UpdateAnimation(Animation *anim, float delta)
+// Advance anim by delta through clip, starting over when the clip changes.
+// Time past a frame boundary carries into the next frame, and a delta that
+// spans several frames skips ahead by all of them.
+static inline void AdvanceAnimation(AnimationComponent *anim, int clip, float delta)
 {
-    if (anim->framesData == NULL || anim->framesData->frameCount == 0)
+    if (anim->clip != clip)
+    {
+        anim->clip = clip;
+        anim->frame = 0;
+        anim->timer = 0;
+    }
+    const AnimationClip *c = GetAnimationClip(clip);
+    if (c->frameCount <= 0)
         return;
-        
-    anim->timer += delta;
-    if (anim->timer >= anim->framesData->frameTime)
+
+    // Clips without a frame time step once per update.
+    if (c->frameTime <= 0.0f)
     {
         anim->timer = 0;
-        anim->currentFrame = (anim->currentFrame + 1) % anim->framesData->frameCount;
+        anim->frame = (anim->frame + 1) % c->frameCount;
+        return;
     }
-}
 
-static void InitEntityAnimation(Animation *anim, AnimationFrames *frames, Texture2D texture)
-{
-    anim->framesData = frames;
-    anim->texture = texture;
-    anim->currentFrame = 0;
-    anim->timer = 0;
+    anim->timer += delta;
+    if (anim->timer < c->frameTime)
+        return;
+
+    // Whole frames elapsed, kept as a float so long off-screen spans can't overflow.
+    float steps = floorf(anim->timer / c->frameTime);
+    if (steps == 1.0f)
+    {
+        // The usual case every tick, without the modulo of the general one.
+        anim->timer -= c->frameTime;
+        if (++anim->frame >= c->frameCount)
+            anim->frame = 0;
+        return;
+    }
+    anim->timer -= steps * c->frameTime;
+    if (anim->timer < 0.0f)
+        anim->timer = 0.0f;
+    anim->frame = (anim->frame + (int)fmodf(steps, (float)c->frameCount)) % c->frameCount;
 }
 
-#endif
\ No newline at end of file
+// Extra world-space distance around the view within which entities still
+// animate every tick, so nothing pops when it scrolls in.
+#define ANIMATION_VIEW_MARGIN 64.0f
+
+// Per-tick animation pass over the player and the entity store, separate
+// from drawing. Entities outside view only add delta to their timer; the
+// next AdvanceAnimation after they come into view catches them up in one
+// closed-form step.
+void UpdateEntityAnimations(struct GameState *state, Rectangle view, float delta);
+
+#endif
@@ -0,0 +1,77 @@
+#include <string.h>
+#include "animation.h"
+
+// Open-addressed content hash -> clip + 1 map, twice the clip limit so probes stay short.
+#define ANIMATION_CLIP_MAP_SIZE (MAX_ANIMATION_CLIPS * 2)
+
+AnimationClipLibrary animationClips = {{{0, 0, 0.0f}}, {0}, 1};
+static uint16_t animationClipMap[ANIMATION_CLIP_MAP_SIZE];
+
+// FNV-1a over the frame time and frame rectangles.
+static uint64_t HashAnimationClip(const Rectangle *frames, int frameCount, float frameTime)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const unsigned char *bytes = (const unsigned char *)&frameTime;
+    for (size_t i = 0; i < sizeof(frameTime); i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    bytes = (const unsigned char *)frames;
+    for (size_t i = 0; i < sizeof(Rectangle) * frameCount; i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    return hash ^ (uint64_t)frameCount;
+}
+
+static bool ClipMatches(int clip, const Rectangle *frames, int frameCount, float frameTime)
+{
+    const AnimationClip *c = &animationClips.clips[clip];
+    return c->frameCount == frameCount && c->frameTime == frameTime &&
+           memcmp(animationClips.frames + c->firstFrame, frames, sizeof(Rectangle) * frameCount) == 0;
+}
+
+// Make room for count more frames in the library's frame array.
+static bool ReserveClipFrames(int count)
+{
+    AnimationClipLibrary *lib = &animationClips;
+    if (lib->frameCount + count <= lib->frameCapacity)
+        return true;
+
+    int capacity = (lib->frameCapacity > 0) ? lib->frameCapacity : 256;
+    while (capacity < lib->frameCount + count)
+        capacity *= 2;
+    Rectangle *grown = (Rectangle *)arena_realloc(&assetArena, lib->frames, sizeof(Rectangle) * capacity);
+    if (!grown)
+        return false;
+    lib->frames = grown;
+    lib->frameCapacity = capacity;
+    return true;
+}
+
+int InternAnimationClip(const Rectangle *frames, int frameCount, float frameTime)
+{
+    if (frames == NULL || frameCount <= 0)
+        return 0;
+
+    AnimationClipLibrary *lib = &animationClips;
+    uint64_t hash = HashAnimationClip(frames, frameCount, frameTime);
+    uint32_t bucket = (uint32_t)(hash >> 40) & (ANIMATION_CLIP_MAP_SIZE - 1);
+    while (animationClipMap[bucket] != 0)
+    {
+        int clip = animationClipMap[bucket] - 1;
+        if (lib->hashes[clip] == hash && ClipMatches(clip, frames, frameCount, frameTime))
+            return clip;
+        bucket = (bucket + 1) & (ANIMATION_CLIP_MAP_SIZE - 1);
+    }
+
+    if (lib->clipCount >= MAX_ANIMATION_CLIPS || !ReserveClipFrames(frameCount))
+    {
+        TraceLog(LOG_ERROR, "Animation clip library is full; a %d-frame clip was dropped!", frameCount);
+        return 0;
+    }
+
+    int clip = lib->clipCount++;
+    lib->clips[clip] = (AnimationClip){lib->frameCount, frameCount, frameTime};
+    lib->hashes[clip] = hash;
+    memcpy(lib->frames + lib->frameCount, frames, sizeof(Rectangle) * frameCount);
+    lib->frameCount += frameCount;
+    animationClipMap[bucket] = (uint16_t)(clip + 1);
+    return clip;
+}
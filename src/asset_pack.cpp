@@ -0,0 +1,300 @@
+#include <ctype.h>
+#include <string.h>
+#include <raylib.h>
+#include "asset_pack.h"
+
+#define FNV64_OFFSET_BASIS 14695981039346656037ull
+#define FNV64_PRIME 1099511628211ull
+
+static MappedFile pack;
+static const AssetPackHeader *packHeader;
+static bool preferLoose;
+
+// The rules of NormalizeAssetPath: no leading "./", forward slashes only and
+// no doubled ones.
+static size_t NormalizePackPath(const char *path, char *out, size_t size)
+{
+    while (path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+        path += 2;
+    size_t n = 0;
+    for (; *path && n + 1 < size; path++)
+    {
+        char c = (*path == '\\') ? '/' : *path;
+        if (c == '/' && n > 0 && out[n - 1] == '/')
+            continue;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+static uint64_t HashBytes(const char *bytes, size_t length)
+{
+    uint64_t hash = FNV64_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)bytes[i];
+        hash *= FNV64_PRIME;
+    }
+    return hash;
+}
+
+uint64_t HashAssetPath(const char *path)
+{
+    char normalized[MAX_FILE_PATH];
+    size_t length = NormalizePackPath(path, normalized, sizeof(normalized));
+    return HashBytes(normalized, length);
+}
+
+static const AssetPackEntry *GetPackEntries()
+{
+    return (const AssetPackEntry *)(pack.data + packHeader->entriesOffset);
+}
+
+static const char *GetPackEntryName(const AssetPackEntry *entry)
+{
+    return (const char *)(pack.data + packHeader->namesOffset + entry->nameOffset);
+}
+
+static bool ValidateAssetPack(const MappedFile *file)
+{
+    const AssetPackHeader *header = (const AssetPackHeader *)file->data;
+    size_t size = file->size;
+    if (size < sizeof(AssetPackHeader) || memcmp(header->magic, ASSET_PACK_MAGIC, 4) != 0)
+    {
+        TraceLog(LOG_ERROR, "PACK: Truncated or not an asset pack");
+        return false;
+    }
+    if (header->version != ASSET_PACK_VERSION)
+    {
+        TraceLog(LOG_ERROR, "PACK: Unsupported version %u (expected %d)", header->version, ASSET_PACK_VERSION);
+        return false;
+    }
+    if (header->slotCount == 0 || (header->slotCount & (header->slotCount - 1)) != 0 ||
+        header->slotCount <= header->entryCount)
+    {
+        TraceLog(LOG_ERROR, "PACK: Bad slot count %u for %u entries", header->slotCount, header->entryCount);
+        return false;
+    }
+    if (header->slotsOffset > size || (uint64_t)header->slotCount * sizeof(uint32_t) > size - header->slotsOffset ||
+        header->entriesOffset > size ||
+        (uint64_t)header->entryCount * sizeof(AssetPackEntry) > size - header->entriesOffset ||
+        header->namesOffset > size || header->namesSize > size - header->namesOffset ||
+        header->slotsOffset % sizeof(uint32_t) != 0 || header->entriesOffset % sizeof(uint64_t) != 0)
+    {
+        TraceLog(LOG_ERROR, "PACK: Table of contents runs past the end of the file");
+        return false;
+    }
+
+    const uint32_t *slots = (const uint32_t *)(file->data + header->slotsOffset);
+    uint32_t usedSlots = 0;
+    for (uint32_t i = 0; i < header->slotCount; i++)
+    {
+        if (slots[i] > header->entryCount)
+        {
+            TraceLog(LOG_ERROR, "PACK: Slot %u points past the last entry", i);
+            return false;
+        }
+        usedSlots += (slots[i] != 0);
+    }
+    // One slot per entry leaves an empty slot to end every probe, since there
+    // are more slots than entries.
+    if (usedSlots != header->entryCount)
+    {
+        TraceLog(LOG_ERROR, "PACK: %u slots in use for %u entries", usedSlots, header->entryCount);
+        return false;
+    }
+    const AssetPackEntry *entries = (const AssetPackEntry *)(file->data + header->entriesOffset);
+    uint32_t mask = header->slotCount - 1;
+    for (uint32_t i = 0; i < header->entryCount; i++)
+    {
+        const AssetPackEntry *entry = &entries[i];
+        // Found by its own hash, so with the count above each entry sits in
+        // exactly one slot.
+        uint32_t slot = (uint32_t)entry->pathHash & mask;
+        while (slots[slot] != 0 && slots[slot] != i + 1)
+            slot = (slot + 1) & mask;
+        if (slots[slot] == 0)
+        {
+            TraceLog(LOG_ERROR, "PACK: Entry %u can't be found from its hash", i);
+            return false;
+        }
+        // Levels are read in place as structs, so data keeps its alignment.
+        if (entry->offset > size || entry->size > size - entry->offset || entry->offset % ASSET_PACK_ALIGN != 0 ||
+            (uint64_t)entry->nameOffset + entry->nameLength >= header->namesSize ||
+            file->data[header->namesOffset + entry->nameOffset + entry->nameLength] != '\0')
+        {
+            TraceLog(LOG_ERROR, "PACK: Entry %u is out of bounds", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OpenAssetPack(const char *path, bool preferLooseFiles)
+{
+    CloseAssetPack();
+    MappedFile file;
+    if (!MapFile(path, &file))
+    {
+        TraceLog(LOG_INFO, "PACK: No %s, reading assets from disk", path);
+        return false;
+    }
+    if (!ValidateAssetPack(&file))
+    {
+        TraceLog(LOG_ERROR, "PACK: Ignoring %s, reading assets from disk", path);
+        UnmapFile(&file);
+        return false;
+    }
+    pack = file;
+    packHeader = (const AssetPackHeader *)pack.data;
+    preferLoose = preferLooseFiles;
+    TraceLog(LOG_INFO, "PACK: %s holds %u files%s", path, packHeader->entryCount,
+             preferLoose ? " (loose files take precedence)" : "");
+    return true;
+}
+
+void CloseAssetPack(void)
+{
+    UnmapFile(&pack);
+    packHeader = NULL;
+    preferLoose = false;
+}
+
+bool IsAssetPackOpen(void)
+{
+    return packHeader != NULL;
+}
+
+static const AssetPackEntry *FindPackEntry(const char *normalized, size_t length)
+{
+    uint64_t hash = HashBytes(normalized, length);
+
+    const uint32_t *slots = (const uint32_t *)(pack.data + packHeader->slotsOffset);
+    const AssetPackEntry *entries = GetPackEntries();
+    uint32_t mask = packHeader->slotCount - 1;
+    // ValidateAssetPack made sure there is an empty slot, so the probe ends.
+    for (uint32_t slot = (uint32_t)hash & mask;; slot = (slot + 1) & mask)
+    {
+        if (slots[slot] == 0)
+            return NULL;
+        const AssetPackEntry *entry = &entries[slots[slot] - 1];
+        if (entry->pathHash == hash && entry->nameLength == length &&
+            memcmp(GetPackEntryName(entry), normalized, length) == 0)
+            return entry;
+    }
+}
+
+// path must already be normalized; loose files are looked up by it as well,
+// since forward slashes work on every platform.
+static bool FindNormalizedAsset(const char *path, size_t length, const unsigned char **data, size_t *size)
+{
+    if (!packHeader)
+        return false;
+    const AssetPackEntry *entry = FindPackEntry(path, length);
+    if (!entry || (preferLoose && IsRegularFile(path)))
+        return false;
+    *data = pack.data + entry->offset;
+    *size = (size_t)entry->size;
+    return true;
+}
+
+bool FindPackedAsset(const char *path, const unsigned char **data, size_t *size)
+{
+    char normalized[MAX_FILE_PATH];
+    size_t length = NormalizePackPath(path, normalized, sizeof(normalized));
+    return FindNormalizedAsset(normalized, length, data, size);
+}
+
+bool LoadAssetFile(const char *path, AssetFile *file)
+{
+    memset(file, 0, sizeof(*file));
+    char normalized[MAX_FILE_PATH];
+    size_t length = NormalizePackPath(path, normalized, sizeof(normalized));
+    if (FindNormalizedAsset(normalized, length, &file->data, &file->size))
+        return true;
+    if (!MapFile(normalized, &file->loose))
+        return false;
+    file->data = file->loose.data;
+    file->size = file->loose.size;
+    return true;
+}
+
+void UnloadAssetFile(AssetFile *file)
+{
+    UnmapFile(&file->loose);
+    memset(file, 0, sizeof(*file));
+}
+
+static bool HasExtension(const char *name, size_t length, const char *extension)
+{
+    size_t extLen = strlen(extension);
+    if (extLen > length)
+        return false;
+    for (size_t i = 0; i < extLen; i++)
+    {
+        if (tolower((unsigned char)name[length - extLen + i]) != tolower((unsigned char)extension[i]))
+            return false;
+    }
+    return true;
+}
+
+static bool ContainsFileName(const FileList *list, int count, const char *name)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(GetFileListName(list, i), name) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool ListAssetFiles(MemoryArena *arena, const char *directory, const char *extension, FileList *list)
+{
+    if (!packHeader)
+        return ScanDirectory(arena, directory, extension, list);
+
+    bool ok = true;
+    int looseCount = 0;
+    if (preferLoose)
+    {
+        // A missing directory is fine: everything may be packed.
+        ScanDirectory(arena, directory, extension, list);
+        looseCount = list->count;
+    }
+    else
+    {
+        memset(list, 0, sizeof(*list));
+    }
+
+    char prefix[MAX_FILE_PATH];
+    size_t prefixLength = NormalizePackPath(directory, prefix, sizeof(prefix) - 1);
+    if (prefixLength > 0 && prefix[prefixLength - 1] != '/')
+    {
+        prefix[prefixLength++] = '/';
+        prefix[prefixLength] = '\0';
+    }
+
+    const AssetPackEntry *entries = GetPackEntries();
+    for (uint32_t i = 0; i < packHeader->entryCount && ok; i++)
+    {
+        const AssetPackEntry *entry = &entries[i];
+        const char *name = GetPackEntryName(entry);
+        if (entry->nameLength <= prefixLength || memcmp(name, prefix, prefixLength) != 0)
+            continue;
+        const char *base = name + prefixLength;
+        size_t baseLength = entry->nameLength - prefixLength;
+        if (memchr(base, '/', baseLength) || !HasExtension(base, baseLength, extension))
+            continue;
+        if (ContainsFileName(list, looseCount, base))
+            continue;
+        ok = AppendFileListName(arena, list, base, baseLength);
+    }
+    if (!ok)
+    {
+        FreeFileList(arena, list);
+        return false;
+    }
+    SortFileList(list);
+    return true;
+}
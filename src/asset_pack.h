@@ -0,0 +1,81 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "file_io.h"
+#include "memory_arena.h"
+
+#define ASSET_PACK_MAGIC "GGPK"
+#define ASSET_PACK_VERSION 1
+// The pack the game looks for next to res/, written by pack_assets.
+#define ASSET_PACK_PATH "res.pak"
+
+// File data starts on this boundary, like the sections of a binary level.
+#define ASSET_PACK_ALIGN 16
+
+// File layout: AssetPackHeader, the hash slots, the AssetPackEntries, the
+// names, then each file's data. Everything is little-endian. Names are paths
+// as the game asks for them, normalized (no leading "./", forward slashes),
+// e.g. "res/sprites/player.png", and entries are sorted by name.
+//
+// The slots are an open-addressed table of slotCount (a power of two) uint32s:
+// a path's hash picks the first slot to look at, and the following ones are
+// tried in turn until an empty one. A slot holds an entry index plus one, or
+// 0 when empty.
+typedef struct AssetPackHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t slotCount;
+    uint64_t slotsOffset;
+    uint64_t entriesOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+} AssetPackHeader;
+
+typedef struct AssetPackEntry
+{
+    uint64_t pathHash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t nameOffset; // From namesOffset; names are NUL-terminated.
+    uint32_t nameLength;
+} AssetPackEntry;
+
+// FNV-1a of the normalized path, so "./res/a.png" and "res\\a.png" match.
+uint64_t HashAssetPath(const char *path);
+
+// Map a pack for the rest of the run; the files in it are then served from
+// memory instead of being opened one by one. With preferLooseFiles, a file
+// that also exists loose on disk is read from disk instead, so edits show up
+// without rebuilding the pack. Returns false, leaving everything to be read
+// from disk, when the pack is missing or damaged.
+bool OpenAssetPack(const char *path, bool preferLooseFiles);
+void CloseAssetPack(void);
+bool IsAssetPackOpen(void);
+
+// The packed bytes of path. False when there is no pack, path isn't in it or
+// a loose copy takes precedence; read the file from disk then. The bytes
+// stay valid until CloseAssetPack.
+bool FindPackedAsset(const char *path, const unsigned char **data, size_t *size);
+
+// A whole file, from the pack or mapped from disk (see MapFile).
+typedef struct AssetFile
+{
+    const unsigned char *data;
+    size_t size;
+    MappedFile loose; // The mapping when the file came from disk.
+} AssetFile;
+
+bool LoadAssetFile(const char *path, AssetFile *file);
+void UnloadAssetFile(AssetFile *file);
+
+// ScanDirectory over the pack and the disk together: the packed files
+// directly in directory, plus (with no pack, or with preferLooseFiles) the
+// loose ones, each name once and sorted.
+bool ListAssetFiles(MemoryArena *arena, const char *directory, const char *extension, FileList *list);
+
+#endif
@@ -0,0 +1,384 @@
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <mutex>
+#include <raylib.h>
+#include "asset_reload.h"
+#include "file_watch.h"
+#include "game_storage.h"
+#include "tile.h"
+#include "ai.h"
+
+// Quiet time after the last change before the changed files are read; saves
+// arrive as several events and the file may still be being written.
+#define RELOAD_SETTLE_MS 50
+#define MAX_PENDING_RELOADS 64
+// The game's own saves are ignored for this long after they were written.
+#define OWN_WRITE_SECONDS 2.0
+#define MAX_OWN_WRITES 16
+
+typedef enum AssetReloadKind
+{
+    ASSET_RELOAD_ENTITY = 0,
+    ASSET_RELOAD_TILESET,
+    ASSET_RELOAD_LEVEL,
+    ASSET_RELOAD_SPRITE,
+} AssetReloadKind;
+
+// A changed file, read (or decoded) by the watcher thread.
+typedef struct AssetReload
+{
+    AssetReloadKind kind;
+    char path[MAX_FILE_PATH];
+    char *text;  // .ent and .tiles contents, from LoadFileText.
+    Image image; // Decoded sprite.
+} AssetReload;
+
+typedef struct OwnWrite
+{
+    char path[MAX_FILE_PATH];
+    double time;
+} OwnWrite;
+
+static const char *const watchedDirectories[] = {"./res/entities", "./res/tiles", "./res/levels", "./res/sprites"};
+
+static DirectoryWatch *reloadWatch = NULL;
+static std::thread reloadThread;
+
+// Filled by the watcher thread, drained by ApplyAssetReloads.
+static std::mutex reloadMutex;
+static AssetReload readyReloads[MAX_PENDING_RELOADS];
+static int readyCount = 0;
+
+// Main thread only.
+static OwnWrite ownWrites[MAX_OWN_WRITES];
+static int ownWriteNext = 0;
+
+void NormalizeAssetPath(const char *path, char *out, size_t size)
+{
+    while (path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+        path += 2;
+    size_t n = 0;
+    for (; *path && n + 1 < size; path++)
+    {
+        char c = (*path == '\\') ? '/' : *path;
+        if (c == '/' && n > 0 && out[n - 1] == '/')
+            continue;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+}
+
+void NoteAssetWritten(const char *path)
+{
+    OwnWrite *write = &ownWrites[ownWriteNext];
+    ownWriteNext = (ownWriteNext + 1) % MAX_OWN_WRITES;
+    NormalizeAssetPath(path, write->path, sizeof(write->path));
+    write->time = GetTime();
+}
+
+static bool IsOwnWrite(const char *path)
+{
+    char normalized[MAX_FILE_PATH];
+    NormalizeAssetPath(path, normalized, sizeof(normalized));
+    double now = GetTime();
+    for (int i = 0; i < MAX_OWN_WRITES; i++)
+    {
+        if (ownWrites[i].path[0] != '\0' && now - ownWrites[i].time < OWN_WRITE_SECONDS &&
+            strcmp(ownWrites[i].path, normalized) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool HasExtension(const char *path, const char *extension)
+{
+    size_t len = strlen(path), extLen = strlen(extension);
+    return len > extLen && strcmp(path + len - extLen, extension) == 0;
+}
+
+// Read or decode one changed file. Returns false for files that aren't
+// assets (editor backups, temporaries) or that can't be read.
+static bool ReadChangedAsset(const char *path, AssetReload *reload)
+{
+    memset(reload, 0, sizeof(*reload));
+    size_t length = strlen(path);
+    if (length >= sizeof(reload->path))
+    {
+        TraceLog(LOG_WARNING, "ASSET_RELOAD: Ignoring %s; the path is too long.", path);
+        return false;
+    }
+    memcpy(reload->path, path, length + 1);
+    if (HasExtension(path, ".ent") || HasExtension(path, ".tiles"))
+    {
+        reload->kind = HasExtension(path, ".ent") ? ASSET_RELOAD_ENTITY : ASSET_RELOAD_TILESET;
+        reload->text = LoadFileText(path);
+        return reload->text != NULL;
+    }
+    if (HasExtension(path, ".level"))
+    {
+        // LoadLevel writes straight into the game state, so levels are parsed when applied.
+        reload->kind = ASSET_RELOAD_LEVEL;
+        return true;
+    }
+    if (HasExtension(path, ".png"))
+    {
+        reload->kind = ASSET_RELOAD_SPRITE;
+        reload->image = LoadImage(path);
+        return reload->image.data != NULL;
+    }
+    return false;
+}
+
+static void FreeAssetReload(AssetReload *reload)
+{
+    if (reload->text)
+        UnloadFileText(reload->text);
+    if (reload->image.data)
+        UnloadImage(reload->image);
+}
+
+static int AddPendingPath(char pending[][MAX_FILE_PATH], int count, const char *path)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(pending[i], path) == 0)
+            return count;
+    }
+    size_t length = strlen(path);
+    if (length >= MAX_FILE_PATH)
+    {
+        TraceLog(LOG_WARNING, "ASSET_RELOAD: Ignoring %s; the path is too long.", path);
+        return count;
+    }
+    if (count < MAX_PENDING_RELOADS)
+        memcpy(pending[count++], path, length + 1);
+    return count;
+}
+
+static void AssetReloadWorker(void)
+{
+    static char changed[MAX_PENDING_RELOADS][MAX_FILE_PATH];
+    static char pending[MAX_PENDING_RELOADS][MAX_FILE_PATH];
+    for (;;)
+    {
+        int n = WaitDirectoryChanges(reloadWatch, changed, MAX_PENDING_RELOADS, -1);
+        int pendingCount = 0;
+        while (n > 0)
+        {
+            for (int i = 0; i < n; i++)
+                pendingCount = AddPendingPath(pending, pendingCount, changed[i]);
+            n = WaitDirectoryChanges(reloadWatch, changed, MAX_PENDING_RELOADS, RELOAD_SETTLE_MS);
+        }
+        if (n < 0)
+            return;
+
+        for (int i = 0; i < pendingCount; i++)
+        {
+            AssetReload reload;
+            if (!ReadChangedAsset(pending[i], &reload))
+                continue;
+
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            if (readyCount < MAX_PENDING_RELOADS)
+                readyReloads[readyCount++] = reload;
+            else
+                FreeAssetReload(&reload);
+        }
+    }
+}
+
+bool StartAssetReload(void)
+{
+    if (reloadWatch != NULL)
+        return true;
+    reloadWatch = OpenDirectoryWatch(watchedDirectories, sizeof(watchedDirectories) / sizeof(watchedDirectories[0]));
+    if (reloadWatch == NULL)
+    {
+        TraceLog(LOG_WARNING, "ASSET_RELOAD: Can't watch the asset directories; hot reload is off.");
+        return false;
+    }
+    reloadThread = std::thread(AssetReloadWorker);
+    TraceLog(LOG_INFO, "ASSET_RELOAD: Watching the asset directories for changes.");
+    return true;
+}
+
+void StopAssetReload(void)
+{
+    if (reloadWatch == NULL)
+        return;
+    WakeDirectoryWatch(reloadWatch);
+    reloadThread.join();
+    CloseDirectoryWatch(reloadWatch);
+    reloadWatch = NULL;
+
+    for (int i = 0; i < readyCount; i++)
+        FreeAssetReload(&readyReloads[i]);
+    readyCount = 0;
+}
+
+// Bring the store rows using entity asset slot up to date with it. When the
+// asset array moved, every row's behavior pointer has to follow it.
+// Animations need nothing: clips never change, so a reloaded animation is a
+// different clip and playback restarts on it by itself.
+static void FixupEntityAssetUsers(int slot, bool arrayMoved)
+{
+    for (int a = 0; a < ARCHETYPE_COUNT; a++)
+    {
+        EntityArchetype *arch = &gameState->entities.archetypes[a];
+        for (int row = 0; row < arch->count; row++)
+        {
+            bool reloaded = IsEntityAssetHandleValid(arch->asset[row]) && arch->asset[row].index == slot;
+            if (reloaded || arrayMoved)
+                RebindEnemyAsset(arch, row, reloaded);
+        }
+    }
+}
+
+static bool ApplyEntityReload(const AssetReload *reload)
+{
+    EntityAsset loaded = {0};
+    if (!EntityAssetFromJSON(reload->text, &loaded))
+        return false;
+
+    // Assets are matched by id, so a reloaded asset keeps its slot and every
+    // handle to it stays valid.
+    EntityAssetHandle handle = FindEntityAssetHandle(loaded.id);
+    if (IsEntityAssetHandleValid(handle))
+    {
+        entityAssets[handle.index] = loaded;
+        FixupEntityAssetUsers(handle.index, false);
+        return true;
+    }
+
+    EntityAsset *grown = (EntityAsset *)arena_realloc(&assetArena, entityAssets, sizeof(EntityAsset) * (entityAssetCount + 1));
+    if (!grown)
+    {
+        TraceLog(LOG_ERROR, "ASSET_RELOAD: No room for new entity asset %s!", loaded.name);
+        return false;
+    }
+    bool moved = grown != entityAssets;
+    entityAssets = grown;
+    entityAssets[entityAssetCount++] = loaded;
+    UpdateEntityAssetIndex(entityAssetCount - 1);
+    FixupEntityAssetUsers(entityAssetCount - 1, moved);
+    return true;
+}
+
+static bool ApplyTilesetReload(const AssetReload *reload)
+{
+    Tileset loaded = {0};
+    if (!TilesetFromJson(reload->text, &loaded))
+        return false;
+
+    for (int i = 0; i < tilesetCount; i++)
+    {
+        if (tilesets[i].uniqueId == loaded.uniqueId)
+        {
+            tilesets[i] = loaded;
+            return true;
+        }
+    }
+
+    Tileset *grown = (Tileset *)arena_realloc(&assetArena, tilesets, sizeof(Tileset) * (tilesetCount + 1));
+    if (!grown)
+        return false;
+    tilesets = grown;
+    tilesets[tilesetCount++] = loaded;
+    return true;
+}
+
+static bool ApplyLevelReload(const AssetReload *reload)
+{
+    // New or renamed levels show up in the level lists.
+    LoadLevelFiles();
+
+    const char *name = strrchr(reload->path, '/');
+    name = name ? name + 1 : reload->path;
+    if (strcmp(name, gameState->currentLevelFilename) != 0)
+        return true;
+
+    // A run in progress keeps going; the edit shows the next time the level loads.
+    if (gameState->currentState != EDITOR)
+    {
+        TraceLog(LOG_INFO, "ASSET_RELOAD: %s changed; it applies when the level is next loaded.", name);
+        return true;
+    }
+    return LoadLevel(gameState->currentLevelFilename, &mapTiles, &gameState->player, &gameState->enemies,
+                     &gameState->enemyCount, &gameState->bossEnemy, &gameState->checkpoints, &gameState->checkpointCount);
+}
+
+static bool ApplySpriteReload(AssetReload *reload)
+{
+    Texture2D previous, current;
+    if (!ReplaceCachedTexture(reload->path, &reload->image, &previous, &current))
+        return true; // Nothing uses it yet; it loads fresh when something does.
+    if (previous.id == current.id)
+        return true;
+
+    // The image changed size and became a new texture: move its users over.
+    for (int i = 0; i < entityAssetCount; i++)
+    {
+        if (entityAssets[i].texture.id == previous.id)
+            entityAssets[i].texture = current;
+    }
+    for (int i = 0; i < tilesetCount; i++)
+    {
+        Tileset *ts = &tilesets[i];
+        if (ts->texture.id != previous.id)
+            continue;
+        ts->texture = current;
+        ts->tilesPerRow = current.width / ts->tileWidth;
+        ts->tilesPerColumn = current.height / ts->tileHeight;
+    }
+    return true;
+}
+
+int ApplyAssetReloads(void)
+{
+    static AssetReload reloads[MAX_PENDING_RELOADS];
+    int count;
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        count = readyCount;
+        memcpy(reloads, readyReloads, sizeof(AssetReload) * count);
+        readyCount = 0;
+    }
+
+    int applied = 0;
+    for (int i = 0; i < count; i++)
+    {
+        AssetReload *reload = &reloads[i];
+        if (!IsOwnWrite(reload->path))
+        {
+            double start = GetTime();
+            bool ok = false;
+            switch (reload->kind)
+            {
+            case ASSET_RELOAD_ENTITY:
+                ok = ApplyEntityReload(reload);
+                break;
+            case ASSET_RELOAD_TILESET:
+                ok = ApplyTilesetReload(reload);
+                break;
+            case ASSET_RELOAD_LEVEL:
+                ok = ApplyLevelReload(reload);
+                break;
+            case ASSET_RELOAD_SPRITE:
+                ok = ApplySpriteReload(reload);
+                break;
+            }
+            if (ok)
+            {
+                applied++;
+                TraceLog(LOG_INFO, "ASSET_RELOAD: Reloaded %s in %.2f ms", reload->path, (GetTime() - start) * 1000.0);
+            }
+            else
+            {
+                TraceLog(LOG_WARNING, "ASSET_RELOAD: Failed to reload %s; keeping the loaded version.", reload->path);
+            }
+        }
+        FreeAssetReload(reload);
+    }
+    return applied;
+}
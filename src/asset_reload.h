@@ -0,0 +1,26 @@
+#ifndef ASSET_RELOAD_H
+#define ASSET_RELOAD_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Hot reload of the files under res/entities, res/tiles, res/levels and
+// res/sprites. A background thread waits for changes (see file_watch.h),
+// reads and decodes only the files that changed and queues them; the main
+// thread patches the live assets in place between frames, so handles,
+// behaviors and textures already in use pick up the new data.
+bool StartAssetReload(void);
+void StopAssetReload(void);
+
+// Apply the reloads that are ready. Call once per frame from the main thread.
+// Returns the number of files applied.
+int ApplyAssetReloads(void);
+
+// Record that the game itself just saved path, so its own save isn't
+// reloaded over the state that was saved.
+void NoteAssetWritten(const char *path);
+
+// Path comparable between callers: no leading "./", forward slashes only.
+void NormalizeAssetPath(const char *path, char *out, size_t size);
+
+#endif
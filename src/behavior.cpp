@@ -0,0 +1,413 @@
+#include "behavior.h"
+#include "entity.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *behaviorMoveNames[BEHAVIOR_MOVE_COUNT] = {"hold", "patrol", "seek", "chase"};
+static const char *behaviorAttackNames[BEHAVIOR_ATTACK_COUNT] = {"none", "shoot", "pattern", "melee"};
+// Indexed by PhysicsType.
+static const char *behaviorPhysicsNames[] = {"keep", "ground", "flying"};
+
+typedef struct BehaviorCondition
+{
+    const char *name;
+    BehaviorInput input;
+    bool above;
+    bool hasValue;
+    float threshold; // Used when the condition takes no value.
+} BehaviorCondition;
+
+static const BehaviorCondition behaviorConditions[] = {
+    {"distance_below", BEHAVIOR_INPUT_DISTANCE, false, true, 0.0f},
+    {"distance_above", BEHAVIOR_INPUT_DISTANCE, true, true, 0.0f},
+    {"health_below", BEHAVIOR_INPUT_HEALTH, false, true, 0.0f},
+    {"health_above", BEHAVIOR_INPUT_HEALTH, true, true, 0.0f},
+    {"after", BEHAVIOR_INPUT_TIME, true, true, 0.0f},
+    {"sees_player", BEHAVIOR_INPUT_SIGHT, true, false, 0.5f},
+    {"lost_player", BEHAVIOR_INPUT_SIGHT, false, false, 0.5f},
+    {"always", BEHAVIOR_INPUT_TIME, true, false, -1.0f},
+};
+#define BEHAVIOR_CONDITION_COUNT (int)(sizeof(behaviorConditions) / sizeof(behaviorConditions[0]))
+
+// Return the bracket closing the one at open, skipping quoted strings, or NULL.
+static const char *MatchBracket(const char *open)
+{
+    char openChar = *open;
+    char closeChar = (openChar == '{') ? '}' : ']';
+    int depth = 0;
+    bool quoted = false;
+    for (const char *c = open; *c; c++)
+    {
+        if (*c == '"')
+            quoted = !quoted;
+        else if (quoted)
+            continue;
+        else if (*c == openChar)
+            depth++;
+        else if (*c == closeChar && --depth == 0)
+            return c;
+    }
+    return NULL;
+}
+
+// Find "key": in text, skipping string values that happen to equal the key.
+// Returns the position just past the colon, or NULL.
+static const char *FindKey(const char *text, const char *key)
+{
+    char quotedKey[40];
+    int keyLength = snprintf(quotedKey, sizeof(quotedKey), "\"%s\"", key);
+    for (const char *pos = strstr(text, quotedKey); pos; pos = strstr(pos + 1, quotedKey))
+    {
+        const char *after = pos + keyLength;
+        while (*after == ' ' || *after == '\t' || *after == '\r' || *after == '\n')
+            after++;
+        if (*after == ':')
+            return after + 1;
+    }
+    return NULL;
+}
+
+// Find the bracketed value of key inside [start, end). Sets *valueEnd to its closing bracket.
+static const char *FindMember(const char *start, const char *end, const char *key, char open, const char **valueEnd)
+{
+    const char *pos = FindKey(start, key);
+    if (!pos || pos >= end)
+        return NULL;
+    const char *value = strchr(pos, open);
+    if (!value || value >= end)
+        return NULL;
+    *valueEnd = MatchBracket(value);
+    if (!*valueEnd || *valueEnd > end)
+        return NULL;
+    return value;
+}
+
+static bool ReadString(const char *obj, const char *key, char *out, int size)
+{
+    out[0] = '\0';
+    const char *pos = FindKey(obj, key);
+    if (!pos)
+        return false;
+    char format[16];
+    snprintf(format, sizeof(format), " \"%%%d[^\"]\"", size - 1);
+    return sscanf(pos, format, out) == 1;
+}
+
+static bool ReadFloat(const char *obj, const char *key, float *out)
+{
+    const char *pos = FindKey(obj, key);
+    return pos && sscanf(pos, " %f", out) == 1;
+}
+
+static int FindName(const char *name, const char *const *names, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int FindState(const EntityBehavior *behavior, const char *name)
+{
+    for (int i = 0; i < behavior->stateCount; i++)
+    {
+        if (strcmp(behavior->states[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// Copy the object [open, close] into out so its members can be searched with strstr.
+static bool CopyObject(const char *open, const char *close, char *out, size_t size)
+{
+    size_t len = (size_t)(close - open + 1);
+    if (len >= size)
+        return false;
+    memcpy(out, open, len);
+    out[len] = '\0';
+    return true;
+}
+
+static bool ParseState(const char *obj, const char *assetName, BehaviorState *state)
+{
+    char text[64];
+    if (!ReadString(obj, "name", state->name, sizeof(state->name)))
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: state without a name", assetName);
+        return false;
+    }
+
+    state->move = BEHAVIOR_MOVE_HOLD;
+    if (ReadString(obj, "move", text, sizeof(text)))
+    {
+        int move = FindName(text, behaviorMoveNames, BEHAVIOR_MOVE_COUNT);
+        if (move < 0)
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: state '%s': unknown move '%s'", assetName, state->name, text);
+            return false;
+        }
+        state->move = (uint8_t)move;
+    }
+
+    state->attack = BEHAVIOR_ATTACK_NONE;
+    if (ReadString(obj, "attack", text, sizeof(text)))
+    {
+        int attack = FindName(text, behaviorAttackNames, BEHAVIOR_ATTACK_COUNT);
+        if (attack < 0)
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: state '%s': unknown attack '%s'", assetName, state->name, text);
+            return false;
+        }
+        state->attack = (uint8_t)attack;
+    }
+
+    state->physicsType = PHYS_NONE;
+    if (ReadString(obj, "physics", text, sizeof(text)))
+    {
+        int physics = FindName(text, behaviorPhysicsNames, sizeof(behaviorPhysicsNames) / sizeof(behaviorPhysicsNames[0]));
+        if (physics < 0)
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: state '%s': unknown physics '%s'", assetName, state->name, text);
+            return false;
+        }
+        state->physicsType = (uint8_t)physics;
+    }
+
+    ReadString(obj, "pattern", state->patternName, sizeof(state->patternName));
+    if (state->attack == BEHAVIOR_ATTACK_PATTERN && state->patternName[0] == '\0')
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: state '%s': pattern attack without a pattern", assetName, state->name);
+        return false;
+    }
+
+    state->stopDistance = BEHAVIOR_DEFAULT_STOP;
+    state->seekDistance = BEHAVIOR_DEFAULT_SEEK;
+    state->attackRange = (state->attack == BEHAVIOR_ATTACK_SHOOT)   ? BEHAVIOR_DEFAULT_SHOOT_RANGE
+                         : (state->attack == BEHAVIOR_ATTACK_MELEE) ? BEHAVIOR_DEFAULT_MELEE_REACH
+                                                                    : 0.0f;
+    state->cooldownScale = 1.0f;
+    ReadFloat(obj, "stop", &state->stopDistance);
+    ReadFloat(obj, "seek", &state->seekDistance);
+    ReadFloat(obj, "range", &state->attackRange);
+    ReadFloat(obj, "cooldown", &state->cooldownScale);
+    return true;
+}
+
+static bool ParseTransition(const char *obj, const char *assetName, const EntityBehavior *behavior,
+                            BehaviorTransition *transition)
+{
+    char from[32], to[32], when[32];
+    if (!ReadString(obj, "from", from, sizeof(from)) || !ReadString(obj, "to", to, sizeof(to)) ||
+        !ReadString(obj, "when", when, sizeof(when)))
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: transition needs 'from', 'to' and 'when'", assetName);
+        return false;
+    }
+
+    int fromState = FindState(behavior, from);
+    int toState = FindState(behavior, to);
+    if (fromState < 0 || toState < 0)
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: transition %s -> %s: unknown state", assetName, from, to);
+        return false;
+    }
+
+    int condition = -1;
+    for (int i = 0; i < BEHAVIOR_CONDITION_COUNT; i++)
+    {
+        if (strcmp(when, behaviorConditions[i].name) == 0)
+            condition = i;
+    }
+    if (condition < 0)
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: transition %s -> %s: unknown condition '%s'", assetName, from, to, when);
+        return false;
+    }
+
+    const BehaviorCondition *cond = &behaviorConditions[condition];
+    transition->value = 0.0f;
+    if (cond->hasValue && !ReadFloat(obj, "value", &transition->value))
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: transition %s -> %s: '%s' needs a value", assetName, from, to, when);
+        return false;
+    }
+    transition->threshold = cond->hasValue ? transition->value : cond->threshold;
+    transition->input = (uint8_t)cond->input;
+    transition->above = cond->above;
+    transition->from = (uint8_t)fromState;
+    transition->to = (uint8_t)toState;
+    transition->condition = (uint8_t)condition;
+    return true;
+}
+
+static bool ParseBehavior(const char *json, const char *assetName, EntityBehavior *behavior)
+{
+    const char *section = strstr(json, "\"behavior\"");
+    if (!section)
+        return false;
+    const char *open = strchr(section, '{');
+    const char *close = open ? MatchBracket(open) : NULL;
+    if (!close)
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: unterminated behavior", assetName);
+        return false;
+    }
+
+    behavior->sightRange = BEHAVIOR_DEFAULT_SIGHT;
+    const char *sight = FindKey(open, "sight");
+    if (sight && sight < close)
+        sscanf(sight, " %f", &behavior->sightRange);
+
+    char obj[512];
+    const char *listEnd = NULL;
+    const char *list = FindMember(open, close, "states", '[', &listEnd);
+    if (!list)
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: no states", assetName);
+        return false;
+    }
+    for (const char *item = strchr(list, '{'); item && item < listEnd; item = strchr(item, '{'))
+    {
+        const char *itemEnd = MatchBracket(item);
+        if (!itemEnd || !CopyObject(item, itemEnd, obj, sizeof(obj)))
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: malformed state", assetName);
+            return false;
+        }
+        if (behavior->stateCount >= BEHAVIOR_MAX_STATES)
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: more than %d states", assetName, BEHAVIOR_MAX_STATES);
+            return false;
+        }
+        BehaviorState *state = &behavior->states[behavior->stateCount];
+        if (!ParseState(obj, assetName, state))
+            return false;
+        if (FindState(behavior, state->name) >= 0)
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: duplicate state '%s'", assetName, state->name);
+            return false;
+        }
+        behavior->stateCount++;
+        item = itemEnd + 1;
+    }
+    if (behavior->stateCount == 0)
+    {
+        TraceLog(LOG_WARNING, "BEHAVIOR: %s: no states", assetName);
+        return false;
+    }
+
+    // Transitions may come in any order; gather them, then group by source state.
+    BehaviorTransition parsed[BEHAVIOR_MAX_TRANSITIONS];
+    int parsedCount = 0;
+    list = FindMember(open, close, "transitions", '[', &listEnd);
+    for (const char *item = list ? strchr(list, '{') : NULL; item && item < listEnd; item = strchr(item, '{'))
+    {
+        const char *itemEnd = MatchBracket(item);
+        if (!itemEnd || !CopyObject(item, itemEnd, obj, sizeof(obj)))
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: malformed transition", assetName);
+            return false;
+        }
+        if (parsedCount >= BEHAVIOR_MAX_TRANSITIONS)
+        {
+            TraceLog(LOG_WARNING, "BEHAVIOR: %s: more than %d transitions", assetName, BEHAVIOR_MAX_TRANSITIONS);
+            return false;
+        }
+        if (!ParseTransition(obj, assetName, behavior, &parsed[parsedCount]))
+            return false;
+        parsedCount++;
+        item = itemEnd + 1;
+    }
+
+    for (int s = 0; s < behavior->stateCount; s++)
+    {
+        behavior->transitionFirst[s] = (uint8_t)behavior->transitionCount;
+        for (int t = 0; t < parsedCount; t++)
+        {
+            if (parsed[t].from == s)
+                behavior->transitions[behavior->transitionCount++] = parsed[t];
+        }
+    }
+    behavior->transitionFirst[behavior->stateCount] = (uint8_t)behavior->transitionCount;
+    return true;
+}
+
+bool CompileEntityBehavior(const char *json, const char *assetName, EntityBehavior *behavior)
+{
+    memset(behavior, 0, sizeof(*behavior));
+    if (ParseBehavior(json, assetName, behavior))
+        return true;
+    memset(behavior, 0, sizeof(*behavior));
+    return false;
+}
+
+void GetDefaultEntityBehavior(int kind, const char *assetName, EntityBehavior *behavior)
+{
+    char source[1024];
+    if (kind == ENTITY_BOSS)
+    {
+        snprintf(source, sizeof(source),
+                 "\"behavior\": {\"states\": ["
+                 "{\"name\": \"phase1\", \"move\": \"chase\", \"attack\": \"melee\", \"physics\": \"ground\", \"cooldown\": 2},"
+                 "{\"name\": \"phase2\", \"move\": \"chase\", \"attack\": \"pattern\", \"physics\": \"flying\", \"pattern\": \"%s_phase2\"},"
+                 "{\"name\": \"phase3\", \"move\": \"chase\", \"attack\": \"pattern\", \"physics\": \"flying\", \"pattern\": \"%s_phase3\"}"
+                 "], \"transitions\": ["
+                 "{\"from\": \"phase1\", \"to\": \"phase3\", \"when\": \"health_below\", \"value\": 0.2},"
+                 "{\"from\": \"phase1\", \"to\": \"phase2\", \"when\": \"health_below\", \"value\": 0.5},"
+                 "{\"from\": \"phase2\", \"to\": \"phase3\", \"when\": \"health_below\", \"value\": 0.2}"
+                 "]}",
+                 assetName, assetName);
+    }
+    else if (kind == ENTITY_ENEMY)
+    {
+        snprintf(source, sizeof(source),
+                 "\"behavior\": {\"states\": ["
+                 "{\"name\": \"hunt\", \"move\": \"chase\", \"attack\": \"shoot\"}"
+                 "]}");
+    }
+    else
+    {
+        memset(behavior, 0, sizeof(*behavior));
+        return;
+    }
+    CompileEntityBehavior(source, assetName, behavior);
+}
+
+void AppendEntityBehaviorJSON(char *json, size_t size, const EntityBehavior *behavior)
+{
+    char temp[512];
+    snprintf(temp, sizeof(temp),
+             "  \"behavior\": {\n"
+             "    \"sight\": %.2f,\n"
+             "    \"states\": [\n",
+             behavior->sightRange);
+    strncat(json, temp, size - strlen(json) - 1);
+
+    for (int i = 0; i < behavior->stateCount; i++)
+    {
+        const BehaviorState *s = &behavior->states[i];
+        snprintf(temp, sizeof(temp),
+                 "      {\"name\": \"%s\", \"move\": \"%s\", \"attack\": \"%s\", \"physics\": \"%s\", \"pattern\": \"%s\", "
+                 "\"stop\": %.2f, \"seek\": %.2f, \"range\": %.2f, \"cooldown\": %.2f}%s\n",
+                 s->name, behaviorMoveNames[s->move], behaviorAttackNames[s->attack], behaviorPhysicsNames[s->physicsType],
+                 s->patternName, s->stopDistance, s->seekDistance, s->attackRange, s->cooldownScale,
+                 (i < behavior->stateCount - 1) ? "," : "");
+        strncat(json, temp, size - strlen(json) - 1);
+    }
+    strncat(json, "    ],\n    \"transitions\": [\n", size - strlen(json) - 1);
+
+    for (int i = 0; i < behavior->transitionCount; i++)
+    {
+        const BehaviorTransition *t = &behavior->transitions[i];
+        const BehaviorCondition *cond = &behaviorConditions[t->condition];
+        int len = snprintf(temp, sizeof(temp), "      {\"from\": \"%s\", \"to\": \"%s\", \"when\": \"%s\"",
+                           behavior->states[t->from].name, behavior->states[t->to].name, cond->name);
+        if (cond->hasValue)
+            snprintf(temp + len, sizeof(temp) - len, ", \"value\": %.2f", t->value);
+        strncat(json, temp, size - strlen(json) - 1);
+        strncat(json, (i < behavior->transitionCount - 1) ? "},\n" : "}\n", size - strlen(json) - 1);
+    }
+    strncat(json, "    ]\n  }", size - strlen(json) - 1);
+}
@@ -0,0 +1,98 @@
+#ifndef BEHAVIOR_H
+#define BEHAVIOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BEHAVIOR_MAX_STATES 8
+#define BEHAVIOR_MAX_TRANSITIONS 32
+
+// Defaults for fields a state or behavior leaves out.
+#define BEHAVIOR_DEFAULT_SIGHT 600.0f
+#define BEHAVIOR_DEFAULT_STOP 50.0f
+#define BEHAVIOR_DEFAULT_SEEK 100.0f
+#define BEHAVIOR_DEFAULT_SHOOT_RANGE 300.0f
+#define BEHAVIOR_DEFAULT_MELEE_REACH 10.0f
+
+// How an enemy moves while in a state.
+typedef enum BehaviorMove
+{
+    BEHAVIOR_MOVE_HOLD = 0, // Stand still.
+    BEHAVIOR_MOVE_PATROL,   // Walk between the patrol bounds (flyers keep their heading).
+    BEHAVIOR_MOVE_SEEK,     // Walk at the player within seek distance, stop within stop distance, else patrol.
+    BEHAVIOR_MOVE_CHASE,    // Path toward the player once seen (nav graph or flow field), else seek.
+    BEHAVIOR_MOVE_COUNT
+} BehaviorMove;
+
+typedef enum BehaviorAttack
+{
+    BEHAVIOR_ATTACK_NONE = 0,
+    BEHAVIOR_ATTACK_SHOOT,   // Aimed shot every cooldown within range.
+    BEHAVIOR_ATTACK_PATTERN, // Run the state's bullet pattern (see bullet_pattern.h).
+    BEHAVIOR_ATTACK_MELEE,   // Hit the player when touching (range is the extra reach).
+    BEHAVIOR_ATTACK_COUNT
+} BehaviorAttack;
+
+// Per-entity values transitions compare against.
+typedef enum BehaviorInput
+{
+    BEHAVIOR_INPUT_DISTANCE = 0, // Pixels to the player.
+    BEHAVIOR_INPUT_HEALTH,       // Health as a fraction of the asset's base HP.
+    BEHAVIOR_INPUT_TIME,         // Seconds in the current state.
+    BEHAVIOR_INPUT_SIGHT,        // 1 while the enemy has the player in sight, else 0.
+    BEHAVIOR_INPUT_COUNT
+} BehaviorInput;
+
+typedef struct BehaviorState
+{
+    char name[32];
+    uint8_t move;        // BehaviorMove
+    uint8_t attack;      // BehaviorAttack
+    uint8_t physicsType; // PhysicsType to switch to on entry, or PHYS_NONE to keep.
+    float stopDistance;
+    float seekDistance;
+    float attackRange;   // 0 means unlimited.
+    float cooldownScale; // Multiplies the entity's attack cooldown.
+    char patternName[64];
+} BehaviorState;
+
+// Move to state `to` when inputs[input] is above (or, if !above, below) threshold.
+// condition and value are kept to write the asset back out.
+typedef struct BehaviorTransition
+{
+    float threshold;
+    float value;
+    uint8_t input;
+    uint8_t above;
+    uint8_t from;
+    uint8_t to;
+    uint8_t condition;
+} BehaviorTransition;
+
+// Enemy state machine compiled from the "behavior" section of an entity
+// asset. Transitions are grouped by source state (transitionFirst[s] ..
+// transitionFirst[s + 1]) in file order; the first one that holds wins.
+// Everything is fixed-size so assets can be copied around freely.
+typedef struct EntityBehavior
+{
+    float sightRange;
+    int stateCount;
+    BehaviorState states[BEHAVIOR_MAX_STATES];
+    int transitionCount;
+    BehaviorTransition transitions[BEHAVIOR_MAX_TRANSITIONS];
+    uint8_t transitionFirst[BEHAVIOR_MAX_STATES + 1];
+} EntityBehavior;
+
+// Compile the "behavior" object found in an entity asset's JSON. Returns
+// false (leaving an empty behavior) when there is none or it is malformed.
+bool CompileEntityBehavior(const char *json, const char *assetName, EntityBehavior *behavior);
+
+// Built-in behavior for assets that don't describe one: enemies hunt and
+// shoot, bosses melee until 50% health and then fly and fire the patterns
+// named "<assetName>_phase2" and "_phase3" (below 20%). Players get none.
+void GetDefaultEntityBehavior(int kind, const char *assetName, EntityBehavior *behavior);
+
+// Append the behavior as a "behavior" JSON member (no trailing comma).
+void AppendEntityBehaviorJSON(char *json, size_t size, const EntityBehavior *behavior);
+
+#endif
@@ -1,10 +1,88 @@
 #include "bullet.h"
+#include "bullet_kernels.h"
 #include "game_rendering.h"
 #include <math.h>
 #include "game_state.h"
+#include "entity_store.h"
+#include "game_sim.h"
 
-void SpawnBullet(Bullet bullets[], int maxBullets, bool fromPlayer, Vector2 startPos, Vector2 targetPos, float bulletSpeed)
+static const int bulletOwnerLimits[BULLET_OWNER_COUNT] = {MAX_PLAYER_BULLETS, MAX_ENEMY_BULLETS};
+
+void ResetBulletStore(BulletStore *store)
+{
+    for (int i = 0; i < BULLET_OWNER_COUNT; i++)
+    {
+        store->pools[i].count = 0;
+        store->pools[i].limit = bulletOwnerLimits[i];
+    }
+}
+
+void FreeBulletStore(BulletStore *store)
+{
+    for (int i = 0; i < BULLET_OWNER_COUNT; i++)
+    {
+        // Every array shares the block that starts at posX.
+        if (store->pools[i].posX)
+            arena_free(&gameArena, store->pools[i].posX);
+        memset(&store->pools[i], 0, sizeof(BulletPool));
+    }
+}
+
+int GetBulletCount(const BulletStore *store)
 {
+    int total = 0;
+    for (int i = 0; i < BULLET_OWNER_COUNT; i++)
+        total += store->pools[i].count;
+    return total;
+}
+
+// Double the pool's capacity until it holds at least minCapacity bullets
+// (clamped to its limit), moving the live bullets into one new block that
+// holds all four arrays and the kernel mask.
+static bool GrowBulletPool(BulletPool *pool, int minCapacity)
+{
+    int newCapacity = (pool->capacity > 0) ? pool->capacity * 2 : BULLET_POOL_INITIAL_CAPACITY;
+    while (newCapacity < minCapacity)
+        newCapacity *= 2;
+    if (newCapacity > pool->limit)
+        newCapacity = pool->limit;
+    if (newCapacity <= pool->capacity)
+        return false;
+
+    float *block = (float *)arena_alloc(&gameArena, sizeof(float) * 4 * newCapacity + BULLET_MASK_BYTES(newCapacity));
+    if (!block)
+    {
+        TraceLog(LOG_ERROR, "Failed to grow bullet pool to %d bullets!", newCapacity);
+        return false;
+    }
+
+    float *posX = block;
+    float *posY = block + newCapacity;
+    float *velX = block + newCapacity * 2;
+    float *velY = block + newCapacity * 3;
+    if (pool->posX)
+    {
+        memcpy(posX, pool->posX, sizeof(float) * pool->count);
+        memcpy(posY, pool->posY, sizeof(float) * pool->count);
+        memcpy(velX, pool->velX, sizeof(float) * pool->count);
+        memcpy(velY, pool->velY, sizeof(float) * pool->count);
+        arena_free(&gameArena, pool->posX);
+    }
+    pool->posX = posX;
+    pool->posY = posY;
+    pool->velX = velX;
+    pool->velY = velY;
+    pool->mask = (uint8_t *)(block + newCapacity * 4);
+    pool->capacity = newCapacity;
+    return true;
+}
+
+bool SpawnBullet(BulletStore *store, BulletOwner owner, Vector2 startPos, Vector2 targetPos, float bulletSpeed)
+{
+    BulletPool *pool = &store->pools[owner];
+    if (pool->count >= pool->capacity && !GrowBulletPool(pool, pool->count + 1))
+        return false;
+
     Vector2 direction = {targetPos.x - startPos.x, targetPos.y - startPos.y};
     float len = sqrtf(direction.x * direction.x + direction.y * direction.y);
     if (len > 0.0f)
@@ -12,95 +90,114 @@ void SpawnBullet(Bullet bullets[], int maxBullets, bool fromPlayer, Vector2 star
         direction.x /= len;
         direction.y /= len;
     }
-    for (int i = 0; i < maxBullets; i++)
+    int i = pool->count++;
+    pool->posX[i] = startPos.x;
+    pool->posY[i] = startPos.y;
+    pool->velX[i] = direction.x * bulletSpeed;
+    pool->velY[i] = direction.y * bulletSpeed;
+    return true;
+}
+
+int SpawnBulletSpread(BulletStore *store, BulletOwner owner, Vector2 startPos, float firstAngle,
+                      float angleStep, int count, float bulletSpeed)
+{
+    BulletPool *pool = &store->pools[owner];
+    if (count > pool->limit - pool->count)
+        count = pool->limit - pool->count;
+    if (count <= 0)
+        return 0;
+    if (pool->count + count > pool->capacity && !GrowBulletPool(pool, pool->count + count))
+        return 0;
+
+    float *posX = pool->posX + pool->count;
+    float *posY = pool->posY + pool->count;
+    float *velX = pool->velX + pool->count;
+    float *velY = pool->velY + pool->count;
+    for (int i = 0; i < count; i++)
     {
-        if (!bullets[i].active)
-        {
-            bullets[i].active = true;
-            bullets[i].fromPlayer = fromPlayer;
-            bullets[i].position = startPos;
-            bullets[i].velocity.x = direction.x * bulletSpeed;
-            bullets[i].velocity.y = direction.y * bulletSpeed;
-            break;
-        }
+        float angle = firstAngle + angleStep * i;
+        posX[i] = startPos.x;
+        posY[i] = startPos.y;
+        velX[i] = cosf(angle) * bulletSpeed;
+        velY[i] = sinf(angle) * bulletSpeed;
     }
+    pool->count += count;
+    return count;
 }
 
-void UpdateBullets(Bullet bullets[], int maxBullets, float deltaTime)
+void UpdateBullets(BulletStore *store, float deltaTime)
 {
-    for (int i = 0; i < maxBullets; i++)
+    float maxX = currentMapWidth * (float)TILE_SIZE;
+    float maxY = currentMapHeight * (float)TILE_SIZE;
+    for (int p = 0; p < BULLET_OWNER_COUNT; p++)
     {
-        if (!bullets[i].active)
-            continue;
-        bullets[i].position.x += bullets[i].velocity.x * deltaTime;
-        bullets[i].position.y += bullets[i].velocity.y * deltaTime;
-
-        // Deactivate bullet if it goes off-screen.
-        float maxX = currentMapWidth * (float)TILE_SIZE;
-        float maxY = currentMapHeight * (float)TILE_SIZE;
-        if (bullets[i].position.x < 0 || bullets[i].position.x > maxX ||
-            bullets[i].position.y < 0 || bullets[i].position.y > maxY)
-        {
-            bullets[i].active = false;
-        }
+        BulletPool *pool = &store->pools[p];
+        // Remove bullets once they leave the map.
+        if (IntegrateBulletsSimd(pool, deltaTime, maxX, maxY, pool->mask) > 0)
+            CompactBullets(pool, pool->mask);
     }
 }
 
-void HandleBulletCollisions(Bullet bullets[], int maxBullets, Entity *player, Entity *enemies, int enemyCount,
-                            Entity *boss, bool *bossActive, float bulletRadius)
+// First live row of arch within reach of the bullet at (bX, bY), or -1.
+static int FindBulletTarget(const EntityArchetype *arch, float bX, float bY, float bulletRadius)
 {
-    for (int i = 0; i < maxBullets; i++)
+    for (int e = 0; e < arch->count; e++)
     {
-        if (!bullets[i].active)
+        if (arch->combat[e].health <= 0)
             continue;
-        float bX = bullets[i].position.x;
-        float bY = bullets[i].position.y;
+        float dx = bX - arch->position[e].x;
+        float dy = bY - arch->position[e].y;
+        float dist2 = dx * dx + dy * dy;
+        float combined = bulletRadius + arch->physics[e].radius;
+        if (dist2 <= combined * combined)
+            return e;
+    }
+    return -1;
+}
+
+void HandleBulletCollisions(BulletStore *store, Entity *player, EntityStore *entities, bool bossActive,
+                            float bulletRadius, SimEvents *events)
+{
+    // Player bullets against enemies and the boss.
+    EntityArchetype *enemies = &entities->archetypes[ARCHETYPE_ENEMY];
+    EntityArchetype *boss = &entities->archetypes[ARCHETYPE_BOSS];
+    BulletPool *pool = &store->pools[BULLET_OWNER_PLAYER];
+    int i = 0;
+    while (i < pool->count)
+    {
+        EntityArchetype *arch = enemies;
+        int target = FindBulletTarget(enemies, pool->posX[i], pool->posY[i], bulletRadius);
+        if (target < 0 && bossActive)
+        {
+            arch = boss;
+            target = FindBulletTarget(boss, pool->posX[i], pool->posY[i], bulletRadius);
+        }
 
-        if (bullets[i].fromPlayer)
+        if (target >= 0)
         {
-            // Check collision with each enemy.
-            for (int e = 0; e < enemyCount; e++)
-            {
-                Entity *enemy = &enemies[e];
-                if (enemy->health <= 0)
-                    continue;
-                float dx = bX - enemy->position.x;
-                float dy = bY - enemy->position.y;
-                float dist2 = dx * dx + dy * dy;
-                float combined = bulletRadius + enemy->radius;
-                if (dist2 <= combined * combined)
-                {
-                    enemy->health--;
-                    bullets[i].active = false;
-                    break;
-                }
-            }
-            // Check collision with the boss.
-            if (*bossActive && boss && boss->health > 0 && bullets[i].active)
-            {
-                float dx = bX - boss->position.x;
-                float dy = bY - boss->position.y;
-                float dist2 = dx * dx + dy * dy;
-                float combined = bulletRadius + boss->radius;
-                if (dist2 <= combined * combined)
-                {
-                    boss->health--;
-                    bullets[i].active = false;
-                }
-            }
+            AddSimEffect(events, SIM_EFFECT_HIT, (Vector2){pool->posX[i], pool->posY[i]},
+                         (Vector2){pool->velX[i], pool->velY[i]});
+            if (--arch->combat[target].health <= 0)
+                AddSimEffect(events, SIM_EFFECT_DEATH, arch->position[target], (Vector2){0, 0});
+            RemoveBullet(pool, i);
         }
         else
+            i++;
+    }
+
+    // Enemy bullets against the player.
+    pool = &store->pools[BULLET_OWNER_ENEMY];
+    int hits = OverlapBulletsCircleSimd(pool, player->position.x, player->position.y,
+                                        bulletRadius + player->radius, pool->mask);
+    if (hits > 0)
+    {
+        for (int b = 0; b < pool->count; b++)
         {
-            // Bullet from enemy => check collision with the player.
-            float dx = bX - player->position.x;
-            float dy = bY - player->position.y;
-            float dist2 = dx * dx + dy * dy;
-            float combined = bulletRadius + player->radius;
-            if (dist2 <= combined * combined)
-            {
-                bullets[i].active = false;
-                player->health--;
-            }
+            if (pool->mask[b >> 3] & (1u << (b & 7)))
+                AddSimEffect(events, SIM_EFFECT_HIT, (Vector2){pool->posX[b], pool->posY[b]},
+                             (Vector2){pool->velX[b], pool->velY[b]});
         }
+        player->health -= hits;
+        CompactBullets(pool, pool->mask);
     }
 }
@@ -4,21 +4,59 @@
 #include <raylib.h>
 #include "entity.h"
 
-#define MAX_PLAYER_BULLETS 50
-#define MAX_ENEMY_BULLETS 50
-#define MAX_BULLETS (MAX_PLAYER_BULLETS + MAX_ENEMY_BULLETS)
+#define MAX_PLAYER_BULLETS 256
+#define MAX_ENEMY_BULLETS 65536
+#define BULLET_POOL_INITIAL_CAPACITY 64
 
-typedef struct Bullet
+typedef enum BulletOwner
 {
-    Vector2 position;
-    Vector2 velocity;
-    bool active;
-    bool fromPlayer; // true = shot by player, false = shot by enemy
-} Bullet;
-
-void SpawnBullet(Bullet bullets[], int maxBullets, bool fromPlayer, Vector2 startPos, Vector2 targetPos, float bulletSpeed);
-void UpdateBullets(Bullet bullets[], int maxBullets, float deltaTime);
-void HandleBulletCollisions(Bullet bullets[], int maxBullets, Entity *player, Entity *enemies, int enemyCount,
-                            Entity *boss, bool *bossActive, float bulletRadius);
-
-#endif
\ No newline at end of file
+    BULLET_OWNER_PLAYER = 0,
+    BULLET_OWNER_ENEMY,
+    BULLET_OWNER_COUNT
+} BulletOwner;
+
+// Live bullets of one owner as parallel arrays. Bullets are kept dense in
+// [0, count): spawning appends and removal swaps the last bullet into the
+// hole, so the slots past count are the free list and loops never see a
+// dead bullet. Storage doubles on demand up to limit. mask is scratch space
+// for the bullet kernels, one bit per slot.
+typedef struct BulletPool
+{
+    float *posX;
+    float *posY;
+    float *velX;
+    float *velY;
+    uint8_t *mask;
+    int count;
+    int capacity;
+    int limit;
+} BulletPool;
+
+typedef struct BulletStore
+{
+    BulletPool pools[BULLET_OWNER_COUNT];
+} BulletStore;
+
+// Drop all live bullets and (re)apply the per-owner limits. Keeps storage.
+void ResetBulletStore(BulletStore *store);
+void FreeBulletStore(BulletStore *store);
+int GetBulletCount(const BulletStore *store);
+
+// Returns false when the owner's limit is reached or storage can't grow.
+bool SpawnBullet(BulletStore *store, BulletOwner owner, Vector2 startPos, Vector2 targetPos, float bulletSpeed);
+
+// Spawn count bullets from startPos at firstAngle, firstAngle + angleStep, ...
+// (radians), growing the pool at most once. Returns how many fit under the limit.
+int SpawnBulletSpread(BulletStore *store, BulletOwner owner, Vector2 startPos, float firstAngle,
+                      float angleStep, int count, float bulletSpeed);
+
+void UpdateBullets(BulletStore *store, float deltaTime);
+struct EntityStore;
+struct SimEvents;
+// Player bullets hurt the first enemy row they touch (then the boss while it
+// is active); enemy bullets hurt the player. Each hit, and each row killed,
+// is added to events as an effect.
+void HandleBulletCollisions(BulletStore *store, Entity *player, struct EntityStore *entities, bool bossActive,
+                            float bulletRadius, struct SimEvents *events);
+
+#endif
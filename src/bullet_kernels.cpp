@@ -0,0 +1,214 @@
+#include "bullet_kernels.h"
+
+#if BULLET_KERNEL_WIDTH > 1
+#include <immintrin.h>
+#endif
+
+// Scalar tail shared by the SIMD kernels. start must be a multiple of 8 so
+// every mask byte is written whole.
+static int IntegrateBulletRange(BulletPool *pool, int start, float deltaTime, float maxX, float maxY, uint8_t *deadMask)
+{
+    int flagged = 0;
+    for (int base = start; base < pool->count; base += 8)
+    {
+        unsigned bits = 0;
+        int end = (base + 8 < pool->count) ? base + 8 : pool->count;
+        for (int i = base; i < end; i++)
+        {
+            float x = pool->posX[i] + pool->velX[i] * deltaTime;
+            float y = pool->posY[i] + pool->velY[i] * deltaTime;
+            pool->posX[i] = x;
+            pool->posY[i] = y;
+            if (x < 0 || x > maxX || y < 0 || y > maxY)
+            {
+                bits |= 1u << (i - base);
+                flagged++;
+            }
+        }
+        deadMask[base >> 3] = (uint8_t)bits;
+    }
+    return flagged;
+}
+
+static int OverlapCircleRange(const BulletPool *pool, int start, float centerX, float centerY, float radius, uint8_t *hitMask)
+{
+    int hits = 0;
+    float radius2 = radius * radius;
+    for (int base = start; base < pool->count; base += 8)
+    {
+        unsigned bits = 0;
+        int end = (base + 8 < pool->count) ? base + 8 : pool->count;
+        for (int i = base; i < end; i++)
+        {
+            float dx = pool->posX[i] - centerX;
+            float dy = pool->posY[i] - centerY;
+            if (dx * dx + dy * dy <= radius2)
+            {
+                bits |= 1u << (i - base);
+                hits++;
+            }
+        }
+        hitMask[base >> 3] = (uint8_t)bits;
+    }
+    return hits;
+}
+
+int IntegrateBulletsScalar(BulletPool *pool, float deltaTime, float maxX, float maxY, uint8_t *deadMask)
+{
+    return IntegrateBulletRange(pool, 0, deltaTime, maxX, maxY, deadMask);
+}
+
+int OverlapBulletsCircleScalar(const BulletPool *pool, float centerX, float centerY, float radius, uint8_t *hitMask)
+{
+    return OverlapCircleRange(pool, 0, centerX, centerY, radius, hitMask);
+}
+
+#if BULLET_KERNEL_WIDTH == 16
+
+int IntegrateBulletsSimd(BulletPool *pool, float deltaTime, float maxX, float maxY, uint8_t *deadMask)
+{
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 limitX = _mm256_set1_ps(maxX);
+    const __m256 limitY = _mm256_set1_ps(maxY);
+    int flagged = 0;
+    int i = 0;
+    for (; i + 16 <= pool->count; i += 16)
+    {
+        unsigned bits = 0;
+        for (int half = 0; half < 16; half += 8)
+        {
+            int j = i + half;
+            __m256 x = _mm256_add_ps(_mm256_loadu_ps(pool->posX + j), _mm256_mul_ps(_mm256_loadu_ps(pool->velX + j), dt));
+            __m256 y = _mm256_add_ps(_mm256_loadu_ps(pool->posY + j), _mm256_mul_ps(_mm256_loadu_ps(pool->velY + j), dt));
+            _mm256_storeu_ps(pool->posX + j, x);
+            _mm256_storeu_ps(pool->posY + j, y);
+            __m256 outX = _mm256_or_ps(_mm256_cmp_ps(x, zero, _CMP_LT_OQ), _mm256_cmp_ps(x, limitX, _CMP_GT_OQ));
+            __m256 outY = _mm256_or_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), _mm256_cmp_ps(y, limitY, _CMP_GT_OQ));
+            bits |= (unsigned)_mm256_movemask_ps(_mm256_or_ps(outX, outY)) << half;
+        }
+        deadMask[i >> 3] = (uint8_t)bits;
+        deadMask[(i >> 3) + 1] = (uint8_t)(bits >> 8);
+        flagged += __builtin_popcount(bits);
+    }
+    return flagged + IntegrateBulletRange(pool, i, deltaTime, maxX, maxY, deadMask);
+}
+
+int OverlapBulletsCircleSimd(const BulletPool *pool, float centerX, float centerY, float radius, uint8_t *hitMask)
+{
+    const __m256 cx = _mm256_set1_ps(centerX);
+    const __m256 cy = _mm256_set1_ps(centerY);
+    const __m256 radius2 = _mm256_set1_ps(radius * radius);
+    int hits = 0;
+    int i = 0;
+    for (; i + 16 <= pool->count; i += 16)
+    {
+        unsigned bits = 0;
+        for (int half = 0; half < 16; half += 8)
+        {
+            int j = i + half;
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(pool->posX + j), cx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(pool->posY + j), cy);
+            __m256 dist2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            bits |= (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(dist2, radius2, _CMP_LE_OQ)) << half;
+        }
+        hitMask[i >> 3] = (uint8_t)bits;
+        hitMask[(i >> 3) + 1] = (uint8_t)(bits >> 8);
+        hits += __builtin_popcount(bits);
+    }
+    return hits + OverlapCircleRange(pool, i, centerX, centerY, radius, hitMask);
+}
+
+#elif BULLET_KERNEL_WIDTH == 8
+
+int IntegrateBulletsSimd(BulletPool *pool, float deltaTime, float maxX, float maxY, uint8_t *deadMask)
+{
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 limitX = _mm_set1_ps(maxX);
+    const __m128 limitY = _mm_set1_ps(maxY);
+    int flagged = 0;
+    int i = 0;
+    for (; i + 8 <= pool->count; i += 8)
+    {
+        unsigned bits = 0;
+        for (int half = 0; half < 8; half += 4)
+        {
+            int j = i + half;
+            __m128 x = _mm_add_ps(_mm_loadu_ps(pool->posX + j), _mm_mul_ps(_mm_loadu_ps(pool->velX + j), dt));
+            __m128 y = _mm_add_ps(_mm_loadu_ps(pool->posY + j), _mm_mul_ps(_mm_loadu_ps(pool->velY + j), dt));
+            _mm_storeu_ps(pool->posX + j, x);
+            _mm_storeu_ps(pool->posY + j, y);
+            __m128 outX = _mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpgt_ps(x, limitX));
+            __m128 outY = _mm_or_ps(_mm_cmplt_ps(y, zero), _mm_cmpgt_ps(y, limitY));
+            bits |= (unsigned)_mm_movemask_ps(_mm_or_ps(outX, outY)) << half;
+        }
+        deadMask[i >> 3] = (uint8_t)bits;
+        flagged += __builtin_popcount(bits);
+    }
+    return flagged + IntegrateBulletRange(pool, i, deltaTime, maxX, maxY, deadMask);
+}
+
+int OverlapBulletsCircleSimd(const BulletPool *pool, float centerX, float centerY, float radius, uint8_t *hitMask)
+{
+    const __m128 cx = _mm_set1_ps(centerX);
+    const __m128 cy = _mm_set1_ps(centerY);
+    const __m128 radius2 = _mm_set1_ps(radius * radius);
+    int hits = 0;
+    int i = 0;
+    for (; i + 8 <= pool->count; i += 8)
+    {
+        unsigned bits = 0;
+        for (int half = 0; half < 8; half += 4)
+        {
+            int j = i + half;
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(pool->posX + j), cx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(pool->posY + j), cy);
+            __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            bits |= (unsigned)_mm_movemask_ps(_mm_cmple_ps(dist2, radius2)) << half;
+        }
+        hitMask[i >> 3] = (uint8_t)bits;
+        hits += __builtin_popcount(bits);
+    }
+    return hits + OverlapCircleRange(pool, i, centerX, centerY, radius, hitMask);
+}
+
+#else
+
+int IntegrateBulletsSimd(BulletPool *pool, float deltaTime, float maxX, float maxY, uint8_t *deadMask)
+{
+    return IntegrateBulletRange(pool, 0, deltaTime, maxX, maxY, deadMask);
+}
+
+int OverlapBulletsCircleSimd(const BulletPool *pool, float centerX, float centerY, float radius, uint8_t *hitMask)
+{
+    return OverlapCircleRange(pool, 0, centerX, centerY, radius, hitMask);
+}
+
+#endif
+
+void RemoveBullet(BulletPool *pool, int index)
+{
+    int last = --pool->count;
+    pool->posX[index] = pool->posX[last];
+    pool->posY[index] = pool->posY[last];
+    pool->velX[index] = pool->velX[last];
+    pool->velY[index] = pool->velY[last];
+}
+
+void CompactBullets(BulletPool *pool, const uint8_t *mask)
+{
+    // Walk backwards so every bullet swapped into a hole has already been
+    // visited and is known to be alive.
+    for (int byteIndex = BULLET_MASK_BYTES(pool->count) - 1; byteIndex >= 0; byteIndex--)
+    {
+        unsigned bits = mask[byteIndex];
+        if (bits == 0)
+            continue;
+        for (int bit = 7; bit >= 0; bit--)
+        {
+            if (bits & (1u << bit))
+                RemoveBullet(pool, byteIndex * 8 + bit);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef BULLET_KERNELS_H
+#define BULLET_KERNELS_H
+
+#include <stdint.h>
+#include "bullet.h"
+
+// Bullets handled per kernel iteration: two AVX or two SSE registers.
+#if defined(__AVX__)
+#define BULLET_KERNEL_WIDTH 16
+#elif defined(__SSE2__)
+#define BULLET_KERNEL_WIDTH 8
+#else
+#define BULLET_KERNEL_WIDTH 1
+#endif
+
+// Bytes needed for a bullet mask covering count bullets (one bit per bullet).
+#define BULLET_MASK_BYTES(count) (((count) + 7) / 8)
+
+// Move every bullet by velocity * deltaTime and set its bit in deadMask when
+// it ends up outside [0, maxX] x [0, maxY]. Returns the number of bits set.
+int IntegrateBulletsScalar(BulletPool *pool, float deltaTime, float maxX, float maxY, uint8_t *deadMask);
+int IntegrateBulletsSimd(BulletPool *pool, float deltaTime, float maxX, float maxY, uint8_t *deadMask);
+
+// Set the bit of every bullet within radius of (centerX, centerY) in hitMask.
+// Returns the number of bits set.
+int OverlapBulletsCircleScalar(const BulletPool *pool, float centerX, float centerY, float radius, uint8_t *hitMask);
+int OverlapBulletsCircleSimd(const BulletPool *pool, float centerX, float centerY, float radius, uint8_t *hitMask);
+
+// Remove one bullet by moving the pool's last bullet into its slot.
+void RemoveBullet(BulletPool *pool, int index);
+
+// Swap-remove every bullet whose bit is set in mask.
+void CompactBullets(BulletPool *pool, const uint8_t *mask);
+
+#endif
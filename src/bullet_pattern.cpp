@@ -0,0 +1,298 @@
+#include "bullet_pattern.h"
+#include "memory_arena.h"
+#include "file_io.h"
+#include "asset_pack.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+BulletPattern *bulletPatterns = NULL;
+int bulletPatternCount = 0;
+
+typedef struct PatternKeyword
+{
+    const char *name;
+    PatternOpcode opcode;
+    bool hasCount;
+    bool hasValue;
+    bool degrees; // value is written in degrees and stored in radians.
+} PatternKeyword;
+
+static const PatternKeyword patternKeywords[] = {
+    {"aim", PATTERN_OP_AIM, false, false, false},
+    {"angle", PATTERN_OP_ANGLE, false, true, true},
+    {"spin", PATTERN_OP_SPIN, false, true, true},
+    {"speed", PATTERN_OP_SPEED, false, true, false},
+    {"fan", PATTERN_OP_FAN, true, true, true},
+    {"ring", PATTERN_OP_RING, true, false, false},
+    {"wait", PATTERN_OP_WAIT, false, true, false},
+    {"wait_cooldown", PATTERN_OP_WAIT_COOLDOWN, false, true, false},
+    {"repeat", PATTERN_OP_REPEAT, true, false, false},
+    {"end", PATTERN_OP_LOOP, false, false, false},
+};
+
+bool CompileBulletPattern(const char *source, const char *name, BulletPattern *pattern)
+{
+    PatternInstruction code[MAX_PATTERN_INSTRUCTIONS];
+    int repeatStack[MAX_PATTERN_LOOP_DEPTH];
+    int depth = 0;
+    int length = 0;
+    bool hasWait = false;
+    int lineNumber = 0;
+
+    const char *line = source;
+    while (line && *line)
+    {
+        lineNumber++;
+        const char *next = strchr(line, '\n');
+        char text[128];
+        size_t len = next ? (size_t)(next - line) : strlen(line);
+        if (len >= sizeof(text))
+            len = sizeof(text) - 1;
+        memcpy(text, line, len);
+        text[len] = '\0';
+        line = next ? next + 1 : NULL;
+
+        char *comment = strchr(text, '#');
+        if (comment)
+            *comment = '\0';
+        char keyword[32];
+        int consumed = 0;
+        if (sscanf(text, " %31s%n", keyword, &consumed) != 1)
+            continue;
+
+        const PatternKeyword *kw = NULL;
+        for (size_t k = 0; k < sizeof(patternKeywords) / sizeof(patternKeywords[0]); k++)
+        {
+            if (strcmp(keyword, patternKeywords[k].name) == 0)
+            {
+                kw = &patternKeywords[k];
+                break;
+            }
+        }
+        if (!kw)
+        {
+            TraceLog(LOG_WARNING, "PATTERN: %s:%d: unknown instruction '%s'", name, lineNumber, keyword);
+            return false;
+        }
+        if (length >= MAX_PATTERN_INSTRUCTIONS)
+        {
+            TraceLog(LOG_WARNING, "PATTERN: %s: more than %d instructions", name, MAX_PATTERN_INSTRUCTIONS);
+            return false;
+        }
+
+        PatternInstruction *ins = &code[length];
+        memset(ins, 0, sizeof(*ins));
+        ins->opcode = (uint8_t)kw->opcode;
+        const char *args = text + consumed;
+        int count = 0;
+        float value = 0.0f;
+        bool ok = true;
+        if (kw->hasCount && kw->hasValue)
+            ok = sscanf(args, " %d %f", &count, &value) == 2;
+        else if (kw->hasCount)
+            ok = sscanf(args, " %d", &count) == 1;
+        else if (kw->hasValue)
+            ok = sscanf(args, " %f", &value) == 1;
+        if (!ok || (kw->hasCount && (count < 1 || count > UINT16_MAX)))
+        {
+            TraceLog(LOG_WARNING, "PATTERN: %s:%d: bad arguments for '%s'", name, lineNumber, keyword);
+            return false;
+        }
+        ins->count = (uint16_t)count;
+        ins->value = kw->degrees ? value * DEG2RAD : value;
+
+        if (kw->opcode == PATTERN_OP_REPEAT)
+        {
+            if (depth >= MAX_PATTERN_LOOP_DEPTH)
+            {
+                TraceLog(LOG_WARNING, "PATTERN: %s:%d: repeats nested too deep", name, lineNumber);
+                return false;
+            }
+            repeatStack[depth++] = length;
+        }
+        else if (kw->opcode == PATTERN_OP_LOOP)
+        {
+            if (depth == 0)
+            {
+                TraceLog(LOG_WARNING, "PATTERN: %s:%d: 'end' without 'repeat'", name, lineNumber);
+                return false;
+            }
+            ins->target = (uint8_t)(repeatStack[--depth] + 1);
+        }
+        else if (kw->opcode == PATTERN_OP_WAIT || kw->opcode == PATTERN_OP_WAIT_COOLDOWN)
+        {
+            hasWait = hasWait || value > 0.0f;
+        }
+        length++;
+    }
+
+    if (depth != 0)
+    {
+        TraceLog(LOG_WARNING, "PATTERN: %s: 'repeat' without 'end'", name);
+        return false;
+    }
+    // The program loops forever, so it has to yield somewhere.
+    if (!hasWait)
+    {
+        TraceLog(LOG_WARNING, "PATTERN: %s: needs at least one positive wait", name);
+        return false;
+    }
+
+    pattern->code = (PatternInstruction *)arena_alloc(&assetArena, sizeof(PatternInstruction) * length);
+    if (!pattern->code)
+    {
+        TraceLog(LOG_ERROR, "PATTERN: Failed to allocate %d instructions for %s", length, name);
+        return false;
+    }
+    memcpy(pattern->code, code, sizeof(PatternInstruction) * length);
+    pattern->length = length;
+    snprintf(pattern->name, sizeof(pattern->name), "%s", name);
+    return true;
+}
+
+bool LoadBulletPatternFromFile(const char *filename, BulletPattern *pattern)
+{
+    AssetFile file;
+    if (!LoadAssetFile(filename, &file))
+    {
+        TraceLog(LOG_ERROR, "PATTERN: Failed to open %s", filename);
+        return false;
+    }
+    char buffer[1024 * 10];
+    size_t size = (file.size < sizeof(buffer) - 1) ? file.size : sizeof(buffer) - 1;
+    memcpy(buffer, file.data, size);
+    buffer[size] = '\0';
+    UnloadAssetFile(&file);
+
+    // The pattern is named after its file, without directory or extension.
+    const char *base = filename;
+    for (const char *c = filename; *c; c++)
+    {
+        if (*c == '/' || *c == '\\')
+            base = c + 1;
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "%s", base);
+    char *dot = strrchr(name, '.');
+    if (dot)
+        *dot = '\0';
+
+    return CompileBulletPattern(buffer, name, pattern);
+}
+
+bool LoadBulletPatterns(const char *directory, BulletPattern **patterns, int *count)
+{
+    FileList fileList;
+    ListAssetFiles(&assetArena, directory, ".pat", &fileList);
+    int numFiles = fileList.count;
+    if (numFiles <= 0)
+    {
+        FreeFileList(&assetArena, &fileList);
+        return false;
+    }
+
+    if (*patterns == NULL)
+        *patterns = (BulletPattern *)arena_alloc(&assetArena, sizeof(BulletPattern) * numFiles);
+    else
+        *patterns = (BulletPattern *)arena_realloc(&assetArena, *patterns, sizeof(BulletPattern) * numFiles);
+
+    if (*patterns == NULL)
+    {
+        TraceLog(LOG_ERROR, "Failed to allocate memory for bullet patterns (size %d)", numFiles);
+        FreeFileList(&assetArena, &fileList);
+        return false;
+    }
+
+    int loadedCount = 0;
+    for (int i = 0; i < numFiles; i++)
+    {
+        char fullPath[256];
+        snprintf(fullPath, sizeof(fullPath), "%s%s", directory, GetFileListName(&fileList, i));
+
+        if (LoadBulletPatternFromFile(fullPath, &((*patterns)[loadedCount])))
+            loadedCount++;
+        else
+            TraceLog(LOG_ERROR, "Failed to load bullet pattern from file: %s", fullPath);
+    }
+    FreeFileList(&assetArena, &fileList);
+    *count = loadedCount;
+    return true;
+}
+
+const BulletPattern *GetBulletPatternByName(const char *name)
+{
+    for (int i = 0; i < bulletPatternCount; i++)
+    {
+        if (strcmp(bulletPatterns[i].name, name) == 0)
+            return &bulletPatterns[i];
+    }
+    return NULL;
+}
+
+void ResetBulletEmitter(BulletEmitter *emitter, const BulletPattern *pattern, float bulletSpeed)
+{
+    memset(emitter, 0, sizeof(*emitter));
+    emitter->pattern = pattern;
+    emitter->speed = bulletSpeed;
+}
+
+int StepBulletEmitter(BulletEmitter *emitter, BulletStore *store, BulletOwner owner,
+                      Vector2 origin, Vector2 target, float cooldown, float deltaTime)
+{
+    const BulletPattern *pattern = emitter->pattern;
+    if (!pattern || pattern->length == 0)
+        return 0;
+
+    int spawned = 0;
+    emitter->wait -= deltaTime;
+    for (int steps = 0; emitter->wait <= 0.0f && steps < MAX_PATTERN_STEPS_PER_TICK; steps++)
+    {
+        if (emitter->pc >= pattern->length)
+        {
+            emitter->pc = 0;
+            emitter->loopDepth = 0;
+        }
+
+        const PatternInstruction *ins = &pattern->code[emitter->pc++];
+        switch (ins->opcode)
+        {
+        case PATTERN_OP_AIM:
+            emitter->angle = atan2f(target.y - origin.y, target.x - origin.x);
+            break;
+        case PATTERN_OP_ANGLE:
+            emitter->angle = ins->value;
+            break;
+        case PATTERN_OP_SPIN:
+            emitter->angle += ins->value;
+            break;
+        case PATTERN_OP_SPEED:
+            emitter->speed = ins->value;
+            break;
+        case PATTERN_OP_FAN:
+            spawned += SpawnBulletSpread(store, owner, origin, emitter->angle - ins->value * (ins->count - 1) * 0.5f,
+                                         ins->value, ins->count, emitter->speed);
+            break;
+        case PATTERN_OP_RING:
+            spawned += SpawnBulletSpread(store, owner, origin, emitter->angle, 2.0f * PI / ins->count,
+                                         ins->count, emitter->speed);
+            break;
+        case PATTERN_OP_WAIT:
+            emitter->wait += ins->value;
+            break;
+        case PATTERN_OP_WAIT_COOLDOWN:
+            emitter->wait += ins->value * cooldown;
+            break;
+        case PATTERN_OP_REPEAT:
+            emitter->loopRemaining[emitter->loopDepth++] = ins->count;
+            break;
+        case PATTERN_OP_LOOP:
+            if (--emitter->loopRemaining[emitter->loopDepth - 1] > 0)
+                emitter->pc = ins->target;
+            else
+                emitter->loopDepth--;
+            break;
+        }
+    }
+    return spawned;
+}
@@ -0,0 +1,72 @@
+#ifndef BULLET_PATTERN_H
+#define BULLET_PATTERN_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include "bullet.h"
+
+#define MAX_PATTERN_INSTRUCTIONS 256
+#define MAX_PATTERN_LOOP_DEPTH 4
+// Guards against patterns whose loops never reach a wait.
+#define MAX_PATTERN_STEPS_PER_TICK 1024
+
+typedef enum PatternOpcode
+{
+    PATTERN_OP_AIM = 0,       // Point the emitter at the target.
+    PATTERN_OP_ANGLE,         // Set the emitter angle (value, radians).
+    PATTERN_OP_SPIN,          // Rotate the emitter angle (value, radians).
+    PATTERN_OP_SPEED,         // Set the bullet speed (value).
+    PATTERN_OP_FAN,           // count bullets centered on the angle, value radians apart.
+    PATTERN_OP_RING,          // count bullets evenly around a full circle.
+    PATTERN_OP_WAIT,          // Pause for value seconds.
+    PATTERN_OP_WAIT_COOLDOWN, // Pause for value times the owner's shoot cooldown.
+    PATTERN_OP_REPEAT,        // Run the body up to the matching LOOP count times.
+    PATTERN_OP_LOOP,          // Jump back to target while the innermost repeat has runs left.
+} PatternOpcode;
+
+typedef struct PatternInstruction
+{
+    uint8_t opcode;
+    uint8_t target; // LOOP only: index of the first body instruction.
+    uint16_t count;
+    float value;
+} PatternInstruction;
+
+// A compiled pattern. The program restarts from the top when it runs off the end.
+typedef struct BulletPattern
+{
+    char name[64];
+    PatternInstruction *code;
+    int length;
+} BulletPattern;
+
+// Execution state of one pattern. Zeroed means idle.
+typedef struct BulletEmitter
+{
+    const BulletPattern *pattern;
+    int pc;
+    float wait;
+    float angle;
+    float speed;
+    int loopDepth;
+    uint16_t loopRemaining[MAX_PATTERN_LOOP_DEPTH];
+} BulletEmitter;
+
+extern BulletPattern *bulletPatterns;
+extern int bulletPatternCount;
+
+// Compile pattern source text. Returns false (and logs the line) on a syntax error.
+bool CompileBulletPattern(const char *source, const char *name, BulletPattern *pattern);
+bool LoadBulletPatternFromFile(const char *filename, BulletPattern *pattern);
+bool LoadBulletPatterns(const char *directory, BulletPattern **patterns, int *count);
+const BulletPattern *GetBulletPatternByName(const char *name);
+
+// Start pattern from its first instruction. pattern may be NULL to silence the emitter.
+void ResetBulletEmitter(BulletEmitter *emitter, const BulletPattern *pattern, float bulletSpeed);
+
+// Advance the emitter by deltaTime, spawning every bullet due this tick from
+// origin. Returns the number of bullets spawned.
+int StepBulletEmitter(BulletEmitter *emitter, BulletStore *store, BulletOwner owner,
+                      Vector2 origin, Vector2 target, float cooldown, float deltaTime);
+
+#endif
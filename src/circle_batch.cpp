@@ -0,0 +1,98 @@
+#include "circle_batch.h"
+#include <rlgl.h>
+#include <math.h>
+
+static Texture2D circleSprite;
+static Rectangle batchView;
+
+void LoadCircleBatch(void)
+{
+    // White disc with a one pixel soft edge so it can be tinted and scaled.
+    Image image = GenImageColor(CIRCLE_SPRITE_SIZE, CIRCLE_SPRITE_SIZE, BLANK);
+    Color *pixels = (Color *)image.data;
+    float center = CIRCLE_SPRITE_SIZE * 0.5f;
+    for (int y = 0; y < CIRCLE_SPRITE_SIZE; y++)
+    {
+        for (int x = 0; x < CIRCLE_SPRITE_SIZE; x++)
+        {
+            float dx = x + 0.5f - center;
+            float dy = y + 0.5f - center;
+            float coverage = center - sqrtf(dx * dx + dy * dy);
+            if (coverage > 1.0f)
+                coverage = 1.0f;
+            if (coverage > 0.0f)
+                pixels[y * CIRCLE_SPRITE_SIZE + x] = (Color){255, 255, 255, (unsigned char)(255.0f * coverage)};
+        }
+    }
+    circleSprite = LoadTextureFromImage(image);
+    UnloadImage(image);
+    SetTextureFilter(circleSprite, TEXTURE_FILTER_BILINEAR);
+}
+
+void UnloadCircleBatch(void)
+{
+    if (circleSprite.id != 0)
+        UnloadTexture(circleSprite);
+    circleSprite = (Texture2D){0};
+}
+
+void BeginCircleBatch(Rectangle view)
+{
+    batchView = view;
+    rlSetTexture(circleSprite.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+}
+
+void PushCircle(float x, float y, float radius, Color color)
+{
+    if (x + radius < batchView.x || x - radius > batchView.x + batchView.width ||
+        y + radius < batchView.y || y - radius > batchView.y + batchView.height)
+        return;
+
+    // Counter-clockwise, matching DrawTexturePro.
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlTexCoord2f(0.0f, 0.0f);
+    rlVertex2f(x - radius, y - radius);
+    rlTexCoord2f(0.0f, 1.0f);
+    rlVertex2f(x - radius, y + radius);
+    rlTexCoord2f(1.0f, 1.0f);
+    rlVertex2f(x + radius, y + radius);
+    rlTexCoord2f(1.0f, 0.0f);
+    rlVertex2f(x + radius, y - radius);
+}
+
+void EndCircleBatch(void)
+{
+    rlEnd();
+    rlSetTexture(0);
+    rlDrawRenderBatchActive();
+}
+
+Rectangle GetCameraView(const Camera2D *cam)
+{
+    Vector2 topLeft = GetScreenToWorld2D((Vector2){0, 0}, *cam);
+    Vector2 bottomRight = GetScreenToWorld2D((Vector2){(float)GetScreenWidth(), (float)GetScreenHeight()}, *cam);
+    return (Rectangle){topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y};
+}
+
+void DrawBullets(const float *posX, const float *posY, int count, const Camera2D *cam, float radius, Color color)
+{
+    BeginCircleBatch(GetCameraView(cam));
+    for (int i = 0; i < count; i++)
+        PushCircle(posX[i], posY[i], radius, color);
+    EndCircleBatch();
+}
+
+void DrawParticles(const ParticleSystem *system, Rectangle view)
+{
+    BeginCircleBatch(view);
+    for (int i = 0; i < system->count; i++)
+    {
+        float remaining = system->life[i] * system->fade[i];
+        Color color = system->color[i];
+        color.a = (unsigned char)(color.a * remaining);
+        PushCircle(system->posX[i], system->posY[i], system->size[i] * (0.5f + 0.5f * remaining), color);
+    }
+    EndCircleBatch();
+}
@@ -0,0 +1,30 @@
+#ifndef CIRCLE_BATCH_H
+#define CIRCLE_BATCH_H
+
+#include <raylib.h>
+#include "particles.h"
+
+// Side length in pixels of the pre-rendered circle sprite.
+#define CIRCLE_SPRITE_SIZE 32
+
+// Small circles (bullets, firework particles) drawn as textured quads that
+// all share one circle sprite. Between Begin and End the texture is bound
+// once and every circle is appended to raylib's render batch, which is
+// flushed once at End. Circles entirely outside the view are skipped.
+void LoadCircleBatch(void);
+void UnloadCircleBatch(void);
+
+void BeginCircleBatch(Rectangle view);
+void PushCircle(float x, float y, float radius, Color color);
+void EndCircleBatch(void);
+
+// World-space rectangle currently visible through the camera.
+Rectangle GetCameraView(const Camera2D *cam);
+
+// Draw bullets at the given positions in one batch.
+void DrawBullets(const float *posX, const float *posY, int count, const Camera2D *cam, float radius, Color color);
+
+// Draw every live particle in one batch, fading and shrinking with age.
+void DrawParticles(const ParticleSystem *system, Rectangle view);
+
+#endif
@@ -8,6 +8,12 @@
 #include "game_storage.h"
 #include "tile.h"
 #include "animation.h"
+#include "game_sim.h"
+#include "circle_batch.h"
+#include "sprite_batch.h"
+
+// Most frames one animation can have when edited in the asset inspector.
+#define EDITOR_MAX_CLIP_FRAMES 64
 
 static bool showFileList = false;
 static bool showAssetList = true;
@@ -19,6 +25,8 @@ static int selectedFileIndex = -1;
 static int selectedAssetIndex = -1;
 static int selectedEntityIndex = -1;
 static int selectedCheckpointIndex = -1;
+static int selectedSpawnerIndex = -1;
+static bool showSpawnerPanel = false;
 static int boundType = -1; // 0 = left, 1 = right
 
 static Vector2 dragOffset = {0};
@@ -217,6 +225,7 @@ void DoEntityCreation(Vector2 screenPos)
         Entity newInstance = {0};
 
         newInstance.assetId = asset->id;
+        newInstance.asset = GetEntityAssetHandle(selectedAssetIndex);
         newInstance.kind = asset->kind;
         newInstance.physicsType = asset->physicsType;
         newInstance.radius = asset->baseRadius;
@@ -229,15 +238,6 @@ void DoEntityCreation(Vector2 screenPos)
         newInstance.velocity = (Vector2){0, 0};
         newInstance.state = ENTITY_STATE_IDLE;
 
-        if (asset->idle.frameCount > 0)
-            InitEntityAnimation(&newInstance.idle, &asset->idle, asset->texture);
-        if (asset->walk.frameCount > 0)
-            InitEntityAnimation(&newInstance.walk, &asset->walk, asset->texture);
-        if (asset->ascend.frameCount > 0)
-            InitEntityAnimation(&newInstance.ascend, &asset->ascend, asset->texture);
-        if (asset->fall.frameCount > 0)
-            InitEntityAnimation(&newInstance.fall, &asset->fall, asset->texture);
-
         if (asset->kind != ENTITY_PLAYER)
         {
             newInstance.leftBound = screenPos.x - 50;
@@ -301,9 +301,12 @@ void DoTilePaint(Vector2 screenPos)
                         // Build the composite ID
                         unsigned int compositeId = ((ts->uniqueId & 0xFFF) << 20) |
                                                    ((tilePhys & 0xF) << 16) |
-                                                   ((selectedTileIndex + 1) & 0xFFFF);
+                                                   ((selectedTileIndex + 1) & (TILE_FOREGROUND_FLAG - 1));
+                        if (selectedTileForeground)
+                            compositeId |= TILE_FOREGROUND_FLAG;
 
                         mapTiles[tileY][tileX] = compositeId;
+                        MarkNavTileDirty(&gameState->nav, tileX, tileY);
                     }
                 }
             }
@@ -314,6 +317,7 @@ void DoTilePaint(Vector2 screenPos)
                 isPainting = true;
 
             mapTiles[tileY][tileX] = 0;
+            MarkNavTileDirty(&gameState->nav, tileX, tileY);
         }
         else
         {
@@ -370,6 +374,14 @@ static void DrawNewLevelPopup()
                 gameState->currentState = EDITOR;
                 strcpy(gameState->currentLevelFilename, fixedName);
                 mapTiles = InitializeTilemap(newMapWidth, newMapHeight);
+                if (!mapTiles)
+                {
+                    // The arena was just reset, so the default size always fits.
+                    TraceLog(LOG_ERROR, "Couldn't allocate a %dx%d tilemap!", newMapWidth, newMapHeight);
+                    newMapWidth = 60;
+                    newMapHeight = 16;
+                    mapTiles = InitializeTilemap(newMapWidth, newMapHeight);
+                }
                 ImGui::CloseCurrentPopup();
                 showNewLevelPopup = false;
             }
@@ -447,6 +459,45 @@ static void DrawFileListWindow()
     }
 }
 
+// Frame count and rectangles of one animation, edited on a copy: library
+// clips are shared between assets and never change, so each edit interns the
+// result as a clip (reusing an identical one) and points the asset at it.
+static void EditAnimationClip(int *assetClip)
+{
+    static Rectangle frames[EDITOR_MAX_CLIP_FRAMES];
+    const AnimationClip *clip = GetAnimationClip(*assetClip);
+    int frameCount = (clip->frameCount < EDITOR_MAX_CLIP_FRAMES) ? clip->frameCount : EDITOR_MAX_CLIP_FRAMES;
+    float frameTime = clip->frameTime;
+    memset(frames, 0, sizeof(frames));
+    if (frameCount > 0)
+        memcpy(frames, GetAnimationClipFrames(clip), sizeof(Rectangle) * frameCount);
+
+    bool changed = false;
+    if (ImGui::InputInt("Frame Count", &frameCount))
+    {
+        if (frameCount < 0)
+            frameCount = 0;
+        if (frameCount > EDITOR_MAX_CLIP_FRAMES)
+            frameCount = EDITOR_MAX_CLIP_FRAMES;
+        changed = true;
+    }
+    changed |= ImGui::InputFloat("Frame Time", &frameTime);
+    if (frameCount > 0)
+    {
+        ImGui::Text("x y width height");
+        for (int i = 0; i < frameCount; i++)
+        {
+            ImGui::PushID(i);
+            char label[16];
+            sprintf(label, "Frame: %d", i);
+            changed |= ImGui::InputFloat4(label, (float *)&frames[i]);
+            ImGui::PopID();
+        }
+    }
+    if (changed)
+        *assetClip = InternAnimationClip(frames, frameCount, frameTime);
+}
+
 static void DrawAssetListPanel()
 {
     if (showAssetList)
@@ -483,7 +534,6 @@ static void DrawAssetListPanel()
                 float regionWidth = ImGui::GetWindowContentRegionMax().x;
                 ImGui::SetCursorPosX(regionWidth - 20);
                 bool closeInspector = false;
-                AnimationFrames *animFrames = NULL;
                 EntityAsset *asset = NULL;
                 if (ImGui::SmallButton("X"))
                 {
@@ -503,27 +553,13 @@ static void DrawAssetListPanel()
                                          ImVec2((float)asset->texture.width, (float)asset->texture.height));
                             ImVec2 imagePosMin = ImGui::GetItemRectMin();
                             float scale = 1.0f;
-                            switch (selectedAnim)
-                            {
-                            case 0:
-                                animFrames = &asset->idle;
-                                break;
-                            case 1:
-                                animFrames = &asset->walk;
-                                break;
-                            case 2:
-                                animFrames = &asset->ascend;
-                                break;
-                            case 3:
-                                animFrames = &asset->fall;
-                                break;
-                            }
-                            if (animFrames && animFrames->frames)
+                            const AnimationClip *clip = GetAnimationClip(asset->clips[selectedAnim]);
+                            if (clip->frameCount > 0)
                             {
                                 ImDrawList *drawList = ImGui::GetWindowDrawList();
-                                for (int i = 0; i < animFrames->frameCount; i++)
+                                for (int i = 0; i < clip->frameCount; i++)
                                 {
-                                    Rectangle r = animFrames->frames[i];
+                                    Rectangle r = GetAnimationClipFrames(clip)[i];
                                     ImVec2 rectMin = ImVec2(imagePosMin.x + r.x * scale,
                                                             imagePosMin.y + r.y * scale);
                                     ImVec2 rectMax = ImVec2(rectMin.x + r.width * scale,
@@ -568,44 +604,7 @@ static void DrawAssetListPanel()
                     }
                     static const char *animTypes[] = {"Idle", "Walk", "Ascend", "Fall"};
                     ImGui::Combo("Animation", &selectedAnim, animTypes, IM_ARRAYSIZE(animTypes));
-                    switch (selectedAnim)
-                    {
-                    case 0:
-                        animFrames = &asset->idle;
-                        break;
-                    case 1:
-                        animFrames = &asset->walk;
-                        break;
-                    case 2:
-                        animFrames = &asset->ascend;
-                        break;
-                    case 3:
-                        animFrames = &asset->fall;
-                        break;
-                    }
-                    if (animFrames)
-                    {
-                        if (ImGui::InputInt("Frame Count", &animFrames->frameCount))
-                        {
-                            if (animFrames->frames)
-                                animFrames->frames = (Rectangle *)arena_realloc(&assetArena, animFrames->frames, sizeof(Rectangle) * animFrames->frameCount);
-                            else
-                                animFrames->frames = (Rectangle *)arena_alloc(&assetArena, sizeof(Rectangle) * animFrames->frameCount);
-                        }
-                        ImGui::InputFloat("Frame Time", &animFrames->frameTime);
-                        if (animFrames->frameCount > 0 && animFrames->frames != NULL)
-                        {
-                            ImGui::Text("x y width height");
-                            for (int i = 0; i < animFrames->frameCount; i++)
-                            {
-                                ImGui::PushID(i);
-                                char label[16];
-                                sprintf(label, "Frame: %d", i);
-                                ImGui::InputFloat4(label, (float *)&animFrames->frames[i]);
-                                ImGui::PopID();
-                            }
-                        }
-                    }
+                    EditAnimationClip(&asset->clips[selectedAnim]);
                 }
                 ImGui::EndChild();
             }
@@ -665,6 +664,53 @@ static void DrawEntityInspectorPanel()
     }
 }
 
+static void DrawSpawnerPanel()
+{
+    if (!showSpawnerPanel)
+        return;
+    ImGui::SetNextWindowSize(ImVec2(280, 360), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Spawners", &showSpawnerPanel))
+    {
+        for (int i = 0; i < gameState->spawnerCount; i++)
+        {
+            EntitySpawner *sp = &gameState->spawners[i];
+            const char *assetName = IsEntityAssetHandleValid(sp->asset) ? GetEntityAsset(sp->asset)->name : "Missing asset";
+            char label[128];
+            snprintf(label, sizeof(label), "%d: %s (%s)", i, assetName, GetSpawnerModeString(sp->mode));
+            if (ImGui::Selectable(label, selectedSpawnerIndex == i))
+                selectedSpawnerIndex = i;
+        }
+
+        if (selectedSpawnerIndex >= 0 && selectedSpawnerIndex < gameState->spawnerCount)
+        {
+            EntitySpawner *sp = &gameState->spawners[selectedSpawnerIndex];
+            ImGui::Separator();
+            static const char *modeOptions[] = {"Wave", "Timed", "Trigger"};
+            int modeIndex = (int)sp->mode;
+            if (ImGui::Combo("Mode", &modeIndex, modeOptions, IM_ARRAYSIZE(modeOptions)))
+                sp->mode = (SpawnerMode)modeIndex;
+            ImGui::InputFloat2("Position", &sp->position.x);
+            ImGui::InputFloat("Spread", &sp->spread);
+            ImGui::InputFloat("Interval", &sp->interval);
+            ImGui::InputInt("Per Wave", &sp->perWave);
+            ImGui::InputInt("Total (0 = endless)", &sp->total);
+            ImGui::InputInt("Max Alive (0 = any)", &sp->maxAlive);
+            if (sp->mode == SPAWNER_TRIGGER)
+                ImGui::InputFloat("Trigger Radius", &sp->triggerRadius);
+            if (ImGui::Button("Move To Camera"))
+                sp->position = camera.target;
+            ImGui::SameLine();
+            if (ImGui::Button("Delete"))
+            {
+                memmove(sp, sp + 1, sizeof(EntitySpawner) * (gameState->spawnerCount - selectedSpawnerIndex - 1));
+                gameState->spawnerCount--;
+                selectedSpawnerIndex = -1;
+            }
+        }
+    }
+    ImGui::End();
+}
+
 static void DrawNoLevelWindow()
 {
     if (!IsLevelLoaded())
@@ -691,23 +737,36 @@ static void DrawEditorUI()
         return;
     }
     DrawEntityInspectorPanel();
+    DrawSpawnerPanel();
 }
 
 static void DrawEditorWorldspace()
 {
     BeginMode2D(camera);
-    DrawTilemap(&camera);
+    BeginSpriteBatch(GetCameraView(&camera));
+    DrawTilemap(&camera, true);
 
-    Vector2 mousePos = GetMousePosition();
-    Vector2 screenPos = GetScreenToWorld2D(mousePos, camera);
-
-    DrawEntities(0, screenPos, &gameState->player, gameState->enemies,
+    DrawEntities(&gameState->player, gameState->enemies,
                  gameState->enemyCount, &gameState->bossEnemy, 0, true);
 
     Texture2D checkPT2D = LoadTextureWithCache("./res/sprites/checkpoint_ready.png");
 
     // pass the same text and currentIndex of 0 because we're in the editor and only need 1 state
     DrawCheckpoints(checkPT2D, checkPT2D, gameState->checkpoints, gameState->checkpointCount, 0);
+    EndSpriteBatch();
+
+    for (int i = 0; i < gameState->spawnerCount; i++)
+    {
+        EntitySpawner *sp = &gameState->spawners[i];
+        Color color = (i == selectedSpawnerIndex) ? ORANGE : MAROON;
+        float halfSpread = sp->spread * 0.5f;
+        DrawLine((int)(sp->position.x - halfSpread), (int)sp->position.y,
+                 (int)(sp->position.x + halfSpread), (int)sp->position.y, color);
+        DrawCircleLines((int)sp->position.x, (int)sp->position.y, 15, color);
+        DrawText(TextFormat("S%d", i), (int)sp->position.x - 8, (int)sp->position.y - 6, 12, color);
+        if (sp->mode == SPAWNER_TRIGGER)
+            DrawCircleLines((int)sp->position.x, (int)sp->position.y, sp->triggerRadius, Fade(color, 0.5f));
+    }
 
     if (selectedEntityIndex != -1 && selectedEntityIndex != -3)
     {
@@ -832,6 +891,7 @@ void DrawMainMenuBar()
                     entityAssets[entityAssetCount] = newAsset;
                     selectedAssetIndex = entityAssetCount;
                     entityAssetCount++;
+                    UpdateEntityAssetIndex(selectedAssetIndex);
                 }
                 if (ImGui::MenuItem("Load Assets"))
                 {
@@ -839,11 +899,44 @@ void DrawMainMenuBar()
                         TraceLog(LOG_INFO, "Entity assets loaded");
                     else
                         TraceLog(LOG_ERROR, "EDITOR: Failed to load entity assets");
+                    // Reloading gives every slot a new generation; re-resolve the placed entities.
+                    UpdateEntityAssetIndex(0);
+                    gameState->player.asset = FindEntityAssetHandle(gameState->player.assetId);
+                    for (int i = 0; i < gameState->enemyCount; i++)
+                        gameState->enemies[i].asset = FindEntityAssetHandle(gameState->enemies[i].assetId);
+                    gameState->bossEnemy.asset = FindEntityAssetHandle(gameState->bossEnemy.assetId);
+                    for (int i = 0; i < gameState->spawnerCount; i++)
+                        gameState->spawners[i].asset = FindEntityAssetHandle(gameState->spawners[i].assetId);
                 }
                 if (ImGui::MenuItem("Show Asset List"))
                     showAssetList = true;
                 ImGui::EndMenu();
             }
+            if (ImGui::BeginMenu("Spawner"))
+            {
+                if (ImGui::MenuItem("Add Spawner"))
+                {
+                    if (selectedAssetIndex < 0 || entityAssets[selectedAssetIndex].kind != ENTITY_ENEMY)
+                    {
+                        TraceLog(LOG_WARNING, "Select an enemy asset to spawn first!");
+                    }
+                    else
+                    {
+                        EntitySpawner *grown = (EntitySpawner *)arena_realloc(&gameArena, gameState->spawners,
+                                                                              sizeof(EntitySpawner) * (gameState->spawnerCount + 1));
+                        if (grown)
+                        {
+                            gameState->spawners = grown;
+                            grown[gameState->spawnerCount] = MakeEntitySpawner(entityAssets[selectedAssetIndex].id, camera.target);
+                            selectedSpawnerIndex = gameState->spawnerCount++;
+                            showSpawnerPanel = true;
+                        }
+                    }
+                }
+                if (ImGui::MenuItem("Show Spawners"))
+                    showSpawnerPanel = true;
+                ImGui::EndMenu();
+            }
             if (ImGui::BeginMenu("Checkpoint"))
             {
                 if (ImGui::MenuItem("Add Checkpoint"))
@@ -895,6 +988,7 @@ void DrawMainMenuBar()
                     gameState->currentCheckpointIndex = -1;
                     TraceLog(LOG_WARNING, "Failed to load checkpoint in init state.");
                 }
+                ResetSimulation(gameState);
                 gameState->currentState = PLAY;
             }
         }
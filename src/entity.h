@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include "animation.h"
+#include "behavior.h"
 
 // Physics types for entities.
 typedef enum PhysicsType
@@ -24,6 +25,7 @@ typedef enum EntityState
     ENTITY_STATE_WALK,
     ENTITY_STATE_ASCEND,
     ENTITY_STATE_FALL,
+    ENTITY_STATE_COUNT
 } EntityState;
 
 // Kinds of entities.
@@ -47,16 +49,28 @@ typedef struct EntityAsset
     float baseAttackSpeed;
     char texturePath[128];
     Texture2D texture;
-    // Animation frame definitions.
-    AnimationFrames idle;
-    AnimationFrames walk;
-    AnimationFrames ascend;
-    AnimationFrames fall;
+    // Clip library index played in each EntityState (0 for none).
+    int clips[ENTITY_STATE_COUNT];
+    // Enemy state machine; empty for players.
+    EntityBehavior behavior;
 } EntityAsset;
 
+// Upper bound on loaded entity assets; slots past it get no handle.
+#define MAX_ENTITY_ASSETS 1024
+
+// Reference to a slot of entityAssets. The generation changes whenever the
+// slot is (re)loaded, so handles to an old asset stop resolving instead of
+// pointing at whatever took its place. The zero handle is never valid.
+typedef struct EntityAssetHandle
+{
+    uint16_t index;
+    uint16_t generation;
+} EntityAssetHandle;
+
 typedef struct Entity
 {
-    uint64_t assetId;
+    uint64_t assetId;          // Persistent reference, as saved in level files.
+    EntityAssetHandle asset;   // Resolved from assetId at load.
     EntityKind kind;
     PhysicsType physicsType;
     float radius;
@@ -71,16 +85,23 @@ typedef struct Entity
     int direction; // 1 for right, -1 for left.
     float shootCooldown;
     EntityState state;
-
-    Animation idle;
-    Animation walk;
-    Animation ascend;
-    Animation fall;
+    AnimationComponent anim;
 } Entity;
 
 const char *GetEntityKindString(EntityKind kind);
 char *EntityAssetToJSON(const EntityAsset *asset);
 bool EntityAssetFromJSON(const char *json, EntityAsset *asset);
-EntityAsset *GetEntityAssetById(uint64_t id);
+
+// Refresh the id lookup after entityAssets changed: slots from firstChanged
+// on get a new generation, invalidating handles to what was there before.
+void UpdateEntityAssetIndex(int firstChanged);
+// Load/save-time lookup through the id hash map; invalid handle if unknown.
+EntityAssetHandle FindEntityAssetHandle(uint64_t id);
+EntityAssetHandle GetEntityAssetHandle(int slot);
+bool IsEntityAssetHandleValid(EntityAssetHandle handle);
+// Never NULL: stale or invalid handles resolve to a placeholder asset.
+EntityAsset *GetEntityAsset(EntityAssetHandle handle);
+// The asset's clip for an entity state; the empty clip for an unknown state.
+int GetEntityClip(const EntityAsset *asset, EntityState state);
 
 #endif
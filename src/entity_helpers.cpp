@@ -17,34 +17,108 @@ const char *GetEntityKindString(EntityKind kind)
     }
 }
 
-EntityAsset *GetEntityAssetById(uint64_t id)
+// Open-addressed id -> slot + 1 map, twice the slot limit so probes stay short.
+#define ENTITY_ASSET_MAP_SIZE (MAX_ENTITY_ASSETS * 2)
+
+static uint16_t entityAssetGenerations[MAX_ENTITY_ASSETS];
+static uint16_t entityAssetMap[ENTITY_ASSET_MAP_SIZE];
+// What stale handles resolve to; baseHp 1 keeps health ratios finite.
+static EntityAsset missingEntityAsset = {0, "Missing", EMPTY, PHYS_NONE, 0.0f, 1};
+
+static uint32_t HashEntityAssetId(uint64_t id)
+{
+    return (uint32_t)((id * 0x9E3779B97F4A7C15ull) >> 40) & (ENTITY_ASSET_MAP_SIZE - 1);
+}
+
+void UpdateEntityAssetIndex(int firstChanged)
 {
-    for (int i = 0; i < entityAssetCount; i++)
+    int slotCount = entityAssetCount;
+    if (slotCount > MAX_ENTITY_ASSETS)
     {
-        if (entityAssets[i].id == id)
-            return &entityAssets[i];
+        TraceLog(LOG_WARNING, "Only the first %d of %d entity assets can be referenced!", MAX_ENTITY_ASSETS, slotCount);
+        slotCount = MAX_ENTITY_ASSETS;
     }
-    return NULL;
+    for (int i = (firstChanged > 0 ? firstChanged : 0); i < slotCount; i++)
+    {
+        if (++entityAssetGenerations[i] == 0)
+            entityAssetGenerations[i] = 1;
+    }
+
+    memset(entityAssetMap, 0, sizeof(entityAssetMap));
+    for (int i = 0; i < slotCount; i++)
+    {
+        uint32_t bucket = HashEntityAssetId(entityAssets[i].id);
+        while (entityAssetMap[bucket] != 0)
+        {
+            if (entityAssets[entityAssetMap[bucket] - 1].id == entityAssets[i].id)
+            {
+                TraceLog(LOG_WARNING, "Entity assets %s and %s share id %llu!", entityAssets[entityAssetMap[bucket] - 1].name,
+                         entityAssets[i].name, (unsigned long long)entityAssets[i].id);
+                break;
+            }
+            bucket = (bucket + 1) & (ENTITY_ASSET_MAP_SIZE - 1);
+        }
+        if (entityAssetMap[bucket] == 0)
+            entityAssetMap[bucket] = (uint16_t)(i + 1);
+    }
+}
+
+EntityAssetHandle FindEntityAssetHandle(uint64_t id)
+{
+    uint32_t bucket = HashEntityAssetId(id);
+    while (entityAssetMap[bucket] != 0)
+    {
+        int slot = entityAssetMap[bucket] - 1;
+        if (slot < entityAssetCount && entityAssets[slot].id == id)
+            return GetEntityAssetHandle(slot);
+        bucket = (bucket + 1) & (ENTITY_ASSET_MAP_SIZE - 1);
+    }
+    return (EntityAssetHandle){0, 0};
+}
+
+EntityAssetHandle GetEntityAssetHandle(int slot)
+{
+    if (slot < 0 || slot >= entityAssetCount || slot >= MAX_ENTITY_ASSETS)
+        return (EntityAssetHandle){0, 0};
+    return (EntityAssetHandle){(uint16_t)slot, entityAssetGenerations[slot]};
+}
+
+bool IsEntityAssetHandleValid(EntityAssetHandle handle)
+{
+    return handle.generation != 0 && handle.index < entityAssetCount && handle.index < MAX_ENTITY_ASSETS &&
+           entityAssetGenerations[handle.index] == handle.generation;
+}
+
+EntityAsset *GetEntityAsset(EntityAssetHandle handle)
+{
+    return IsEntityAssetHandleValid(handle) ? &entityAssets[handle.index] : &missingEntityAsset;
+}
+
+int GetEntityClip(const EntityAsset *asset, EntityState state)
+{
+    return (state >= 0 && state < ENTITY_STATE_COUNT) ? asset->clips[state] : 0;
 }
 
 // Append an animation's frame data into the buffer.
-static void AppendAnimationFrames(char **buffer, size_t *bufSize, const char *animName, const AnimationFrames *anim)
+static void AppendAnimationClip(char **buffer, size_t *bufSize, const char *animName, int clipIndex)
 {
+    const AnimationClip *clip = GetAnimationClip(clipIndex);
+    const Rectangle *frames = GetAnimationClipFrames(clip);
     char temp[1024];
     snprintf(temp, sizeof(temp),
              "    \"%s\": {\n"
              "      \"frameCount\": %d,\n"
              "      \"frameTime\": %.2f,\n"
              "      \"frames\": [\n",
-             animName, anim->frameCount, anim->frameTime);
+             animName, clip->frameCount, clip->frameTime);
     strncat(*buffer, temp, *bufSize - strlen(*buffer) - 1);
 
-    for (int i = 0; i < anim->frameCount; i++)
+    for (int i = 0; i < clip->frameCount; i++)
     {
-        Rectangle r = anim->frames[i];
+        Rectangle r = frames[i];
         snprintf(temp, sizeof(temp),
                  "        {\"x\": %.2f, \"y\": %.2f, \"width\": %.2f, \"height\": %.2f}%s\n",
-                 r.x, r.y, r.width, r.height, (i < anim->frameCount - 1) ? "," : "");
+                 r.x, r.y, r.width, r.height, (i < clip->frameCount - 1) ? "," : "");
         strncat(*buffer, temp, *bufSize - strlen(*buffer) - 1);
     }
 
@@ -54,7 +128,9 @@ static void AppendAnimationFrames(char **buffer, size_t *bufSize, const char *an
     strncat(*buffer, temp, *bufSize - strlen(*buffer) - 1);
 }
 
-static int ParseAnimation(const char *json, const char *animName, AnimationFrames *anim)
+// Parse an animation's frames and intern them in the clip library. Returns
+// the clip, or 0 (the empty clip) when it is missing or malformed.
+static int ParseAnimation(const char *json, const char *animName)
 {
     const char *pos = strstr(json, animName);
     if (!pos)
@@ -89,9 +165,6 @@ static int ParseAnimation(const char *json, const char *animName, AnimationFrame
         return 0;
     }
 
-    anim->frameCount = frameCount;
-    anim->frameTime = frameTime;
-
     const char *framesPos = strstr(pos, "\"frames\"");
     if (!framesPos)
     {
@@ -103,12 +176,16 @@ static int ParseAnimation(const char *json, const char *animName, AnimationFrame
         return 0;
     framesPos++; // Skip '['
 
-    anim->frames = (Rectangle *)arena_alloc(&assetArena, sizeof(Rectangle) * frameCount);
-    if (!anim->frames)
+    if (frameCount <= 0)
+        return 0;
+    Rectangle *frames = (Rectangle *)arena_alloc(&assetArena, sizeof(Rectangle) * frameCount);
+    if (!frames)
     {
         TraceLog(LOG_ERROR, "Memory allocation failed for animation '%s'.", animName);
         return 0;
     }
+    // Frames the file cuts short stay zero, so they hash the same every load.
+    memset(frames, 0, sizeof(Rectangle) * frameCount);
 
     for (int i = 0; i < frameCount; i++)
     {
@@ -118,22 +195,17 @@ static int ParseAnimation(const char *json, const char *animName, AnimationFrame
         if (*framesPos != '{')
         {
             TraceLog(LOG_WARNING, "Expected '{' at frame %d for animation '%s'.", i, animName);
-            free(anim->frames);
-            anim->frames = NULL;
+            arena_free(&assetArena, frames);
             return 0;
         }
         if (sscanf(framesPos, " { \"x\" : %f , \"y\" : %f , \"width\" : %f , \"height\" : %f }",
                    &x, &y, &w, &h) != 4)
         {
             TraceLog(LOG_WARNING, "Failed to parse frame %d for animation '%s'.", i, animName);
-            free(anim->frames);
-            anim->frames = NULL;
+            arena_free(&assetArena, frames);
             return 0;
         }
-        anim->frames[i].x = x;
-        anim->frames[i].y = y;
-        anim->frames[i].width = w;
-        anim->frames[i].height = h;
+        frames[i] = (Rectangle){x, y, w, h};
         framesPos = strchr(framesPos, '}');
         if (!framesPos)
             break;
@@ -141,12 +213,15 @@ static int ParseAnimation(const char *json, const char *animName, AnimationFrame
         while (*framesPos == ',' || *framesPos == ' ' || *framesPos == '\n' || *framesPos == '\r')
             framesPos++;
     }
-    return 1;
+
+    int clip = InternAnimationClip(frames, frameCount, frameTime);
+    arena_free(&assetArena, frames);
+    return clip;
 }
 
 char *EntityAssetToJSON(const EntityAsset *asset)
 {
-    size_t bufSize = 8192;
+    size_t bufSize = 16384;
     char *json = (char *)arena_alloc(&assetArena, bufSize);
     if (!json)
         return NULL;
@@ -176,15 +251,24 @@ char *EntityAssetToJSON(const EntityAsset *asset)
     strncat(json, temp, bufSize - strlen(json) - 1);
 
     strncat(json, "  \"animations\": {\n", bufSize - strlen(json) - 1);
-    AppendAnimationFrames(&json, &bufSize, "idle", &asset->idle);
+    AppendAnimationClip(&json, &bufSize, "idle", asset->clips[ENTITY_STATE_IDLE]);
     strncat(json, ",\n", bufSize - strlen(json) - 1);
-    AppendAnimationFrames(&json, &bufSize, "walk", &asset->walk);
+    AppendAnimationClip(&json, &bufSize, "walk", asset->clips[ENTITY_STATE_WALK]);
     strncat(json, ",\n", bufSize - strlen(json) - 1);
-    AppendAnimationFrames(&json, &bufSize, "ascend", &asset->ascend);
+    AppendAnimationClip(&json, &bufSize, "ascend", asset->clips[ENTITY_STATE_ASCEND]);
     strncat(json, ",\n", bufSize - strlen(json) - 1);
-    AppendAnimationFrames(&json, &bufSize, "fall", &asset->fall);
-    strncat(json, "\n  }\n", bufSize - strlen(json) - 1);
-    strncat(json, "}\n", bufSize - strlen(json) - 1);
+    AppendAnimationClip(&json, &bufSize, "fall", asset->clips[ENTITY_STATE_FALL]);
+    if (asset->behavior.stateCount > 0)
+    {
+        strncat(json, "\n  },\n", bufSize - strlen(json) - 1);
+        AppendEntityBehaviorJSON(json, bufSize, &asset->behavior);
+        strncat(json, "\n}\n", bufSize - strlen(json) - 1);
+    }
+    else
+    {
+        strncat(json, "\n  }\n", bufSize - strlen(json) - 1);
+        strncat(json, "}\n", bufSize - strlen(json) - 1);
+    }
 
     return json;
 }
@@ -237,9 +321,13 @@ bool EntityAssetFromJSON(const char *json, EntityAsset *asset)
         asset->texture = (Texture2D){0};
     }
 
-    ParseAnimation(json, "idle", &asset->idle);
-    ParseAnimation(json, "walk", &asset->walk);
-    ParseAnimation(json, "ascend", &asset->ascend);
-    ParseAnimation(json, "fall", &asset->fall);
+    asset->clips[ENTITY_STATE_IDLE] = ParseAnimation(json, "idle");
+    asset->clips[ENTITY_STATE_WALK] = ParseAnimation(json, "walk");
+    asset->clips[ENTITY_STATE_ASCEND] = ParseAnimation(json, "ascend");
+    asset->clips[ENTITY_STATE_FALL] = ParseAnimation(json, "fall");
+
+    // Assets written before behaviors existed (or with a broken one) get the built-in behavior for their kind.
+    if (!CompileEntityBehavior(json, asset->name, &asset->behavior))
+        GetDefaultEntityBehavior(asset->kind, asset->name, &asset->behavior);
     return true;
 }
@@ -0,0 +1,192 @@
+#include <string.h>
+#include "entity_store.h"
+#include "memory_arena.h"
+
+// Arrays inside an archetype block start on 8-byte boundaries.
+#define ARRAY_BYTES(type, n) ((sizeof(type) * (n) + 7) & ~(size_t)7)
+
+static size_t ArchetypeBlockSize(int capacity)
+{
+    return ARRAY_BYTES(int, capacity) * 2 + ARRAY_BYTES(EntityAssetHandle, capacity) +
+           ARRAY_BYTES(Vector2, capacity) * 3 + ARRAY_BYTES(PhysicsComponent, capacity) +
+           ARRAY_BYTES(CombatComponent, capacity) + ARRAY_BYTES(BrainComponent, capacity) +
+           ARRAY_BYTES(AnimationComponent, capacity) + ARRAY_BYTES(BulletEmitter, capacity) +
+           ARRAY_BYTES(int, capacity);
+}
+
+// Point each component array of arch at its slice of block.
+static void CarveArchetypeBlock(EntityArchetype *arch, unsigned char *block, int capacity)
+{
+    arch->source = (int *)block;
+    block += ARRAY_BYTES(int, capacity);
+    arch->spawner = (int *)block;
+    block += ARRAY_BYTES(int, capacity);
+    arch->asset = (EntityAssetHandle *)block;
+    block += ARRAY_BYTES(EntityAssetHandle, capacity);
+    arch->position = (Vector2 *)block;
+    block += ARRAY_BYTES(Vector2, capacity);
+    arch->basePos = (Vector2 *)block;
+    block += ARRAY_BYTES(Vector2, capacity);
+    arch->velocity = (Vector2 *)block;
+    block += ARRAY_BYTES(Vector2, capacity);
+    arch->physics = (PhysicsComponent *)block;
+    block += ARRAY_BYTES(PhysicsComponent, capacity);
+    arch->combat = (CombatComponent *)block;
+    block += ARRAY_BYTES(CombatComponent, capacity);
+    arch->brain = (BrainComponent *)block;
+    block += ARRAY_BYTES(BrainComponent, capacity);
+    arch->anim = (AnimationComponent *)block;
+    block += ARRAY_BYTES(AnimationComponent, capacity);
+    arch->emitter = (BulletEmitter *)block;
+    block += ARRAY_BYTES(BulletEmitter, capacity);
+    arch->live = (int *)block;
+}
+
+// Double the archetype's capacity, moving its rows into one new block.
+static bool GrowEntityArchetype(EntityArchetype *arch)
+{
+    int newCapacity = (arch->capacity > 0) ? arch->capacity * 2 : ENTITY_ARCHETYPE_INITIAL_CAPACITY;
+    unsigned char *block = (unsigned char *)arena_alloc(&gameArena, ArchetypeBlockSize(newCapacity));
+    if (!block)
+    {
+        TraceLog(LOG_ERROR, "Failed to grow entity archetype to %d rows!", newCapacity);
+        return false;
+    }
+
+    EntityArchetype grown = *arch;
+    CarveArchetypeBlock(&grown, block, newCapacity);
+    if (arch->source)
+    {
+        int n = arch->count;
+        memcpy(grown.source, arch->source, sizeof(int) * n);
+        memcpy(grown.spawner, arch->spawner, sizeof(int) * n);
+        memcpy(grown.asset, arch->asset, sizeof(EntityAssetHandle) * n);
+        memcpy(grown.position, arch->position, sizeof(Vector2) * n);
+        memcpy(grown.basePos, arch->basePos, sizeof(Vector2) * n);
+        memcpy(grown.velocity, arch->velocity, sizeof(Vector2) * n);
+        memcpy(grown.physics, arch->physics, sizeof(PhysicsComponent) * n);
+        memcpy(grown.combat, arch->combat, sizeof(CombatComponent) * n);
+        memcpy(grown.brain, arch->brain, sizeof(BrainComponent) * n);
+        memcpy(grown.anim, arch->anim, sizeof(AnimationComponent) * n);
+        memcpy(grown.emitter, arch->emitter, sizeof(BulletEmitter) * n);
+        arena_free(&gameArena, arch->source);
+    }
+    grown.capacity = newCapacity;
+    grown.liveCount = 0;
+    *arch = grown;
+    return true;
+}
+
+void ResetEntityStore(EntityStore *store)
+{
+    for (int i = 0; i < ARCHETYPE_COUNT; i++)
+    {
+        store->archetypes[i].count = 0;
+        store->archetypes[i].liveCount = 0;
+    }
+}
+
+void FreeEntityStore(EntityStore *store)
+{
+    for (int i = 0; i < ARCHETYPE_COUNT; i++)
+    {
+        // Every array shares the block that starts at source.
+        if (store->archetypes[i].source)
+            arena_free(&gameArena, store->archetypes[i].source);
+        memset(&store->archetypes[i], 0, sizeof(EntityArchetype));
+    }
+}
+
+int AddEntityRow(EntityArchetype *arch, const Entity *e, int source)
+{
+    if (arch->count >= arch->capacity && !GrowEntityArchetype(arch))
+        return -1;
+
+    int row = arch->count++;
+    arch->source[row] = source;
+    arch->spawner[row] = -1;
+    arch->asset[row] = e->asset;
+    arch->position[row] = e->position;
+    arch->basePos[row] = e->basePos;
+    arch->velocity[row] = e->velocity;
+
+    PhysicsComponent *body = &arch->physics[row];
+    body->type = e->physicsType;
+    body->state = e->state;
+    body->radius = e->radius;
+    body->direction = e->direction;
+    body->leftBound = e->leftBound;
+    body->rightBound = e->rightBound;
+
+    CombatComponent *combat = &arch->combat[row];
+    combat->health = e->health;
+    combat->maxHealth = e->health;
+    combat->speed = e->speed;
+    combat->shootTimer = e->shootTimer;
+    combat->shootCooldown = e->shootCooldown;
+
+    memset(&arch->brain[row], 0, sizeof(BrainComponent));
+    memset(&arch->emitter[row], 0, sizeof(BulletEmitter));
+    arch->anim[row] = e->anim;
+    return row;
+}
+
+int RemoveDeadRows(EntityArchetype *arch)
+{
+    int kept = 0;
+    for (int i = 0; i < arch->count; i++)
+    {
+        if (arch->combat[i].health <= 0)
+            continue;
+        if (kept != i)
+        {
+            arch->source[kept] = arch->source[i];
+            arch->spawner[kept] = arch->spawner[i];
+            arch->asset[kept] = arch->asset[i];
+            arch->position[kept] = arch->position[i];
+            arch->basePos[kept] = arch->basePos[i];
+            arch->velocity[kept] = arch->velocity[i];
+            arch->physics[kept] = arch->physics[i];
+            arch->combat[kept] = arch->combat[i];
+            arch->brain[kept] = arch->brain[i];
+            arch->anim[kept] = arch->anim[i];
+            arch->emitter[kept] = arch->emitter[i];
+        }
+        kept++;
+    }
+    int removed = arch->count - kept;
+    arch->count = kept;
+    arch->liveCount = 0;
+    return removed;
+}
+
+void WriteBackEntityRows(const EntityArchetype *arch, Entity *entities)
+{
+    for (int i = 0; i < arch->count; i++)
+    {
+        if (arch->source[i] < 0)
+            continue;
+        Entity *e = &entities[arch->source[i]];
+        e->position = arch->position[i];
+        e->basePos = arch->basePos[i];
+        e->velocity = arch->velocity[i];
+        e->physicsType = arch->physics[i].type;
+        e->state = arch->physics[i].state;
+        e->direction = arch->physics[i].direction;
+        e->health = arch->combat[i].health;
+        e->shootTimer = arch->combat[i].shootTimer;
+        e->anim = arch->anim[i];
+    }
+}
+
+int GatherLiveRows(EntityArchetype *arch)
+{
+    int n = 0;
+    for (int i = 0; i < arch->count; i++)
+    {
+        arch->live[n] = i;
+        n += (arch->combat[i].health > 0) ? 1 : 0;
+    }
+    arch->liveCount = n;
+    return n;
+}
@@ -0,0 +1,103 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include "entity.h"
+#include "bullet_pattern.h"
+
+#define ENTITY_ARCHETYPE_INITIAL_CAPACITY 64
+
+// Entities the simulation runs, grouped by the components they carry. Every
+// row of an archetype has all of its components.
+typedef enum EntityArchetypeType
+{
+    ARCHETYPE_ENEMY = 0,
+    ARCHETYPE_BOSS,
+    ARCHETYPE_COUNT
+} EntityArchetypeType;
+
+// Body the physics step moves; also read by steering and collisions.
+typedef struct PhysicsComponent
+{
+    PhysicsType type;
+    EntityState state;
+    float radius;
+    int direction; // 1 for right, -1 for left.
+    float leftBound;
+    float rightBound;
+} PhysicsComponent;
+
+typedef struct CombatComponent
+{
+    int health;
+    int maxHealth; // Asset base HP, for health transitions.
+    float speed;
+    float shootTimer;
+    float shootCooldown;
+} CombatComponent;
+
+// Latest AI decision and behavior state machine (see ai.h and behavior.h).
+typedef struct BrainComponent
+{
+    const EntityBehavior *behavior;
+    int state;
+    float time;       // Seconds spent in state.
+    bool entered;     // Set on a transition until the state's entry actions ran.
+    bool chasing;     // Player in sight, refreshed by the AI scheduler.
+    int navLink;      // Next navigation link toward the player (ground enemies).
+    float thinkTimer; // Seconds until the next decision is due.
+} BrainComponent;
+
+// Component arrays of one archetype, all indexed by row. Rows keep the order
+// they were added in, which the simulation relies on to stay deterministic;
+// dead rows are squeezed out by RemoveDeadRows, so the arrays double as the
+// slot pool that spawned enemies reuse. The arrays share one block that
+// starts at source.
+typedef struct EntityArchetype
+{
+    int count;
+    int capacity;
+    int *source;  // Index of the authored Entity the row was made from, or -1.
+    int *spawner; // Spawner that made the row, or -1.
+    EntityAssetHandle *asset;
+    Vector2 *position;
+    Vector2 *basePos;
+    Vector2 *velocity;
+    PhysicsComponent *physics;
+    CombatComponent *combat;
+    BrainComponent *brain;
+    AnimationComponent *anim;
+    BulletEmitter *emitter;
+
+    // Rows alive at the start of the current pass; see GatherLiveRows.
+    int *live;
+    int liveCount;
+} EntityArchetype;
+
+// PLAY-time entities. The authored Entity arrays in GameState stay the level
+// and editor representation; ResetSimulation packs them into the store.
+typedef struct EntityStore
+{
+    EntityArchetype archetypes[ARCHETYPE_COUNT];
+} EntityStore;
+
+void ResetEntityStore(EntityStore *store);
+void FreeEntityStore(EntityStore *store);
+
+// Append a row built from an entity (source is its authored index, or -1).
+// Returns the row or -1 when the archetype can't grow.
+int AddEntityRow(EntityArchetype *arch, const Entity *e, int source);
+
+// Drop the rows without health left, keeping the others in order. Returns
+// the number removed.
+int RemoveDeadRows(EntityArchetype *arch);
+
+// Copy the simulated fields of every authored row back to the entity it came
+// from (entities is indexed by source).
+void WriteBackEntityRows(const EntityArchetype *arch, Entity *entities);
+
+// Collect the rows with health left into arch->live, in row order.
+int GatherLiveRows(EntityArchetype *arch);
+
+#endif
@@ -3,17 +3,56 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include "memory_arena.h"
 
 #define MAX_FILE_PATH 256
 
+// Base names of the files in one directory, packed into arena memory.
+typedef struct FileList
+{
+    char *names;  // NUL-terminated names, back to back.
+    int *offsets; // Name i starts at names + offsets[i].
+    int count;
+    int namesSize;
+    int namesCapacity;
+    int offsetsCapacity;
+} FileList;
+
+static inline const char *GetFileListName(const FileList *list, int index)
+{
+    return list->names + list->offsets[index];
+}
+
 // Ensure that a directory exists (create if necessary).
 bool EnsureDirectoryExists(const char *dirPath);
 
-// List files in a directory matching a pattern (e.g., "*.ent").
-// Store their paths in fileList and return the number of files found.
-int ListFilesInDirectory(const char *directory, const char *pattern, char fileList[][MAX_FILE_PATH], int maxFiles);
+// List the files (not subdirectories) directly in directory whose names end
+// in extension, ignoring case, e.g. ".ent". The directory is read in one
+// pass and the names are sorted, so every platform sees the same order.
+// Returns false, with an empty list, when the directory can't be read; free
+// the list with FreeFileList.
+bool ScanDirectory(MemoryArena *arena, const char *directory, const char *extension, FileList *list);
+void FreeFileList(MemoryArena *arena, FileList *list);
+
+// Add a name of length bytes to a list, and put a list back in ScanDirectory
+// order after adding to it.
+bool AppendFileListName(MemoryArena *arena, FileList *list, const char *name, size_t length);
+void SortFileList(FileList *list);
+
+// True if path names a file (not a directory) that exists.
+bool IsRegularFile(const char *path);
+
+// A whole file mapped into memory copy-on-write: the contents can be changed
+// in memory without the file changing. Writing the file from this process
+// while it is mapped is not safe; unmap it first.
+typedef struct MappedFile
+{
+    unsigned char *data;
+    size_t size;
+} MappedFile;
 
-// Count files recursively in sDir that match the specified extension.
-int CountFilesWithExtension(const char *sDir, const char *extension);
+// Returns false, with an empty MappedFile, for missing or empty files.
+bool MapFile(const char *path, MappedFile *file);
+void UnmapFile(MappedFile *file);
 
 #endif
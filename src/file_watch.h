@@ -0,0 +1,29 @@
+#ifndef FILE_WATCH_H
+#define FILE_WATCH_H
+
+#include <stdbool.h>
+#include "file_io.h"
+
+// Change notifications for a set of directories (not their subdirectories).
+// Each platform has its own backend: inotify_file_watch.cpp on Linux,
+// windows_file_watch.cpp on Windows.
+typedef struct DirectoryWatch DirectoryWatch;
+
+// Start watching the directories for files being written, created or renamed
+// into them. Directories that don't exist are skipped; returns NULL when none
+// could be watched.
+DirectoryWatch *OpenDirectoryWatch(const char *const *directories, int count);
+
+// Wait up to timeoutMs (-1 for no limit) for changes and store the paths of
+// the changed files, as "<directory>/<name>", in paths. Returns the number of
+// paths stored, 0 on timeout, or -1 once the watch was woken for closing.
+// A file can be reported more than once.
+int WaitDirectoryChanges(DirectoryWatch *watch, char paths[][MAX_FILE_PATH], int maxPaths, int timeoutMs);
+
+// Make WaitDirectoryChanges return -1 from now on; safe to call from any thread.
+void WakeDirectoryWatch(DirectoryWatch *watch);
+
+// Release the watch. No thread may be waiting on it.
+void CloseDirectoryWatch(DirectoryWatch *watch);
+
+#endif
@@ -0,0 +1,145 @@
+#include "flow_field.h"
+#include "game_rendering.h"
+#include "memory_arena.h"
+#include "tile.h"
+#include <math.h>
+#include <string.h>
+
+void FreeFlowField(FlowField *flow)
+{
+    arena_free(&gameArena, flow->distance);
+    arena_free(&gameArena, flow->queue);
+    arena_free(&gameArena, flow->passable);
+    memset(flow, 0, sizeof(*flow));
+}
+
+void InvalidateFlowField(FlowField *flow)
+{
+    flow->goalX = -1;
+    flow->goalY = -1;
+    flow->passableStale = true;
+}
+
+void UpdateFlowField(FlowField *flow, Vector2 target)
+{
+    if (!mapTiles || currentMapWidth <= 0 || currentMapHeight <= 0)
+        return;
+
+    if (flow->tiles != mapTiles || flow->width != currentMapWidth || flow->height != currentMapHeight)
+    {
+        FreeFlowField(flow);
+        flow->tiles = mapTiles;
+        flow->width = currentMapWidth;
+        flow->height = currentMapHeight;
+        flow->distance = (uint16_t *)arena_alloc(&gameArena, sizeof(uint16_t) * flow->width * flow->height);
+        flow->queue = (int *)arena_alloc(&gameArena, sizeof(int) * flow->width * flow->height);
+        flow->passable = (uint8_t *)arena_alloc(&gameArena, flow->width * flow->height);
+        if (!flow->distance || !flow->queue || !flow->passable)
+        {
+            TraceLog(LOG_ERROR, "FLOW: Failed to allocate a %dx%d flow field!", flow->width, flow->height);
+            FreeFlowField(flow);
+            return;
+        }
+        InvalidateFlowField(flow);
+    }
+
+    int goalX = (int)floorf(target.x / TILE_SIZE);
+    int goalY = (int)floorf(target.y / TILE_SIZE);
+    if (goalX < 0)
+        goalX = 0;
+    if (goalX >= flow->width)
+        goalX = flow->width - 1;
+    if (goalY < 0)
+        goalY = 0;
+    if (goalY >= flow->height)
+        goalY = flow->height - 1;
+    if (goalX == flow->goalX && goalY == flow->goalY)
+        return;
+    flow->goalX = goalX;
+    flow->goalY = goalY;
+    flow->updateCount++;
+
+    if (flow->passableStale)
+    {
+        for (int y = 0; y < flow->height; y++)
+        {
+            for (int x = 0; x < flow->width; x++)
+                flow->passable[y * flow->width + x] = GetTilePhysics(flow->tiles[y][x]) == TILE_PHYS_NONE;
+        }
+        flow->passableStale = false;
+    }
+
+    // Breadth-first over passable cells; every step costs one tile.
+    memset(flow->distance, 0xFF, sizeof(uint16_t) * flow->width * flow->height);
+    int head = 0;
+    int tail = 0;
+    flow->distance[goalY * flow->width + goalX] = 0;
+    flow->queue[tail++] = goalY * flow->width + goalX;
+    while (head < tail)
+    {
+        int cell = flow->queue[head++];
+        int x = cell % flow->width;
+        int y = cell / flow->width;
+        uint16_t next = flow->distance[cell] + 1;
+        if (next == FLOW_UNREACHABLE)
+            continue;
+
+        // Neighbors in the same row must not wrap onto the next one.
+        int neighbors[4] = {(x + 1 < flow->width) ? cell + 1 : -1, (x > 0) ? cell - 1 : -1,
+                            (y + 1 < flow->height) ? cell + flow->width : -1, (y > 0) ? cell - flow->width : -1};
+        for (int i = 0; i < 4; i++)
+        {
+            int neighbor = neighbors[i];
+            if (neighbor < 0 || !flow->passable[neighbor] || flow->distance[neighbor] != FLOW_UNREACHABLE)
+                continue;
+            flow->distance[neighbor] = next;
+            flow->queue[tail++] = neighbor;
+        }
+    }
+}
+
+static int GetFlowCell(const FlowField *flow, int x, int y)
+{
+    if (x < 0 || x >= flow->width || y < 0 || y >= flow->height)
+        return FLOW_UNREACHABLE;
+    return flow->distance[y * flow->width + x];
+}
+
+int GetFlowDistance(const FlowField *flow, Vector2 pos)
+{
+    if (!flow->distance || flow->goalX < 0)
+        return FLOW_UNREACHABLE;
+    return GetFlowCell(flow, (int)floorf(pos.x / TILE_SIZE), (int)floorf(pos.y / TILE_SIZE));
+}
+
+Vector2 GetFlowDirection(const FlowField *flow, Vector2 pos)
+{
+    int x = (int)floorf(pos.x / TILE_SIZE);
+    int y = (int)floorf(pos.y / TILE_SIZE);
+    int best = GetFlowDistance(flow, pos);
+    if (best == FLOW_UNREACHABLE || best == 0)
+        return (Vector2){0, 0};
+
+    // Diagonals only when both cells beside them are open, so paths never cut corners.
+    static const int offsets[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    int bestDx = 0;
+    int bestDy = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        int dx = offsets[i][0];
+        int dy = offsets[i][1];
+        if (dx != 0 && dy != 0 &&
+            (GetFlowCell(flow, x + dx, y) == FLOW_UNREACHABLE || GetFlowCell(flow, x, y + dy) == FLOW_UNREACHABLE))
+            continue;
+        int d = GetFlowCell(flow, x + dx, y + dy);
+        if (d < best)
+        {
+            best = d;
+            bestDx = dx;
+            bestDy = dy;
+        }
+    }
+    if (bestDx != 0 && bestDy != 0)
+        return (Vector2){bestDx * 0.70710678f, bestDy * 0.70710678f};
+    return (Vector2){(float)bestDx, (float)bestDy};
+}
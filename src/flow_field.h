@@ -0,0 +1,39 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <raylib.h>
+#include <stdint.h>
+
+#define FLOW_UNREACHABLE 0xFFFF
+
+// Tile distances to the player's tile over every cell a flying enemy can pass
+// (anything but ground and death tiles). Rebuilt with one breadth-first pass
+// when the player moves to another tile, so steering any number of enemies
+// is a constant-time read.
+typedef struct FlowField
+{
+    unsigned int **tiles; // Tilemap the buffers were sized for.
+    int width;
+    int height;
+    uint16_t *distance;
+    int *queue;
+    uint8_t *passable; // Cached tile physics, refreshed after InvalidateFlowField.
+    bool passableStale;
+    int goalX; // Tile the field flows toward, or -1 when stale.
+    int goalY;
+    int updateCount; // Rebuilds since the field was allocated.
+} FlowField;
+
+// Rebuild the field if the target moved to another tile or the map changed.
+void UpdateFlowField(FlowField *flow, Vector2 target);
+// Force a rebuild on the next update and re-read the tiles (e.g. after the tilemap was edited).
+void InvalidateFlowField(FlowField *flow);
+void FreeFlowField(FlowField *flow);
+
+// Tile distance from pos to the target, or FLOW_UNREACHABLE.
+int GetFlowDistance(const FlowField *flow, Vector2 pos);
+// Unit vector toward the neighboring cell closest to the target, or {0, 0}
+// when pos is unreachable or already in the target's tile.
+Vector2 GetFlowDirection(const FlowField *flow, Vector2 pos);
+
+#endif
@@ -3,40 +3,63 @@
 #include "memory_arena.h"
 #include "game_state.h"
 #include "game_storage.h"
+#include "sprite_batch.h"
 #include <math.h>
 
 unsigned int **mapTiles;
 int currentMapWidth;
 int currentMapHeight;
 
-void DrawAnimation(Animation anim, Vector2 position, float scale, int direction)
+void DrawAnimation(const AnimationClip *clip, int frame, Texture2D texture, Vector2 position, float scale, int direction)
 {
     // Get the current frame and compute source/destination rectangles.
-    Rectangle srcRec = anim.framesData->frames[anim.currentFrame];
+    Rectangle srcRec = GetAnimationClipFrames(clip)[frame % clip->frameCount];
     Rectangle destRec = {
         position.x - (srcRec.width * scale) / 2,
         position.y - (srcRec.height * scale) / 2,
         srcRec.width * scale,
         srcRec.height * scale};
 
-    srcRec.width *= direction;
-    DrawTexturePro(anim.texture, srcRec, destRec, (Vector2){0, 0}, 0.0f, WHITE);
+    PushSprite(SPRITE_LAYER_ENTITIES, texture, srcRec, destRec, WHITE, direction < 0);
 }
 
 unsigned int **InitializeTilemap(int width, int height)
 {
+    if (width <= 0 || height <= 0)
+        return NULL;
     currentMapWidth = width;
     currentMapHeight = height;
     unsigned int **tilemap = (unsigned int **)arena_alloc(&gameArena, height * sizeof(unsigned int *));
+    if (!tilemap)
+        return NULL;
     for (int i = 0; i < height; i++)
     {
         tilemap[i] = (unsigned int *)arena_alloc(&gameArena, width * sizeof(unsigned int));
+        if (!tilemap[i])
+        {
+            while (i-- > 0)
+                arena_free(&gameArena, tilemap[i]);
+            arena_free(&gameArena, tilemap);
+            return NULL;
+        }
         memset(tilemap[i], 0, width * sizeof(int));
     }
     return tilemap;
 }
 
-void DrawTilemap(Camera2D *cam)
+unsigned int **WrapTilemap(unsigned int *tiles, int width, int height)
+{
+    unsigned int **tilemap = (unsigned int **)arena_alloc(&gameArena, height * sizeof(unsigned int *));
+    if (!tilemap)
+        return NULL;
+    currentMapWidth = width;
+    currentMapHeight = height;
+    for (int i = 0; i < height; i++)
+        tilemap[i] = tiles + (size_t)i * width;
+    return tilemap;
+}
+
+void DrawTilemap(Camera2D *cam, bool showGrid)
 {
     // Compute camera bounds in world space.
     float mapPixelWidth = currentMapWidth * TILE_SIZE;
@@ -72,8 +95,8 @@ void DrawTilemap(Camera2D *cam)
             if (tileId != 0)
             {
                 unsigned short tsId = (tileId >> 20) & 0xFFF;
-                unsigned short tilePhys = (tileId >> 16) & 0xF;
-                unsigned short tileIndex = (tileId & 0xFFFF) - 1;
+                unsigned short tileIndex = (tileId & (TILE_FOREGROUND_FLAG - 1)) - 1;
+                SpriteLayer layer = (tileId & TILE_FOREGROUND_FLAG) ? SPRITE_LAYER_FOREGROUND : SPRITE_LAYER_TILES;
 
                 Tileset *ts = NULL;
                 for (int i = 0; i < tilesetCount; i++)
@@ -100,10 +123,10 @@ void DrawTilemap(Camera2D *cam)
                         (float)(y * TILE_SIZE), 
                         (float)TILE_SIZE, 
                         (float)TILE_SIZE};
-                    DrawTexturePro(ts->texture, srcRec, destRec, (Vector2){0, 0}, 0.0f, WHITE);
+                    PushSprite(layer, ts->texture, srcRec, destRec, WHITE, false);
                 }
             }
-            else if (gameState->currentState == EDITOR)
+            else if (showGrid)
             {
                 DrawRectangleLines(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE, LIGHTGRAY);
             }
@@ -111,58 +134,36 @@ void DrawTilemap(Camera2D *cam)
     }
 }
 
-// Helper: Update and draw an entity's animation if valid.
-static void DrawEntityAnimationIfValid(Entity *e, float deltaTime)
+// Helper: Draw the current frame of an entity's state animation if its asset has one.
+// Animations are advanced by UpdateEntityAnimations, not here.
+static void DrawEntityAnimationIfValid(const AnimationComponent *anim, EntityAssetHandle handle, EntityState state,
+                                       Vector2 position, float radius, int direction)
 {
-    // Select the correct animation based on the entity state.
-    Animation *anim = NULL;
-    switch (e->state)
-    {
-        case ENTITY_STATE_IDLE:   anim = &e->idle;   break;
-        case ENTITY_STATE_WALK:   anim = &e->walk;   break;
-        case ENTITY_STATE_ASCEND: anim = &e->ascend; break;
-        case ENTITY_STATE_FALL:   anim = &e->fall;   break;
-        default: break;
-    }
+    EntityAsset *asset = GetEntityAsset(handle);
+    const AnimationClip *clip = GetAnimationClip(GetEntityClip(asset, state));
 
-    // Only update and draw if the animation is valid.
-    if (anim != NULL &&
-        anim->framesData != NULL &&
-        anim->framesData->frameCount > 0)
+    // Only draw if the animation is valid.
+    if (clip->frameCount > 0)
     {
-        UpdateAnimation(anim, deltaTime);
-        float scale = (e->radius * 2) / anim->framesData->frames[0].height;
-        DrawAnimation(*anim, e->position, scale, e->direction);
+        float scale = (radius * 2) / GetAnimationClipFrames(clip)[0].height;
+        DrawAnimation(clip, anim->frame, asset->texture, position, scale, direction);
     }
 }
 
+static void DrawEntityIfValid(Entity *e)
+{
+    DrawEntityAnimationIfValid(&e->anim, e->asset, e->state, e->position, e->radius, e->direction);
+}
 
-void DrawEntities(float deltaTime, Vector2 mouseScreenPos, Entity *player, Entity *enemies, int enemyCount,
+void DrawEntities(Entity *player, Entity *enemies, int enemyCount,
                   Entity *boss, int *bossMeleeFlash, bool bossActive)
 {
     // Draw Player
     if (player != NULL && player->health > 0)
     {
-        EntityAsset *asset = GetEntityAssetById(player->assetId);
-        if (asset)
+        if (IsEntityAssetHandleValid(player->asset))
         {
-            DrawEntityAnimationIfValid(player, deltaTime);
-
-            if (gameState->currentState == PLAY)
-            {
-                // Compute normalized aim direction.
-                Vector2 aimDir = {mouseScreenPos.x - player->position.x, mouseScreenPos.y - player->position.y};
-                float len = sqrtf(aimDir.x * aimDir.x + aimDir.y * aimDir.y);
-                if (len != 0)
-                {
-                    aimDir.x /= len;
-                    aimDir.y /= len;
-                }
-
-                Vector2 aimEnd = {player->position.x + aimDir.x * CROSSHAIR_DISTANCE,
-                                  player->position.y + aimDir.y * CROSSHAIR_DISTANCE};
-                DrawLineV(player->position, aimEnd, GRAY);
-            }
+            DrawEntityIfValid(player);
         }
         else
         {
@@ -176,10 +177,9 @@ void DrawEntities(float deltaTime, Vector2 mouseScreenPos, Entity *player, Entit
         Entity *e = &enemies[i];
         if (e->health <= 0)
             continue;
-        EntityAsset *asset = GetEntityAssetById(e->assetId);
-        if (asset)
+        if (IsEntityAssetHandleValid(e->asset))
         {
-            DrawEntityAnimationIfValid(e, deltaTime);
+            DrawEntityIfValid(e);
         }
         else
         {
@@ -190,10 +190,9 @@ void DrawEntities(float deltaTime, Vector2 mouseScreenPos, Entity *player, Entit
     // Draw Boss
     if (boss && bossActive && boss->health > 0)
     {
-        EntityAsset *asset = GetEntityAssetById(boss->assetId);
-        if (asset)
+        if (IsEntityAssetHandleValid(boss->asset))
         {
-            DrawEntityAnimationIfValid(boss, deltaTime);
+            DrawEntityIfValid(boss);
         }
         else
         {
@@ -202,6 +201,35 @@ void DrawEntities(float deltaTime, Vector2 mouseScreenPos, Entity *player, Entit
     }
 }
 
+void DrawPlayerAim(Vector2 mouseScreenPos, const Entity *player)
+{
+    if (player == NULL || player->health <= 0)
+        return;
+
+    // Compute normalized aim direction.
+    Vector2 aimDir = {mouseScreenPos.x - player->position.x, mouseScreenPos.y - player->position.y};
+    float len = sqrtf(aimDir.x * aimDir.x + aimDir.y * aimDir.y);
+    if (len != 0)
+    {
+        aimDir.x /= len;
+        aimDir.y /= len;
+    }
+
+    Vector2 aimEnd = {player->position.x + aimDir.x * CROSSHAIR_DISTANCE,
+                      player->position.y + aimDir.y * CROSSHAIR_DISTANCE};
+    DrawLineV(player->position, aimEnd, GRAY);
+}
+
+void DrawRenderEntities(const RenderEntity *entities, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const RenderEntity *e = &entities[i];
+        if (IsEntityAssetHandleValid(e->asset))
+            DrawEntityAnimationIfValid(&e->anim, e->asset, e->state, e->position, e->radius, e->direction);
+    }
+}
+
 void DrawCheckpoints(Texture2D checkpointReady, Texture2D checkpointActivated, Vector2 *checkpoints, int checkpointCount, int currentIndex)
 {
     for (int i = 0; i < checkpointCount; i++)
@@ -212,50 +240,13 @@ void DrawCheckpoints(Texture2D checkpointReady, Texture2D checkpointActivated, V
             (float)checkpointReady.height};
 
         Rectangle destRec = {
-            gameState->checkpoints[i].x,
-            gameState->checkpoints[i].y,
+            checkpoints[i].x,
+            checkpoints[i].y,
             (float)TILE_SIZE,
             (float)(TILE_SIZE * 2)};
 
         bool activated = currentIndex >= i;
         Texture2D tx = activated ? checkpointActivated : checkpointReady;
-        DrawTexturePro(
-            tx,
-            srcRec,
-            destRec,
-            (Vector2){0, 0},
-            0.0f,
-            WHITE);
-    }
-}
-
-static void InitParticle(Particle *p)
-{
-    if (!p)
-        return;
-    p->position = (Vector2){(float)GetRandomValue(0, SCREEN_WIDTH),
-                            (float)GetRandomValue(0, SCREEN_HEIGHT / 2)};
-    float angle = (float)GetRandomValue(0, 360) * DEG2RAD;
-    float speed = (float)GetRandomValue(1, 5);
-    p->velocity = (Vector2){cosf(angle) * speed, sinf(angle) * speed};
-    p->life = (float)GetRandomValue(60, 180);
-    p->color = (Color){(unsigned char)GetRandomValue(100, 255),
-                       (unsigned char)GetRandomValue(100, 255),
-                       (unsigned char)GetRandomValue(100, 255),
-                       255};
-}
-
-void UpdateAndDrawFireworks(void)
-{
-    for (int i = 0; i < MAX_PARTICLES; i++)
-    {
-        Particle *pt = &particles[i];
-        pt->position.x += pt->velocity.x;
-        pt->position.y += pt->velocity.y;
-        pt->life -= 1.0f;
-        if (pt->life <= 0)
-            InitParticle(pt);
-        pt->color.a = (unsigned char)(255.0f * (pt->life / 180.0f)); // Fade based on remaining life.
-        DrawCircleV(pt->position, 2, pt->color);
+        PushSprite(SPRITE_LAYER_PROPS, tx, srcRec, destRec, WHITE, false);
     }
 }
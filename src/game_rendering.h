@@ -3,42 +3,45 @@
 
 #include <raylib.h>
 #include "entity.h"
+#include "entity_store.h"
+#include "render_snapshot.h"
 
 #define SCREEN_WIDTH 1280
 #define SCREEN_HEIGHT 720
 #define TILE_SIZE 50
-#define MAX_PARTICLES 200
 #define CROSSHAIR_DISTANCE 50
 
-// Particle system for fireworks.
-typedef struct Particle
-{
-    Vector2 position;
-    Vector2 velocity;
-    float life; // Frames remaining.
-    Color color;
-} Particle;
-static Particle particles[MAX_PARTICLES];
-
 extern unsigned int **mapTiles;
 extern int currentMapWidth;
 extern int currentMapHeight;
 
-// Initialize the tilemap with the given width and height.
+// Initialize the tilemap with the given width and height. Returns NULL when
+// the size isn't positive or the game arena can't hold it.
 unsigned int **InitializeTilemap(int width, int height);
 
-// Draw the tilemap using the specified camera.
-void DrawTilemap(Camera2D *cam);
+// Make a tilemap whose rows point into an existing row-major array of
+// width * height tiles (such as a mapped level file) instead of copying it.
+unsigned int **WrapTilemap(unsigned int *tiles, int width, int height);
+
+// World drawing below submits sprites to the sprite batch (see sprite_batch.h),
+// so it must run between BeginSpriteBatch and EndSpriteBatch; nothing appears
+// until the batch ends.
+
+// Draw the tilemap using the specified camera, outlining empty tiles when showGrid is set.
+void DrawTilemap(Camera2D *cam, bool showGrid);
 
 // Draw game entities (player, enemies, boss) with the given parameters.
-void DrawEntities(float deltaTime, Vector2 mouseScreenPos, Entity *player,
-                  Entity *enemies, int enemyCount, Entity *boss,
+void DrawEntities(Entity *player, Entity *enemies, int enemyCount, Entity *boss,
                   int *bossMeleeFlash, bool bossActive);
 
-// Draw an animated sprite at the specified position.
-void DrawAnimation(Animation anim, Vector2 position, float scale, int direction);
+// Draw the entities of a render snapshot.
+void DrawRenderEntities(const RenderEntity *entities, int count);
+
+// Draw one frame of an animation at the specified position.
+void DrawAnimation(const AnimationClip *clip, int frame, Texture2D texture, Vector2 position, float scale, int direction);
 void DrawCheckpoints(Texture2D checkpointReady, Texture2D checkpointActivated, Vector2 *checkpoints, int checkpointCount, int currentIndex);
 
-void UpdateAndDrawFireworks(void);
+// Draw the player's aim line. Drawn immediately, after the sprite batch ends.
+void DrawPlayerAim(Vector2 mouseScreenPos, const Entity *player);
 
 #endif
@@ -0,0 +1,298 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "game_sim.h"
+#include "game_rendering.h"
+#include "physics.h"
+#include "ai.h"
+#include "ai_scheduler.h"
+#include "bullet.h"
+#include "bullet_pattern.h"
+
+PlayerInput ReadPlayerInput(Vector2 aimWorld)
+{
+    PlayerInput input = {0};
+    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT))
+        input.buttons |= INPUT_LEFT;
+    if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT))
+        input.buttons |= INPUT_RIGHT;
+    if (IsKeyPressed(KEY_SPACE))
+        input.buttons |= INPUT_JUMP;
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+        input.buttons |= INPUT_SHOOT;
+    input.aimWorld = aimWorld;
+    return input;
+}
+
+// Add an authored entity to the store with a fresh decision and behavior.
+static void SpawnEntityRow(EntityArchetype *arch, const Entity *e, int source)
+{
+    int row = AddEntityRow(arch, e, source);
+    if (row >= 0)
+        InitEnemyBrain(arch, row);
+}
+
+void ResetSimulation(GameState *state)
+{
+    UpdateNavGraph(&state->nav);
+    InvalidateFlowField(&state->flow);
+    ResetBulletStore(&state->bullets);
+    ResetAIScheduler(&state->ai);
+
+    // Rows keep the authored order, which replays depend on.
+    ResetEntityStore(&state->entities);
+    ResetSpawners(state->spawners, state->spawnerCount);
+    for (int i = 0; i < state->enemyCount; i++)
+        SpawnEntityRow(&state->entities.archetypes[ARCHETYPE_ENEMY], &state->enemies[i], i);
+    if (state->bossEnemy.kind != EMPTY)
+        SpawnEntityRow(&state->entities.archetypes[ARCHETYPE_BOSS], &state->bossEnemy, 0);
+
+    state->bossActive = false;
+    state->bossMeleeFlash = 0;
+    state->jumpCount = 0;
+    state->totalTime = 0.0f;
+}
+
+void SyncAuthoredEntities(GameState *state)
+{
+    // Dead rows are gone from the store; whoever isn't written back is dead.
+    for (int i = 0; i < state->enemyCount; i++)
+        state->enemies[i].health = 0;
+    WriteBackEntityRows(&state->entities.archetypes[ARCHETYPE_ENEMY], state->enemies);
+    WriteBackEntityRows(&state->entities.archetypes[ARCHETYPE_BOSS], &state->bossEnemy);
+}
+
+// Behavior systems. Each pass walks the live rows (see GatherLiveRows) and
+// touches only the components it needs; rows go in order so bullets spawn
+// in the same order every run.
+
+// Entry actions of states entered since the last tick.
+static void EnterBehaviorStates(EntityArchetype *arch)
+{
+    for (int n = 0; n < arch->liveCount; n++)
+    {
+        int i = arch->live[n];
+        BrainComponent *brain = &arch->brain[i];
+        if (!brain->entered)
+            continue;
+        const BehaviorState *bs = &brain->behavior->states[brain->state];
+        if (bs->physicsType != PHYS_NONE)
+            arch->physics[i].type = (PhysicsType)bs->physicsType;
+        const BulletPattern *pattern = (bs->attack == BEHAVIOR_ATTACK_PATTERN) ? GetBulletPatternByName(bs->patternName) : NULL;
+        ResetBulletEmitter(&arch->emitter[i], pattern, BULLET_SPEED);
+        brain->entered = false;
+    }
+}
+
+// Movement of each row's behavior state.
+static void SteerEntities(GameState *state, EntityArchetype *arch, float deltaTime)
+{
+    Entity *player = &state->player;
+    for (int n = 0; n < arch->liveCount; n++)
+    {
+        int i = arch->live[n];
+        const BrainComponent *brain = &arch->brain[i];
+        const BehaviorState *bs = &brain->behavior->states[brain->state];
+
+        // The flow field is only brought up to date once a chasing flyer needs it.
+        if (arch->physics[i].type == PHYS_GROUND)
+            GroundEnemyAI(arch, i, player, &state->nav, bs, deltaTime);
+        else if (arch->physics[i].type == PHYS_FLYING)
+        {
+            if (bs->move == BEHAVIOR_MOVE_CHASE)
+                UpdateFlowField(&state->flow, player->position);
+            FlyingEnemyAI(arch, i, player, &state->flow, bs, deltaTime, state->totalTime);
+        }
+    }
+}
+
+// Attack of each row's behavior state. Returns true when a melee attack hit the player.
+static bool RunAttacks(GameState *state, EntityArchetype *arch, float deltaTime, SimEvents *events)
+{
+    Entity *player = &state->player;
+    bool meleeHit = false;
+    for (int n = 0; n < arch->liveCount; n++)
+    {
+        int i = arch->live[n];
+        const BrainComponent *brain = &arch->brain[i];
+        const BehaviorState *bs = &brain->behavior->states[brain->state];
+        CombatComponent *combat = &arch->combat[i];
+        Vector2 pos = arch->position[i];
+        combat->shootTimer += deltaTime;
+
+        float dx = player->position.x - pos.x;
+        float dy = player->position.y - pos.y;
+        float dist2 = dx * dx + dy * dy;
+        int shots = events->shotsFired;
+        bool inRange = bs->attackRange <= 0.0f || dist2 < bs->attackRange * bs->attackRange;
+        float cooldown = combat->shootCooldown * bs->cooldownScale;
+        switch (bs->attack)
+        {
+        case BEHAVIOR_ATTACK_SHOOT:
+            if (player->health > 0 && inRange && combat->shootTimer >= cooldown)
+            {
+                if (SpawnBullet(&state->bullets, BULLET_OWNER_ENEMY, pos, player->position, BULLET_SPEED))
+                    events->shotsFired++;
+                combat->shootTimer = 0.0f;
+            }
+            break;
+        case BEHAVIOR_ATTACK_PATTERN:
+            if (inRange)
+                events->shotsFired += StepBulletEmitter(&arch->emitter[i], &state->bullets, BULLET_OWNER_ENEMY, pos,
+                                                        player->position, cooldown, deltaTime);
+            break;
+        case BEHAVIOR_ATTACK_MELEE:
+            // Range is the reach beyond touching.
+            if (sqrtf(dist2) < arch->physics[i].radius + player->radius + bs->attackRange &&
+                combat->shootTimer >= cooldown)
+            {
+                player->health -= 1;
+                combat->shootTimer = 0;
+                meleeHit = true;
+                AddSimEffect(events, SIM_EFFECT_HIT, player->position, (Vector2){dx, dy});
+            }
+            break;
+        default:
+            break;
+        }
+        if (events->shotsFired > shots)
+            AddSimEffect(events, SIM_EFFECT_MUZZLE, pos, (Vector2){dx, dy});
+    }
+    return meleeHit;
+}
+
+// Entry actions, movement, physics and attacks of every live row's current
+// behavior state. Returns true when a melee attack hit the player.
+static bool RunBehaviors(GameState *state, EntityArchetype *arch, float deltaTime, SimEvents *events)
+{
+    EnterBehaviorStates(arch);
+    SteerEntities(state, arch, deltaTime);
+    UpdateArchetypePhysics(arch, deltaTime, state->totalTime);
+    return RunAttacks(state, arch, deltaTime, events);
+}
+
+// The boss decides every tick, outside the AI scheduler's budget; its phases
+// are behavior states (see res/entities/BossAlien.ent).
+static void UpdateBoss(GameState *state, EntityArchetype *boss, float deltaTime, SimEvents *events)
+{
+    for (int n = 0; n < boss->liveCount; n++)
+        ThinkEnemy(boss, boss->live[n], &state->player, &state->nav);
+    UpdateBehaviorStates(boss, &state->player, deltaTime);
+    if (RunBehaviors(state, boss, deltaTime, events))
+        state->bossMeleeFlash = 10;
+}
+
+void AddSimEffect(SimEvents *events, SimEffectType type, Vector2 position, Vector2 direction)
+{
+    if (events->effectCount < MAX_SIM_EFFECTS)
+        events->effects[events->effectCount++] = (SimEffect){type, position, direction};
+}
+
+void SimulatePlayTick(GameState *state, const PlayerInput *input, float deltaTime, SimEvents *events)
+{
+    Entity *player = &state->player;
+    EntityArchetype *enemies = &state->entities.archetypes[ARCHETYPE_ENEMY];
+    EntityArchetype *boss = &state->entities.archetypes[ARCHETYPE_BOSS];
+
+    events->shotsFired = 0;
+    events->checkpointReached = -1;
+    events->effectCount = 0;
+    state->totalTime += deltaTime;
+    float totalTime = state->totalTime;
+
+    // Player movement and jumping.
+    player->velocity.x = 0;
+    if (input->buttons & INPUT_LEFT)
+    {
+        player->direction = -1;
+        player->velocity.x = -player->speed;
+    }
+    else if (input->buttons & INPUT_RIGHT)
+    {
+        player->direction = 1;
+        player->velocity.x = player->speed;
+    }
+
+    // Determine if the player is on the ground.
+    bool grounded = CheckTileCollision(player->position, player->radius);
+    if (grounded && state->jumpCount > 0)
+    {
+        state->jumpCount = 0;
+    }
+
+    if ((input->buttons & INPUT_JUMP) && state->jumpCount < 2)
+    {
+        // Allow a double jump if not grounded and jumpCount is less than 1.
+        player->velocity.y = PLAYER_JUMP_VELOCITY;
+        state->jumpCount++;
+    }
+
+    UpdateEntityPhysics(player, deltaTime, totalTime);
+
+    // Check for checkpoint collisions.
+    for (int i = 0; i < state->checkpointCount; i++)
+    {
+        Rectangle cpRect = {(float)state->checkpoints[i].x, (float)state->checkpoints[i].y,
+                            (float)TILE_SIZE, (float)(TILE_SIZE * 2)};
+        if (state->currentCheckpointIndex < i && CheckCollisionPointRec(player->position, cpRect))
+        {
+            state->currentCheckpointIndex = i;
+            events->checkpointReached = i;
+            break;
+        }
+    }
+
+    // Player shooting.
+    if (input->buttons & INPUT_SHOOT)
+    {
+        if (SpawnBullet(&state->bullets, BULLET_OWNER_PLAYER, player->position, input->aimWorld, BULLET_SPEED))
+        {
+            events->shotsFired++;
+            AddSimEffect(events, SIM_EFFECT_MUZZLE, player->position,
+                         (Vector2){input->aimWorld.x - player->position.x, input->aimWorld.y - player->position.y});
+        }
+    }
+
+    // Enemy logic. Spawners add their due waves, decisions are time-sliced
+    // by the scheduler, then every enemy's state machine steps and its
+    // state's movement and attack run.
+    UpdateSpawners(state->spawners, state->spawnerCount, enemies, player->position, deltaTime);
+    GatherLiveRows(enemies);
+    RunAIScheduler(&state->ai, enemies, player, &state->nav, deltaTime);
+    UpdateBehaviorStates(enemies, player, deltaTime);
+    RunBehaviors(state, enemies, deltaTime, events);
+
+    // Boss spawning logic: no enemy left alive and none left to spawn.
+    bool anyEnemiesLeft = GatherLiveRows(enemies) > 0;
+    for (int i = 0; i < state->spawnerCount && !anyEnemiesLeft; i++)
+        anyEnemiesLeft = state->spawners[i].total > 0 && !IsSpawnerFinished(&state->spawners[i]);
+    state->bossActive = !anyEnemiesLeft;
+
+    // Boss behavior.
+    if (state->bossActive)
+    {
+        if (GatherLiveRows(boss) > 0)
+        {
+            UpdateBoss(state, boss, deltaTime, events);
+        }
+        else
+        {
+            state->bossActive = false;
+            state->currentState = GAME_OVER;
+        }
+    }
+
+    UpdateBullets(&state->bullets, deltaTime);
+    HandleBulletCollisions(&state->bullets, player, &state->entities, state->bossActive, BULLET_RADIUS, events);
+
+    // Recycle the slots of everything that died this tick.
+    ReleaseSpawnedRows(state->spawners, state->spawnerCount, enemies);
+    RemoveDeadRows(enemies);
+    RemoveDeadRows(boss);
+
+    if (player->health <= 0)
+    {
+        AddSimEffect(events, SIM_EFFECT_DEATH, player->position, (Vector2){0, 0});
+        state->currentState = GAME_OVER;
+    }
+}
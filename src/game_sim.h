@@ -0,0 +1,72 @@
+#ifndef GAME_SIM_H
+#define GAME_SIM_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include "game_state.h"
+
+#define BULLET_SPEED 500.0f
+#define BULLET_RADIUS 5.0f
+#define MAX_SIM_EFFECTS 64
+
+// Buttons the PLAY tick reads, packed into PlayerInput.buttons.
+typedef enum InputButton
+{
+    INPUT_LEFT = 1 << 0,
+    INPUT_RIGHT = 1 << 1,
+    INPUT_JUMP = 1 << 2,
+    INPUT_SHOOT = 1 << 3,
+} InputButton;
+
+// Everything a single PLAY tick consumes from the player.
+typedef struct PlayerInput
+{
+    uint8_t buttons;
+    Vector2 aimWorld; // Mouse position in world space.
+} PlayerInput;
+
+typedef enum SimEffectType
+{
+    SIM_EFFECT_HIT = 0,
+    SIM_EFFECT_DEATH,
+    SIM_EFFECT_MUZZLE,
+} SimEffectType;
+
+// Something visible happened at position; direction is the way it faces
+// (a shot's aim, a bullet's travel), or zero.
+typedef struct SimEffect
+{
+    SimEffectType type;
+    Vector2 position;
+    Vector2 direction;
+} SimEffect;
+
+// Side effects of a tick that the caller presents (audio, checkpoint files,
+// particles).
+typedef struct SimEvents
+{
+    int shotsFired;
+    int checkpointReached; // Index of a newly reached checkpoint, or -1.
+    int effectCount;       // Effects past MAX_SIM_EFFECTS in one tick are dropped.
+    SimEffect effects[MAX_SIM_EFFECTS];
+} SimEvents;
+
+void AddSimEffect(SimEvents *events, SimEffectType type, Vector2 position, Vector2 direction);
+
+// Sample the keyboard and mouse into a PlayerInput.
+PlayerInput ReadPlayerInput(Vector2 aimWorld);
+
+// Clear per-run state (bullets, spawners, jump count, clock) before a level
+// starts, pack the authored enemies and boss into the entity store, and bring
+// the navigation graph and flow field up to date with the tilemap.
+void ResetSimulation(GameState *state);
+
+// Copy the simulated enemies and boss back into the authored entities, e.g.
+// before saving them to a checkpoint.
+void SyncAuthoredEntities(GameState *state);
+
+// Advance the PLAY state by one tick. Reads no devices and touches no files,
+// so the same inputs and deltas always produce the same GameState.
+void SimulatePlayTick(GameState *state, const PlayerInput *input, float deltaTime, SimEvents *events);
+
+#endif
@@ -3,8 +3,15 @@
 
 #include <raylib.h>
 #include "entity.h"
+#include "entity_store.h"
+#include "spawner.h"
 #include "memory_arena.h"
 #include "file_io.h"
+#include "bullet.h"
+#include "bullet_pattern.h"
+#include "nav_graph.h"
+#include "flow_field.h"
+#include "ai_scheduler.h"
 
 typedef enum GameStateType
 {
@@ -29,6 +36,22 @@ typedef struct GameState
     Vector2 *checkpoints;
     int checkpointCount;
     int currentCheckpointIndex;
+
+    EntitySpawner *spawners;
+    int spawnerCount;
+
+    // Built from the tilemap; see UpdateNavGraph and UpdateFlowField.
+    NavGraph nav;
+    FlowField flow;
+
+    // Transient PLAY state, cleared whenever a level is (re)started.
+    EntityStore entities; // Enemies and boss as simulated, packed by ResetSimulation.
+    BulletStore bullets;
+    bool bossActive;
+    AIScheduler ai;
+    int bossMeleeFlash;
+    int jumpCount;
+    float totalTime;
 } GameState;
 
 extern bool editorMode;
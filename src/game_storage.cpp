@@ -6,10 +6,17 @@
 #include "file_io.h"
 #include "memory_arena.h"
 #include "tile.h"
+#include "asset_reload.h"
+#include "level_format.h"
+#include "text_scanner.h"
+#include "asset_pack.h"
 
 static TextureCacheEntry textureCache[MAX_TEXTURE_CACHE];
 static int textureCacheCount = 0;
 
+bool skipTextureUpload = false;
+bool saveRawLevelTiles = false;
+
 uint64_t GenerateRandomUInt()
 {
     uint64_t hi = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
@@ -40,6 +47,9 @@ static void AddTextureToCache(const char *path, Texture2D texture)
 
 Texture2D LoadTextureWithCache(const char *path)
 {
+    if (skipTextureUpload)
+        return (Texture2D){0};
+
     Texture2D cached = GetCachedTexture(path);
     if (cached.id != 0)
     {
@@ -48,8 +58,19 @@ Texture2D LoadTextureWithCache(const char *path)
     }
     else
     {
-        // Load from disk
-        cached = LoadTexture(path);
+        // Decode from the pack, or load from disk
+        const unsigned char *data;
+        size_t size;
+        if (FindPackedAsset(path, &data, &size))
+        {
+            Image image = LoadImageFromMemory(GetFileExtension(path), data, (int)size);
+            cached = LoadTextureFromImage(image);
+            UnloadImage(image);
+        }
+        else
+        {
+            cached = LoadTexture(path);
+        }
         if (cached.id != 0)
         {
             AddTextureToCache(path, cached);
@@ -62,6 +83,39 @@ Texture2D LoadTextureWithCache(const char *path)
     }
 }
 
+bool ReplaceCachedTexture(const char *path, Image *image, Texture2D *previous, Texture2D *current)
+{
+    char wanted[MAX_FILE_PATH];
+    NormalizeAssetPath(path, wanted, sizeof(wanted));
+    for (int i = 0; i < textureCacheCount; i++)
+    {
+        char cachedPath[MAX_FILE_PATH];
+        NormalizeAssetPath(textureCache[i].path, cachedPath, sizeof(cachedPath));
+        if (strcmp(cachedPath, wanted) != 0)
+            continue;
+
+        Texture2D *texture = &textureCache[i].texture;
+        *previous = *texture;
+        if (image->width == texture->width && image->height == texture->height)
+        {
+            // Same size: upload into the existing texture so every copy of it shows the change.
+            ImageFormat(image, texture->format);
+            UpdateTexture(*texture, image->data);
+        }
+        else
+        {
+            // Copies of the old texture may still be drawn, so it stays loaded.
+            Texture2D replacement = LoadTextureFromImage(*image);
+            if (replacement.id == 0)
+                return false;
+            *texture = replacement;
+        }
+        *current = *texture;
+        return true;
+    }
+    return false;
+}
+
 void ClearTextureCache()
 {
     for (int i = 0; i < textureCacheCount; i++)
@@ -74,16 +128,40 @@ void ClearTextureCache()
     textureCacheCount = 0;
 }
 
+Music LoadMusicAsset(const char *path)
+{
+    const unsigned char *data;
+    size_t size;
+    if (FindPackedAsset(path, &data, &size))
+        return LoadMusicStreamFromMemory(GetFileExtension(path), data, (int)size);
+    return LoadMusicStream(path);
+}
+
+Sound LoadSoundAsset(const char *path)
+{
+    const unsigned char *data;
+    size_t size;
+    if (!FindPackedAsset(path, &data, &size))
+        return LoadSound(path);
+    Wave wave = LoadWaveFromMemory(GetFileExtension(path), data, (int)size);
+    Sound sound = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+    return sound;
+}
+
 // Level Files Loading
 void LoadLevelFiles()
 {
     const char *levelsDir = "./res/levels";
     const char *levelExtension = ".level";
-    int currentCount = CountFilesWithExtension(levelsDir, levelExtension);
+    FileList found;
+    ListAssetFiles(&assetArena, levelsDir, levelExtension, &found);
+    int currentCount = found.count;
 
     if (currentCount <= 0)
     {
         TraceLog(LOG_WARNING, "No level files found in %s", levelsDir);
+        FreeFileList(&assetArena, &found);
         return;
     }
 
@@ -93,6 +171,7 @@ void LoadLevelFiles()
         if (levelFiles == NULL)
         {
             TraceLog(LOG_ERROR, "Failed to allocate memory for level file list!");
+            FreeFileList(&assetArena, &found);
             return;
         }
     }
@@ -101,11 +180,12 @@ void LoadLevelFiles()
         levelFiles = (char(*)[MAX_FILE_PATH])arena_realloc(&assetArena, levelFiles, currentCount * sizeof(*levelFiles));
     }
     levelFileCount = currentCount;
-    ListFilesInDirectory(levelsDir, levelExtension, levelFiles, levelFileCount);
     for (int i = 0; i < levelFileCount; i++)
     {
+        snprintf(levelFiles[i], MAX_FILE_PATH, "%s", GetFileListName(&found, i));
         TraceLog(LOG_INFO, "%s found as a level.", levelFiles[i]);
     }
+    FreeFileList(&assetArena, &found);
 }
 
 // EntityAsset Save/Load
@@ -140,6 +220,7 @@ bool SaveEntityAssetToJson(const char *directory, const char *filename,
     fprintf(file, "%s", json);
     fclose(file);
     arena_free(&assetArena, json);
+    NoteAssetWritten(filename);
     return true;
 }
 
@@ -163,16 +244,17 @@ bool SaveAllEntityAssets(const char *directory, EntityAsset *assets, int count,
 
 bool LoadEntityAssetFromJson(const char *filename, EntityAsset *asset)
 {
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    AssetFile file;
+    if (!LoadAssetFile(filename, &file))
     {
         TraceLog(LOG_ERROR, "GAME_STORAGE: No Asset file found for : %s!", filename);
         return false;
     }
-    char buffer[1024 * 10];
-    size_t size = fread(buffer, 1, sizeof(buffer) - 1, file);
+    char buffer[1024 * 16];
+    size_t size = (file.size < sizeof(buffer) - 1) ? file.size : sizeof(buffer) - 1;
+    memcpy(buffer, file.data, size);
     buffer[size] = '\0';
-    fclose(file);
+    UnloadAssetFile(&file);
 
     if (!EntityAssetFromJSON(buffer, asset))
     {
@@ -184,8 +266,9 @@ bool LoadEntityAssetFromJson(const char *filename, EntityAsset *asset)
 
 bool LoadEntityAssets(const char *directory, EntityAsset **assets, int *count)
 {
-    char fileList[256][256];
-    int numFiles = ListFilesInDirectory(directory, "*.ent", fileList, 256);
+    FileList fileList;
+    ListAssetFiles(&assetArena, directory, ".ent", &fileList);
+    int numFiles = fileList.count;
 
     if (*assets == NULL)
     {
@@ -198,188 +281,320 @@ bool LoadEntityAssets(const char *directory, EntityAsset **assets, int *count)
     if (*assets == NULL)
     {
         TraceLog(LOG_ERROR, "Failed to allocate memory for entity assets (size %d)", numFiles);
+        FreeFileList(&assetArena, &fileList);
         return false;
     }
 
+    // '/' works on every platform; '\\' only on Windows.
+    int len = (int)strlen(directory);
+    const char *sep = (len > 0 && (directory[len - 1] == '/' || directory[len - 1] == '\\')) ? "" : "/";
     int assetCount = 0;
     for (int i = 0; i < numFiles; i++)
     {
         char fullPath[256];
-        snprintf(fullPath, sizeof(fullPath), "%s\\%s", directory, fileList[i]);
+        snprintf(fullPath, sizeof(fullPath), "%s%s%s", directory, sep, GetFileListName(&fileList, i));
 
         if (LoadEntityAssetFromJson(fullPath, &((*assets)[assetCount])))
             assetCount++;
         else
             TraceLog(LOG_ERROR, "GAME_STORAGE: Failed to load entity asset %s!", fullPath);
     }
+    FreeFileList(&assetArena, &fileList);
     *count = assetCount;
     return true;
 }
 
 // Level Save/Load
-bool SaveLevel(const char *filename, unsigned int **mapTiles, Entity player, Entity *enemies, Entity bossEnemy)
+
+// The binary level whose tile section the current tilemap uses in place.
+static MappedFile levelMapping;
+
+static bool PointsIntoMapping(const MappedFile *mapping, const void *ptr)
 {
-    char fullPath[256];
-    snprintf(fullPath, sizeof(fullPath), "./res/levels/%s", filename);
+    const unsigned char *p = (const unsigned char *)ptr;
+    return mapping->data && p >= mapping->data && p < mapping->data + mapping->size;
+}
 
-    if (!EnsureDirectoryExists("./res/levels/"))
+// Point the tilemap's rows at a copy of them in gameArena.
+static bool CopyTilemapToArena(unsigned int **tilemap)
+{
+    size_t rowSize = sizeof(unsigned int) * currentMapWidth;
+    unsigned int *tiles = (unsigned int *)arena_alloc(&gameArena, rowSize * currentMapHeight);
+    if (!tiles)
     {
-        TraceLog(LOG_ERROR, "Cannot ensure ./res/levels/ directory!");
+        TraceLog(LOG_ERROR, "Couldn't allocate memory to copy the tilemap!");
         return false;
     }
-
-    FILE *file = fopen(fullPath, "w");
-    if (!file)
+    for (int y = 0; y < currentMapHeight; y++)
     {
-        TraceLog(LOG_ERROR, "Failed to open file for saving: %s", fullPath);
-        return false;
+        memcpy(tiles + (size_t)y * currentMapWidth, tilemap[y], rowSize);
+        tilemap[y] = tiles + (size_t)y * currentMapWidth;
     }
+    return true;
+}
 
-    // Write tilemap dimensions and data.
-    fprintf(file, "%d %d\n", currentMapWidth, currentMapHeight);
-    for (int y = 0; y < currentMapHeight; y++)
-    {
-        for (int x = 0; x < currentMapWidth; x++)
+// Move any tilemap rows still in the mapped level into gameArena and drop the
+// mapping, so the file can be rewritten (writing over a mapped file faults on
+// Linux and is refused on Windows).
+static bool DetachLevelMapping()
+{
+    if (!levelMapping.data)
+        return true;
+    if (mapTiles && currentMapHeight > 0 && PointsIntoMapping(&levelMapping, mapTiles[0]) &&
+        !CopyTilemapToArena(mapTiles))
+        return false;
+    UnmapFile(&levelMapping);
+    return true;
+}
+
+static bool WritePadding(FILE *file, uint64_t *position, uint64_t target)
+{
+    static const unsigned char zeros[LEVEL_SECTION_ALIGN] = {0};
+    size_t padding = (size_t)(target - *position);
+    *position = target;
+    return padding == 0 || fwrite(zeros, 1, padding, file) == padding;
+}
+
+static void PackLevelEntity(LevelEntityRecord *record, const Entity *e, LevelEntityRole role)
+{
+    memset(record, 0, sizeof(*record));
+    record->assetId = e->assetId;
+    record->role = role;
+    record->kind = e->kind;
+    record->physicsType = e->physicsType;
+    record->baseX = e->basePos.x;
+    record->baseY = e->basePos.y;
+    record->leftBound = e->leftBound;
+    record->rightBound = e->rightBound;
+    record->health = e->health;
+    record->speed = e->speed;
+    record->shootCooldown = e->shootCooldown;
+    record->radius = e->radius;
+}
+
+// Write the level in the binary format (see level_format.h): the tiles, raw
+// or run-length encoded, then the player, enemies and boss as one entity
+// section, then checkpoints and spawners.
+static bool WriteBinaryLevel(FILE *file, unsigned int **tiles, const Entity *player, const Entity *enemies,
+                             const Entity *bossEnemy)
+{
+    int enemyCount = enemies ? gameState->enemyCount : 0;
+    int entityCount = enemyCount + (player->kind != EMPTY) + (bossEnemy->kind != EMPTY);
+    size_t rleSize = saveRawLevelTiles ? 0 : EncodeLevelTilesRle(tiles, currentMapWidth, currentMapHeight, NULL);
+    LevelEntityRecord *entities = NULL;
+    LevelSpawnerRecord *spawners = NULL;
+    unsigned char *rle = NULL;
+    if (entityCount > 0)
+        entities = (LevelEntityRecord *)arena_alloc(&gameArena, sizeof(LevelEntityRecord) * entityCount);
+    if (gameState->spawnerCount > 0)
+        spawners = (LevelSpawnerRecord *)arena_alloc(&gameArena, sizeof(LevelSpawnerRecord) * gameState->spawnerCount);
+    if (rleSize > 0)
+        rle = (unsigned char *)arena_alloc(&gameArena, rleSize);
+    if ((entityCount > 0 && !entities) || (gameState->spawnerCount > 0 && !spawners) || (rleSize > 0 && !rle))
+    {
+        TraceLog(LOG_ERROR, "Couldn't allocate memory to save the level!");
+        if (entities)
+            arena_free(&gameArena, entities);
+        if (spawners)
+            arena_free(&gameArena, spawners);
+        if (rle)
+            arena_free(&gameArena, rle);
+        return false;
+    }
+    if (rle)
+        EncodeLevelTilesRle(tiles, currentMapWidth, currentMapHeight, rle);
+
+    int entity = 0;
+    if (player->kind != EMPTY)
+        PackLevelEntity(&entities[entity++], player, LEVEL_ROLE_PLAYER);
+    for (int i = 0; i < enemyCount; i++)
+        PackLevelEntity(&entities[entity++], &enemies[i], LEVEL_ROLE_ENEMY);
+    if (bossEnemy->kind != EMPTY)
+        PackLevelEntity(&entities[entity++], bossEnemy, LEVEL_ROLE_BOSS);
+
+    for (int i = 0; i < gameState->spawnerCount; i++)
+    {
+        const EntitySpawner *sp = &gameState->spawners[i];
+        LevelSpawnerRecord *record = &spawners[i];
+        memset(record, 0, sizeof(*record));
+        record->assetId = sp->assetId;
+        record->mode = sp->mode;
+        record->x = sp->position.x;
+        record->y = sp->position.y;
+        record->spread = sp->spread;
+        record->interval = sp->interval;
+        record->perWave = sp->perWave;
+        record->total = sp->total;
+        record->maxAlive = sp->maxAlive;
+        record->triggerRadius = sp->triggerRadius;
+    }
+
+    // Lay out the sections back to back, each on a section boundary.
+    LevelFileHeader header = {0};
+    memcpy(header.magic, LEVEL_MAGIC, 4);
+    header.version = LEVEL_VERSION;
+    header.width = currentMapWidth;
+    header.height = currentMapHeight;
+    header.sectionCount = 4;
+
+    LevelSection sections[4] = {
+        {LEVEL_SECTION_TILES, (uint32_t)(currentMapWidth * currentMapHeight), 0, 0},
+        {LEVEL_SECTION_ENTITIES, (uint32_t)entityCount, 0, 0},
+        {LEVEL_SECTION_CHECKPOINTS, (uint32_t)gameState->checkpointCount, 0, 0},
+        {LEVEL_SECTION_SPAWNERS, (uint32_t)gameState->spawnerCount, 0, 0},
+    };
+    const void *sectionData[4] = {rle, entities, gameState->checkpoints, spawners};
+    sections[0].size = sizeof(uint32_t) * (uint64_t)sections[0].count;
+    if (rle)
+    {
+        sections[0].type = LEVEL_SECTION_TILES_RLE;
+        sections[0].count = (uint32_t)rleSize;
+        sections[0].size = rleSize;
+    }
+    sections[1].size = sizeof(LevelEntityRecord) * (uint64_t)sections[1].count;
+    sections[2].size = sizeof(LevelCheckpointRecord) * (uint64_t)sections[2].count;
+    sections[3].size = sizeof(LevelSpawnerRecord) * (uint64_t)sections[3].count;
+    uint64_t offset = sizeof(header) + sizeof(sections);
+    for (int i = 0; i < 4; i++)
+    {
+        sections[i].offset = AlignLevelOffset(offset);
+        offset = sections[i].offset + sections[i].size;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(sections, sizeof(sections), 1, file) == 1;
+    uint64_t position = sizeof(header) + sizeof(sections);
+    for (int i = 0; i < 4 && ok; i++)
+    {
+        ok = WritePadding(file, &position, sections[i].offset);
+        if (sections[i].type == LEVEL_SECTION_TILES)
+        {
+            for (int y = 0; y < currentMapHeight && ok; y++)
+                ok = fwrite(tiles[y], sizeof(unsigned int), currentMapWidth, file) == (size_t)currentMapWidth;
+        }
+        else if (sections[i].size > 0)
         {
-            fprintf(file, "%d ", mapTiles[y][x]);
+            ok = ok && fwrite(sectionData[i], (size_t)sections[i].size, 1, file) == 1;
         }
-        fprintf(file, "\n");
+        position += sections[i].size;
     }
 
-    // Save player data.
-    if (player.kind != EMPTY)
-    {
-        fprintf(file,
-                "PLAYER %llu %d %d %.2f %.2f %d %.2f %.2f %.2f\n",
-                player.assetId,
-                player.kind,
-                player.physicsType,
-                player.basePos.x,
-                player.basePos.y,
-                player.health,
-                player.speed,
-                player.shootCooldown,
-                player.radius);
-    }
+    if (entities)
+        arena_free(&gameArena, entities);
+    if (spawners)
+        arena_free(&gameArena, spawners);
+    if (rle)
+        arena_free(&gameArena, rle);
+    return ok;
+}
 
-    // Save enemies.
-    fprintf(file, "ENEMY_COUNT %d\n", gameState->enemyCount);
-    if (gameState->enemyCount > 0 && enemies)
+bool SaveLevel(const char *filename, unsigned int **mapTiles, Entity player, Entity *enemies, Entity bossEnemy)
+{
+    char fullPath[256];
+    snprintf(fullPath, sizeof(fullPath), "./res/levels/%s", filename);
+
+    if (!EnsureDirectoryExists("./res/levels/"))
     {
-        for (int i = 0; i < gameState->enemyCount; i++)
-        {
-            Entity *e = &enemies[i];
-            fprintf(file,
-                    "ENEMY %llu %d %d %.2f %.2f %.2f %.2f %d %.2f %.2f %.2f\n",
-                    e->assetId,
-                    e->kind,
-                    e->physicsType,
-                    e->basePos.x,
-                    e->basePos.y,
-                    e->leftBound,
-                    e->rightBound,
-                    e->health,
-                    e->speed,
-                    e->shootCooldown,
-                    e->radius);
-        }
+        TraceLog(LOG_ERROR, "Cannot ensure ./res/levels/ directory!");
+        return false;
     }
+    if (!DetachLevelMapping())
+        return false;
 
-    // Save boss.
-    if (bossEnemy.kind != EMPTY)
+    FILE *file = fopen(fullPath, "wb");
+    if (!file)
     {
-        fprintf(file,
-                "BOSS %llu %d %d %.2f %.2f %.2f %.2f %d %.2f %.2f %.2f\n",
-                bossEnemy.assetId,
-                bossEnemy.kind,
-                bossEnemy.physicsType,
-                bossEnemy.basePos.x,
-                bossEnemy.basePos.y,
-                bossEnemy.leftBound,
-                bossEnemy.rightBound,
-                bossEnemy.health,
-                bossEnemy.speed,
-                bossEnemy.shootCooldown,
-                bossEnemy.radius);
+        TraceLog(LOG_ERROR, "Failed to open file for saving: %s", fullPath);
+        return false;
     }
 
-    // Save checkpoints.
-    fprintf(file, "CHECKPOINT_COUNT %d\n", gameState->checkpointCount);
-    for (int i = 0; i < gameState->checkpointCount; i++)
+    bool ok = WriteBinaryLevel(file, mapTiles, &player, enemies, &bossEnemy);
+    if (fclose(file) != 0)
+        ok = false;
+    if (!ok)
     {
-        fprintf(file, "CHECKPOINT %.2f %.2f\n",
-                gameState->checkpoints[i].x,
-                gameState->checkpoints[i].y);
+        TraceLog(LOG_ERROR, "Failed writing level: %s", fullPath);
+        return false;
     }
-
-    fclose(file);
+    NoteAssetWritten(fullPath);
     return true;
 }
 
-bool LoadLevel(const char *filename, unsigned int ***mapTiles, Entity *player, Entity **enemies, int *enemyCount,
-               Entity *bossEnemy, Vector2 **checkpoints, int *checkpointCount)
+// Resolve the entity's asset handle from its saved id and restart its animation.
+static void BindEntityAsset(Entity *e)
 {
-    char fullPath[256];
-    snprintf(fullPath, sizeof(fullPath), "./res/levels/%s", filename);
+    e->asset = FindEntityAssetHandle(e->assetId);
+    e->anim = (AnimationComponent){0};
+    if (!IsEntityAssetHandleValid(e->asset))
+        TraceLog(LOG_WARNING, "No entity asset with id %llu!", (unsigned long long)e->assetId);
+}
 
-    FILE *file = fopen(fullPath, "r");
-    if (!file)
-    {
-        TraceLog(LOG_ERROR, "Failed to open level file: %s", fullPath);
+// Put a freshly loaded entity at its start position, idle, facing direction.
+static void PlaceLevelEntity(Entity *e, int direction)
+{
+    e->state = ENTITY_STATE_IDLE;
+    e->position = e->basePos;
+    e->velocity = (Vector2){0, 0};
+    e->direction = direction;
+    e->shootTimer = 0.0f;
+    BindEntityAsset(e);
+}
+
+// The numbers after PLAYER (no patrol bounds) or after ENEMY and BOSS.
+static bool ScanLevelEntity(TextScanner *scanner, Entity *e, bool hasBounds)
+{
+    int kind, physicsType;
+    if (!ScanUInt64(scanner, &e->assetId) || !ScanInt(scanner, &kind) || !ScanInt(scanner, &physicsType) ||
+        !ScanFloat(scanner, &e->basePos.x) || !ScanFloat(scanner, &e->basePos.y))
         return false;
-    }
+    if (hasBounds && (!ScanFloat(scanner, &e->leftBound) || !ScanFloat(scanner, &e->rightBound)))
+        return false;
+    if (!ScanInt(scanner, &e->health) || !ScanFloat(scanner, &e->speed) ||
+        !ScanFloat(scanner, &e->shootCooldown) || !ScanFloat(scanner, &e->radius))
+        return false;
+    e->kind = (EntityKind)kind;
+    e->physicsType = (PhysicsType)physicsType;
+    return true;
+}
 
+// The original text format: whitespace-separated numbers and keywords. Still
+// read so older levels load; level_convert turns them into binary levels.
+static bool LoadTextLevel(TextScanner *scanner, unsigned int ***mapTiles, Entity *player, Entity **enemies,
+                          int *enemyCount, Entity *bossEnemy, Vector2 **checkpoints, int *checkpointCount)
+{
     int rows = 0, cols = 0;
-    if (fscanf(file, "%d %d", &cols, &rows) != 2)
+    if (!ScanInt(scanner, &cols) || !ScanInt(scanner, &rows))
     {
         TraceLog(LOG_WARNING, "No tilemap dimensions found!");
-        fclose(file);
         return false;
     }
 
     *mapTiles = InitializeTilemap(cols, rows);
+    if (!*mapTiles)
+    {
+        TraceLog(LOG_ERROR, "Couldn't allocate a %dx%d tilemap!", cols, rows);
+        return false;
+    }
 
     // Read tilemap data.
     for (int y = 0; y < rows; y++)
     {
-        for (int x = 0; x < cols; x++)
+        int read = ScanUIntArray(scanner, (*mapTiles)[y], cols);
+        if (read != cols)
         {
-            if (fscanf(file, "%d", &(*mapTiles)[y][x]) != 1)
-            {
-                TraceLog(LOG_ERROR, "Failed reading tile map at (%d,%d)!", x, y);
-                fclose(file);
-                return false;
-            }
+            TraceLog(LOG_ERROR, "Failed reading tile map at (%d,%d)!", read, y);
+            return false;
         }
     }
 
-    char token[32];
     // Read player data.
-    if (fscanf(file, "%s", token) == 1 && strcmp(token, "PLAYER") == 0)
+    if (ScanKeyword(scanner, "PLAYER"))
     {
-        Entity *p = player;
-        if (fscanf(file, "%llu %d %d %f %f %d %f %f %f",
-                   &p->assetId, &p->kind, &p->physicsType,
-                   &p->basePos.x, &p->basePos.y, &p->health,
-                   &p->speed, &p->shootCooldown, &p->radius) != 9)
+        if (!ScanLevelEntity(scanner, player, false))
         {
             TraceLog(LOG_ERROR, "Failed reading player data!");
-            fclose(file);
             return false;
         }
-        p->state = ENTITY_STATE_IDLE;
-        p->position = p->basePos;
-        p->velocity = (Vector2){0, 0};
-        p->direction = 1;
-        p->shootTimer = 0.0f;
-        EntityAsset *asset = GetEntityAssetById(p->assetId);
-        if (asset)
-        {
-            InitEntityAnimation(&p->idle, &asset->idle, asset->texture);
-            InitEntityAnimation(&p->walk, &asset->walk, asset->texture);
-            InitEntityAnimation(&p->ascend, &asset->ascend, asset->texture);
-            InitEntityAnimation(&p->fall, &asset->fall, asset->texture);
-        }
+        PlaceLevelEntity(player, 1);
     }
     else
     {
@@ -387,71 +602,36 @@ bool LoadLevel(const char *filename, unsigned int ***mapTiles, Entity *player, E
     }
 
     // Read enemies.
-    if (fscanf(file, "%s", token) == 1 && strcmp(token, "ENEMY_COUNT") == 0)
+    int newEnemyCount = 0;
+    if (ScanKeyword(scanner, "ENEMY_COUNT") && !ScanInt(scanner, &newEnemyCount))
     {
-        if (fscanf(file, "%d", enemyCount) != 1)
+        TraceLog(LOG_ERROR, "Failed reading enemy count!");
+        return false;
+    }
+    if (newEnemyCount > 0)
+    {
+        Entity *resized = (Entity *)arena_realloc(&gameArena, *enemies, sizeof(Entity) * newEnemyCount);
+        if (resized == NULL)
         {
-            TraceLog(LOG_ERROR, "Failed reading enemy count!");
-            fclose(file);
+            TraceLog(LOG_ERROR, "Couldn't allocate memory for enemies!");
             return false;
         }
-        if (*enemyCount > 0)
+        *enemies = resized;
+        *enemyCount = newEnemyCount;
+        for (int i = 0; i < newEnemyCount; i++)
         {
-            if (*enemies == NULL)
-                *enemies = (Entity *)arena_alloc(&gameArena, sizeof(Entity) * (*enemyCount));
-            else
-                *enemies = (Entity *)arena_realloc(&gameArena, *enemies, sizeof(Entity) * (*enemyCount));
-            if (*enemies == NULL)
+            if (!ScanKeyword(scanner, "ENEMY"))
             {
-                TraceLog(LOG_ERROR, "Couldn't allocate memory for enemies!");
-                fclose(file);
+                TraceLog(LOG_ERROR, "Failed reading enemy token for enemy[%d]!", i);
                 return false;
             }
-            for (int i = 0; i < (*enemyCount); i++)
-            {
-                if (fscanf(file, "%s", token) == 1 && strcmp(token, "ENEMY") == 0)
-                {
-                    Entity *e = &(*enemies)[i];
-                    if (fscanf(file, "%llu %d %d %f %f %f %f %d %f %f %f",
-                               &e->assetId, &e->kind, &e->physicsType,
-                               &e->basePos.x, &e->basePos.y,
-                               &e->leftBound, &e->rightBound,
-                               &e->health, &e->speed, &e->shootCooldown, &e->radius) != 11)
-                    {
-                        TraceLog(LOG_ERROR, "Failed reading enemy[%d] data!", i);
-                        fclose(file);
-                        return false;
-                    }
-                    e->state = ENTITY_STATE_IDLE;
-                    e->position = e->basePos;
-                    e->velocity = (Vector2){0, 0};
-                    e->direction = -1;
-                    e->shootTimer = 0.0f;
-                    EntityAsset *asset = GetEntityAssetById(e->assetId);
-                    if (asset)
-                    {
-                        InitEntityAnimation(&e->idle, &asset->idle, asset->texture);
-                        InitEntityAnimation(&e->walk, &asset->walk, asset->texture);
-                        InitEntityAnimation(&e->ascend, &asset->ascend, asset->texture);
-                        InitEntityAnimation(&e->fall, &asset->fall, asset->texture);
-                    }
-                }
-                else
-                {
-                    TraceLog(LOG_ERROR, "Failed reading enemy token for enemy[%d]!", i);
-                    fclose(file);
-                    return false;
-                }
-            }
-        }
-        else
-        {
-            if (*enemies)
+            Entity *e = &resized[i];
+            if (!ScanLevelEntity(scanner, e, true))
             {
-                arena_free(&gameArena, *enemies);
-                *enemies = NULL;
+                TraceLog(LOG_ERROR, "Failed reading enemy[%d] data!", i);
+                return false;
             }
-            *enemyCount = 0;
+            PlaceLevelEntity(e, -1);
         }
     }
     else
@@ -465,32 +645,14 @@ bool LoadLevel(const char *filename, unsigned int ***mapTiles, Entity *player, E
     }
 
     // Read boss data.
-    if (fscanf(file, "%s", token) == 1 && strcmp(token, "BOSS") == 0)
-    {
-        Entity *b = bossEnemy;
-        if (fscanf(file, "%llu %d %d %f %f %f %f %d %f %f %f",
-                   &b->assetId, &b->kind, &b->physicsType,
-                   &b->basePos.x, &b->basePos.y,
-                   &b->leftBound, &b->rightBound,
-                   &b->health, &b->speed, &b->shootCooldown, &b->radius) != 11)
+    if (ScanKeyword(scanner, "BOSS"))
+    {
+        if (!ScanLevelEntity(scanner, bossEnemy, true))
         {
             TraceLog(LOG_ERROR, "Failed reading boss data!");
-            fclose(file);
             return false;
         }
-        b->state = ENTITY_STATE_IDLE;
-        b->position = b->basePos;
-        b->velocity = (Vector2){0, 0};
-        b->direction = -1;
-        b->shootTimer = 0.0f;
-        EntityAsset *asset = GetEntityAssetById(b->assetId);
-        if (asset)
-        {
-            InitEntityAnimation(&b->idle, &asset->idle, asset->texture);
-            InitEntityAnimation(&b->walk, &asset->walk, asset->texture);
-            InitEntityAnimation(&b->ascend, &asset->ascend, asset->texture);
-            InitEntityAnimation(&b->fall, &asset->fall, asset->texture);
-        }
+        PlaceLevelEntity(bossEnemy, -1);
     }
     else
     {
@@ -498,55 +660,191 @@ bool LoadLevel(const char *filename, unsigned int ***mapTiles, Entity *player, E
     }
 
     // Read checkpoints.
-    if (fscanf(file, "%s", token) == 1 && strcmp(token, "CHECKPOINT_COUNT") == 0)
-    {
-        int oldCount = *checkpointCount;
-        if (fscanf(file, "%d", checkpointCount) != 1)
+    int oldCount = *checkpointCount;
+    int newCheckpointCount = 0;
+    if (ScanKeyword(scanner, "CHECKPOINT_COUNT") && !ScanInt(scanner, &newCheckpointCount))
+        newCheckpointCount = 0;
+    *checkpointCount = newCheckpointCount;
+    if (newCheckpointCount > 0)
+    {
+        if (*checkpoints == NULL)
+            *checkpoints = (Vector2 *)arena_alloc(&gameArena, sizeof(Vector2) * newCheckpointCount);
+        else if (oldCount != newCheckpointCount)
+            *checkpoints = (Vector2 *)arena_realloc(&gameArena, *checkpoints, sizeof(Vector2) * newCheckpointCount);
+        if (!(*checkpoints))
         {
-            *checkpointCount = 0;
-            fclose(file);
+            TraceLog(LOG_ERROR, "Could not allocate memory for checkpoints!");
+            return false;
         }
-        if (*checkpointCount > 0)
+        for (int i = 0; i < newCheckpointCount; i++)
         {
-            if (*checkpoints == NULL)
-                *checkpoints = (Vector2 *)arena_alloc(&gameArena, sizeof(Vector2) * (*checkpointCount));
-            else if (oldCount != *checkpointCount)
-                *checkpoints = (Vector2 *)arena_realloc(&gameArena, *checkpoints, sizeof(Vector2) * (*checkpointCount));
-            if (!(*checkpoints))
+            if (!ScanKeyword(scanner, "CHECKPOINT"))
             {
-                TraceLog(LOG_ERROR, "Could not allocate memory for checkpoints!");
-                fclose(file);
+                TraceLog(LOG_ERROR, "Missing 'CHECKPOINT' token at index %d!", i);
                 return false;
             }
-            for (int i = 0; i < (*checkpointCount); i++)
+            if (!ScanFloat(scanner, &(*checkpoints)[i].x) || !ScanFloat(scanner, &(*checkpoints)[i].y))
             {
-                if (fscanf(file, "%s", token) == 1 && strcmp(token, "CHECKPOINT") == 0)
-                {
-                    if (fscanf(file, "%f %f", &(*checkpoints)[i].x, &(*checkpoints)[i].y) != 2)
-                    {
-                        TraceLog(LOG_ERROR, "Failed reading checkpoint[%d] data!", i);
-                        fclose(file);
-                        return false;
-                    }
-                }
-                else
-                {
-                    TraceLog(LOG_ERROR, "Missing 'CHECKPOINT' token at index %d!", i);
-                    fclose(file);
-                    return false;
-                }
+                TraceLog(LOG_ERROR, "Failed reading checkpoint[%d] data!", i);
+                return false;
             }
         }
-        else
+    }
+    else
+    {
+        if (*checkpoints)
+        {
+            arena_free(&gameArena, *checkpoints);
+            *checkpoints = NULL;
+        }
+        *checkpointCount = 0;
+        gameState->currentCheckpointIndex = -1;
+    }
+
+    // Read spawners; levels saved before spawners existed have none.
+    gameState->spawnerCount = 0;
+    int spawnerCount = 0;
+    if (ScanKeyword(scanner, "SPAWNER_COUNT") && ScanInt(scanner, &spawnerCount) && spawnerCount > 0)
+    {
+        EntitySpawner *spawners = (EntitySpawner *)arena_realloc(&gameArena, gameState->spawners,
+                                                                 sizeof(EntitySpawner) * spawnerCount);
+        if (!spawners)
         {
-            if (*checkpoints)
+            TraceLog(LOG_ERROR, "Could not allocate memory for spawners!");
+            return false;
+        }
+        gameState->spawners = spawners;
+        for (int i = 0; i < spawnerCount; i++)
+        {
+            EntitySpawner *sp = &spawners[i];
+            memset(sp, 0, sizeof(EntitySpawner));
+            int mode;
+            if (!ScanKeyword(scanner, "SPAWNER") || !ScanUInt64(scanner, &sp->assetId) || !ScanInt(scanner, &mode) ||
+                !ScanFloat(scanner, &sp->position.x) || !ScanFloat(scanner, &sp->position.y) ||
+                !ScanFloat(scanner, &sp->spread) || !ScanFloat(scanner, &sp->interval) ||
+                !ScanInt(scanner, &sp->perWave) || !ScanInt(scanner, &sp->total) ||
+                !ScanInt(scanner, &sp->maxAlive) || !ScanFloat(scanner, &sp->triggerRadius))
             {
-                arena_free(&gameArena, *checkpoints);
-                *checkpoints = NULL;
+                TraceLog(LOG_ERROR, "Failed reading spawner[%d] data!", i);
+                return false;
             }
-            *checkpointCount = 0;
-            gameState->currentCheckpointIndex = -1;
+            sp->mode = (SpawnerMode)mode;
+            sp->asset = FindEntityAssetHandle(sp->assetId);
+            if (!IsEntityAssetHandleValid(sp->asset))
+                TraceLog(LOG_WARNING, "No entity asset with id %llu for spawner %d!", (unsigned long long)sp->assetId, i);
+        }
+        gameState->spawnerCount = spawnerCount;
+    }
+
+    return true;
+}
+
+// The level as the editor saves it: a binary file mapped in, with the few
+// records copied out into entities. Raw tiles are used in place; run-length
+// encoded ones are decoded into a new tilemap.
+static bool LoadBinaryLevel(MappedFile *mapped, unsigned int ***mapTiles, Entity *player, Entity **enemies,
+                            int *enemyCount, Entity *bossEnemy, Vector2 **checkpoints, int *checkpointCount)
+{
+    const LevelFileHeader *header = ValidateBinaryLevel(mapped->data, mapped->size);
+    if (!header)
+        return false;
+    const LevelSection *tileSection = FindLevelSection(mapped->data, LEVEL_SECTION_TILES);
+    const LevelSection *rleSection = tileSection ? NULL : FindLevelSection(mapped->data, LEVEL_SECTION_TILES_RLE);
+    if (!tileSection && !rleSection)
+    {
+        TraceLog(LOG_ERROR, "LEVEL: No tile section!");
+        return false;
+    }
+    const LevelSection *entitySection = FindLevelSection(mapped->data, LEVEL_SECTION_ENTITIES);
+    const LevelSection *checkpointSection = FindLevelSection(mapped->data, LEVEL_SECTION_CHECKPOINTS);
+    const LevelSection *spawnerSection = FindLevelSection(mapped->data, LEVEL_SECTION_SPAWNERS);
+    int entityCount = entitySection ? (int)entitySection->count : 0;
+    int newCheckpointCount = checkpointSection ? (int)checkpointSection->count : 0;
+    int spawnerCount = spawnerSection ? (int)spawnerSection->count : 0;
+    const LevelEntityRecord *entityRecords =
+        entitySection ? (const LevelEntityRecord *)(mapped->data + entitySection->offset) : NULL;
+    const LevelSpawnerRecord *spawnerRecords =
+        spawnerSection ? (const LevelSpawnerRecord *)(mapped->data + spawnerSection->offset) : NULL;
+
+    int newEnemyCount = 0;
+    for (int i = 0; i < entityCount; i++)
+        newEnemyCount += (entityRecords[i].role == LEVEL_ROLE_ENEMY);
+
+    unsigned int **tilemap;
+    if (tileSection)
+        tilemap = WrapTilemap((unsigned int *)(mapped->data + tileSection->offset), (int)header->width, (int)header->height);
+    else
+        tilemap = InitializeTilemap((int)header->width, (int)header->height);
+    if (!tilemap)
+    {
+        TraceLog(LOG_ERROR, "Couldn't allocate memory for the tilemap!");
+        return false;
+    }
+    *mapTiles = tilemap;
+    if (rleSection && !DecodeLevelTilesRle(mapped->data + rleSection->offset, (size_t)rleSection->size, tilemap,
+                                           (int)header->width, (int)header->height))
+        return false;
+
+    // Entities keep their record order: the player, the enemies, then the boss.
+    memset(player, 0, sizeof(Entity));
+    memset(bossEnemy, 0, sizeof(Entity));
+    if (newEnemyCount > 0)
+    {
+        Entity *resized = (Entity *)arena_realloc(&gameArena, *enemies, sizeof(Entity) * newEnemyCount);
+        if (!resized)
+        {
+            TraceLog(LOG_ERROR, "Couldn't allocate memory for enemies!");
+            return false;
+        }
+        *enemies = resized;
+    }
+    else if (*enemies)
+    {
+        arena_free(&gameArena, *enemies);
+        *enemies = NULL;
+    }
+    *enemyCount = newEnemyCount;
+
+    int enemy = 0;
+    for (int i = 0; i < entityCount; i++)
+    {
+        const LevelEntityRecord *record = &entityRecords[i];
+        Entity *e;
+        if (record->role == LEVEL_ROLE_PLAYER)
+            e = player;
+        else if (record->role == LEVEL_ROLE_BOSS)
+            e = bossEnemy;
+        else if (record->role == LEVEL_ROLE_ENEMY)
+            e = &(*enemies)[enemy++];
+        else
+            continue;
+        e->assetId = record->assetId;
+        e->kind = (EntityKind)record->kind;
+        e->physicsType = (PhysicsType)record->physicsType;
+        e->basePos = (Vector2){record->baseX, record->baseY};
+        if (record->role != LEVEL_ROLE_PLAYER)
+        {
+            e->leftBound = record->leftBound;
+            e->rightBound = record->rightBound;
         }
+        e->health = record->health;
+        e->speed = record->speed;
+        e->shootCooldown = record->shootCooldown;
+        e->radius = record->radius;
+        PlaceLevelEntity(e, (record->role == LEVEL_ROLE_PLAYER) ? 1 : -1);
+    }
+
+    static_assert(sizeof(Vector2) == sizeof(LevelCheckpointRecord), "Checkpoints are stored as Vector2s");
+    if (newCheckpointCount > 0)
+    {
+        Vector2 *resized = (Vector2 *)arena_realloc(&gameArena, *checkpoints, sizeof(Vector2) * newCheckpointCount);
+        if (!resized)
+        {
+            TraceLog(LOG_ERROR, "Could not allocate memory for checkpoints!");
+            return false;
+        }
+        *checkpoints = resized;
+        memcpy(*checkpoints, mapped->data + checkpointSection->offset, sizeof(Vector2) * newCheckpointCount);
     }
     else
     {
@@ -555,14 +853,101 @@ bool LoadLevel(const char *filename, unsigned int ***mapTiles, Entity *player, E
             arena_free(&gameArena, *checkpoints);
             *checkpoints = NULL;
         }
-        *checkpointCount = 0;
         gameState->currentCheckpointIndex = -1;
     }
+    *checkpointCount = newCheckpointCount;
 
-    fclose(file);
+    gameState->spawnerCount = 0;
+    if (spawnerCount > 0)
+    {
+        EntitySpawner *spawners = (EntitySpawner *)arena_realloc(&gameArena, gameState->spawners,
+                                                                 sizeof(EntitySpawner) * spawnerCount);
+        if (!spawners)
+        {
+            TraceLog(LOG_ERROR, "Could not allocate memory for spawners!");
+            return false;
+        }
+        gameState->spawners = spawners;
+        for (int i = 0; i < spawnerCount; i++)
+        {
+            const LevelSpawnerRecord *record = &spawnerRecords[i];
+            EntitySpawner *sp = &spawners[i];
+            memset(sp, 0, sizeof(EntitySpawner));
+            sp->assetId = record->assetId;
+            sp->mode = (SpawnerMode)record->mode;
+            sp->position = (Vector2){record->x, record->y};
+            sp->spread = record->spread;
+            sp->interval = record->interval;
+            sp->perWave = record->perWave;
+            sp->total = record->total;
+            sp->maxAlive = record->maxAlive;
+            sp->triggerRadius = record->triggerRadius;
+            sp->asset = FindEntityAssetHandle(sp->assetId);
+            if (!IsEntityAssetHandleValid(sp->asset))
+                TraceLog(LOG_WARNING, "No entity asset with id %llu for spawner %d!", (unsigned long long)sp->assetId, i);
+        }
+        gameState->spawnerCount = spawnerCount;
+    }
     return true;
 }
 
+bool LoadLevel(const char *filename, unsigned int ***mapTiles, Entity *player, Entity **enemies, int *enemyCount,
+               Entity *bossEnemy, Vector2 **checkpoints, int *checkpointCount)
+{
+    char fullPath[256];
+    snprintf(fullPath, sizeof(fullPath), "./res/levels/%s", filename);
+
+    AssetFile file;
+    if (!LoadAssetFile(fullPath, &file))
+    {
+        TraceLog(LOG_ERROR, "Failed to open level file: %s", fullPath);
+        return false;
+    }
+    if (!IsBinaryLevel(file.data, file.size))
+    {
+        // The text is parsed straight out of memory and the file dropped.
+        TextScanner scanner = MakeTextScanner(file.data, file.size);
+        bool loaded = LoadTextLevel(&scanner, mapTiles, player, enemies, enemyCount, bossEnemy, checkpoints,
+                                    checkpointCount);
+        UnloadAssetFile(&file);
+        if (loaded)
+            UnmapFile(&levelMapping);
+        return loaded;
+    }
+
+    // The binary loader only reads through this view; a packed level is never
+    // written to, and is left mapped with the rest of the pack.
+    MappedFile view = {(unsigned char *)file.data, file.size};
+    bool loaded = LoadBinaryLevel(&view, mapTiles, player, enemies, enemyCount, bossEnemy, checkpoints,
+                                  checkpointCount);
+    if (!loaded)
+        TraceLog(LOG_ERROR, "Failed to load level file: %s", fullPath);
+    bool inPlace = *mapTiles && currentMapHeight > 0 && PointsIntoMapping(&view, (*mapTiles)[0]);
+    if (inPlace && !file.loose.data)
+    {
+        // Raw tiles in the pack: edits mustn't reach the next load of the
+        // level, so the tilemap gets its own copy.
+        if (!CopyTilemapToArena(*mapTiles))
+            loaded = false;
+        inPlace = false;
+    }
+    // Keep a loose file's mapping only while the tilemap points into it, even
+    // after a failed load. Once the tilemap is replaced, the previous level's
+    // mapping is no longer referenced.
+    if (inPlace)
+    {
+        UnmapFile(&levelMapping);
+        levelMapping = file.loose;
+    }
+    else
+    {
+        UnloadAssetFile(&file);
+        if (loaded)
+            UnmapFile(&levelMapping);
+    }
+    return loaded;
+}
+
 // Checkpoint Save/Load
 bool SaveCheckpointState(const char *filename, Entity player, Entity *enemies, Entity bossEnemy,
                          Vector2 checkpoints[], int checkpointCount, int currentIndex)
@@ -600,58 +985,32 @@ bool SaveCheckpointState(const char *filename, Entity player, Entity *enemies, E
 bool LoadCheckpointState(const char *filename, Entity *player, Entity **enemies, Entity *bossEnemy,
                          Vector2 checkpoints[], int *checkpointCount, int *checkpointIndex)
 {
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    MappedFile mapped;
+    if (!MapFile(filename, &mapped))
         return false;
-    char token[32];
+    TextScanner scanner = MakeTextScanner(mapped.data, mapped.size);
+    bool loaded = false;
     // Load player state.
-    if (fscanf(file, "%s", token) != 1 || strcmp(token, "PLAYER") != 0)
-    {
-        fclose(file);
-        return false;
-    }
-    if (fscanf(file, "%f %f %d",
-               &player->position.x, &player->position.y, &player->health) != 3)
-    {
-        fclose(file);
-        return false;
-    }
-    // Load enemy states.
-    for (int i = 0; i < gameState->enemyCount; i++)
-    {
-        if (fscanf(file, "%s", token) != 1 || strcmp(token, "ENEMY") != 0)
-            break;
-        if (fscanf(file, "%d %f %f %d",
-                   (int *)&(*enemies)[i].physicsType,
-                   &(*enemies)[i].position.x,
-                   &(*enemies)[i].position.y,
-                   &(*enemies)[i].health) != 4)
-            break;
-    }
-    // Load boss state.
-    if (fscanf(file, "%s", token) != 1 || strcmp(token, "BOSS") != 0)
-    {
-        fclose(file);
-        return false;
-    }
-    if (fscanf(file, "%f %f %d",
-               &bossEnemy->position.x, &bossEnemy->position.y, &bossEnemy->health) != 3)
-    {
-        fclose(file);
-        return false;
-    }
-    // Load last checkpoint index.
-    if (fscanf(file, "%s", token) != 1 || strcmp(token, "LAST_CHECKPOINT_INDEX") != 0)
-    {
-        fclose(file);
-        return false;
-    }
-
-    if (fscanf(file, "%d", checkpointIndex) != 1)
+    if (ScanKeyword(&scanner, "PLAYER") && ScanFloat(&scanner, &player->position.x) &&
+        ScanFloat(&scanner, &player->position.y) && ScanInt(&scanner, &player->health))
     {
-        fclose(file);
-        return false;
+        // Load enemy states.
+        for (int i = 0; i < gameState->enemyCount; i++)
+        {
+            Entity *e = &(*enemies)[i];
+            int physicsType;
+            if (!ScanKeyword(&scanner, "ENEMY") || !ScanInt(&scanner, &physicsType))
+                break;
+            e->physicsType = (PhysicsType)physicsType;
+            if (!ScanFloat(&scanner, &e->position.x) || !ScanFloat(&scanner, &e->position.y) ||
+                !ScanInt(&scanner, &e->health))
+                break;
+        }
+        // Load boss state and the last checkpoint index.
+        loaded = ScanKeyword(&scanner, "BOSS") && ScanFloat(&scanner, &bossEnemy->position.x) &&
+                 ScanFloat(&scanner, &bossEnemy->position.y) && ScanInt(&scanner, &bossEnemy->health) &&
+                 ScanKeyword(&scanner, "LAST_CHECKPOINT_INDEX") && ScanInt(&scanner, checkpointIndex);
     }
-    fclose(file);
-    return true;
+    UnmapFile(&mapped);
+    return loaded;
 }
@@ -15,9 +15,28 @@ typedef struct TextureCacheEntry
 
 uint64_t GenerateRandomUInt();
 
+// Set for headless runs, which have no window or GL context: assets still
+// parse, but every texture they ask for comes back empty (id 0).
+extern bool skipTextureUpload;
+
+// SaveLevel stores tiles run-length encoded, which is a fraction of the size
+// for mostly empty maps. Set to store them raw instead, so loading uses them
+// in place from the mapped file with no decode.
+extern bool saveRawLevelTiles;
+
 Texture2D LoadTextureWithCache(const char *path);
+// Put a reloaded image into the cached texture for path, converting the image
+// to the texture's format. Returns false when path isn't cached; otherwise
+// previous and current are the texture before and after (the same texture
+// unless the image changed size).
+bool ReplaceCachedTexture(const char *path, Image *image, Texture2D *previous, Texture2D *current);
 void ClearTextureCache();
 
+// Music and sounds from the asset pack when it holds them, else from disk.
+// Packed music streams from the pack, which must stay open while it plays.
+Music LoadMusicAsset(const char *path);
+Sound LoadSoundAsset(const char *path);
+
 // Asset Loading & Saving.
 bool LoadEntityAssetFromJson(const char *filename, EntityAsset *asset);
 bool LoadEntityAssets(const char *directory, EntityAsset **assets, int *count);
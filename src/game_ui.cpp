@@ -1,6 +1,9 @@
 #include "game_ui.h"
 #include "raylib.h"
 #include "game_state.h"
+#include "render_snapshot.h"
+#include "sprite_batch.h"
+#include <stdio.h>
 #include <string.h>
 
 // DrawButton: renders a button and returns true if it was clicked.
@@ -17,4 +20,31 @@ void DrawFilledBar(Vector2 pos, int w, int h, float percentageFilled, Color bgCo
     int filledWidth = (int)(percentageFilled * w);
     DrawRectangle(pos.x, pos.y, filledWidth, h, fgColor);
     DrawRectangleLines(pos.x, pos.y, w, h, BLACK);
-}
\ No newline at end of file
+}
+void DrawStatsOverlay(const RenderSnapshot *snapshot)
+{
+    SpriteBatchStats sprites = GetSpriteBatchStats();
+    char lines[8][64];
+    snprintf(lines[0], sizeof(lines[0]), "FPS: %d", GetFPS());
+    snprintf(lines[1], sizeof(lines[1]), "Bullets: %d", snapshot->bulletCount);
+    snprintf(lines[2], sizeof(lines[2]), "AI thinks: %d  queued: %d", snapshot->aiThinks, snapshot->aiQueueDepth);
+    snprintf(lines[3], sizeof(lines[3]), "AI cost: %.1f est / %.1f us (budget %.0f)", snapshot->aiCostUs,
+             snapshot->aiMeasuredUs, AI_BUDGET_US);
+    snprintf(lines[4], sizeof(lines[4]), "AI overruns: %d", snapshot->aiOverrunTicks);
+    snprintf(lines[5], sizeof(lines[5]), "Nav searches: %d", snapshot->navSearches);
+    snprintf(lines[6], sizeof(lines[6]), "Enemies: %d (capacity %d)", snapshot->enemyRows, snapshot->enemyCapacity);
+    snprintf(lines[7], sizeof(lines[7]), "Sprites: %d  texture binds: %d", sprites.sprites, sprites.textureRuns);
+
+    int lineCount = sizeof(lines) / sizeof(lines[0]);
+    int width = 0;
+    for (int i = 0; i < lineCount; i++)
+    {
+        int w = MeasureText(lines[i], 10);
+        if (w > width)
+            width = w;
+    }
+    int x = GetScreenWidth() - width - 20;
+    DrawRectangle(x - 5, 5, width + 10, lineCount * 14 + 6, Fade(BLACK, 0.6f));
+    for (int i = 0; i < lineCount; i++)
+        DrawText(lines[i], x, 10 + i * 14, 10, RAYWHITE);
+}
@@ -6,4 +6,6 @@
 // Draw a button using Raylib. Returns true if the button was clicked.
 bool DrawButton(const char *text, Rectangle rect, Color buttonColor, Color textColor, int textSize);
 void DrawFilledBar(Vector2 pos, int w, int h, float percentageFilled, Color bgColor, Color fgColor);
+// Frame and simulation counters in the top-right corner (toggled with F3 in PLAY).
+void DrawStatsOverlay(const struct RenderSnapshot *snapshot);
 #endif
\ No newline at end of file
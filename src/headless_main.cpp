@@ -0,0 +1,327 @@
+/*******************************************************************************************
+ * Headless runner: loads a level and runs PLAY ticks with no window, GL context or audio,
+ * driven by an input script or a recorded replay, then reports ticks/second and the final
+ * state hash. Meant for build servers and automated performance regression runs.
+ *
+ *   headless <level> [--ticks N] [--seed S] [--script file] [--record file [--checksums]] [--pack file]
+ *   headless --replay file [--verify] [--pack file]
+ *
+ * --pack reads the assets from an asset pack (see src/asset_pack.h) instead of res/, as a
+ * release build of the game does.
+ *
+ * An input script is a text file of steps, played in order and looped until the run ends:
+ *
+ *   # ticks  buttons...               (left, right, jump, shoot <aimX> <aimY>)
+ *   60       right
+ *   1        right jump
+ *   1        shoot 300 -40
+ *
+ * left and right are held for the whole step; jump and shoot are presses on its first
+ * tick, and shoot aims at the given offset from the player.
+ *******************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <raylib.h>
+#include "game_storage.h"
+#include "game_sim.h"
+#include "bullet_pattern.h"
+#include "replay.h"
+#include "asset_pack.h"
+#include "timing.h"
+
+#define HEADLESS_TICK_DT (1.0f / 60.0f)
+#define DEFAULT_HEADLESS_TICKS 3600
+#define DEFAULT_HEADLESS_SEED 42
+#define MAX_SCRIPT_STEPS 256
+
+bool editorMode = false;
+int entityAssetCount = 0;
+int levelFileCount = 0;
+char (*levelFiles)[MAX_FILE_PATH] = NULL;
+Camera2D camera;
+
+EntityAsset *entityAssets = NULL;
+GameState *gameState = NULL;
+
+typedef struct ScriptStep
+{
+    int ticks;
+    uint8_t buttons;
+    Vector2 aimOffset;
+} ScriptStep;
+
+typedef struct InputScript
+{
+    ScriptStep steps[MAX_SCRIPT_STEPS];
+    int stepCount;
+    int step;     // Step being played.
+    int stepTick; // Ticks of it played so far.
+} InputScript;
+
+// Used without --script: run right and back with the odd jump and shot, so
+// the player, enemies, bullets and pathing all get work.
+static const char *defaultScript =
+    "40 right\n"
+    "1 right shoot 300 -40\n"
+    "1 right jump\n"
+    "38 right\n"
+    "1 shoot 300 0\n"
+    "19\n"
+    "40 left\n"
+    "1 left shoot -300 -40\n"
+    "1 left jump\n"
+    "38 left\n"
+    "1 shoot -300 0\n"
+    "19\n";
+
+static bool ParseInputScript(const char *text, InputScript *script)
+{
+    memset(script, 0, sizeof(*script));
+    char line[256];
+    int lineNumber = 0;
+    while (*text)
+    {
+        size_t len = strcspn(text, "\r\n");
+        if (len >= sizeof(line))
+            len = sizeof(line) - 1;
+        memcpy(line, text, len);
+        line[len] = '\0';
+        text += strcspn(text, "\r\n");
+        text += strspn(text, "\r\n");
+        lineNumber++;
+
+        char *comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+        char *token = strtok(line, " \t");
+        if (!token)
+            continue;
+
+        if (script->stepCount == MAX_SCRIPT_STEPS)
+        {
+            TraceLog(LOG_ERROR, "HEADLESS: Script has more than %d steps", MAX_SCRIPT_STEPS);
+            return false;
+        }
+        ScriptStep *step = &script->steps[script->stepCount];
+        memset(step, 0, sizeof(*step));
+        step->ticks = atoi(token);
+        if (step->ticks <= 0)
+        {
+            TraceLog(LOG_ERROR, "HEADLESS: Script line %d: bad tick count '%s'", lineNumber, token);
+            return false;
+        }
+        while ((token = strtok(NULL, " \t")) != NULL)
+        {
+            if (strcmp(token, "left") == 0)
+                step->buttons |= INPUT_LEFT;
+            else if (strcmp(token, "right") == 0)
+                step->buttons |= INPUT_RIGHT;
+            else if (strcmp(token, "jump") == 0)
+                step->buttons |= INPUT_JUMP;
+            else if (strcmp(token, "shoot") == 0)
+            {
+                char *x = strtok(NULL, " \t");
+                char *y = x ? strtok(NULL, " \t") : NULL;
+                if (!y)
+                {
+                    TraceLog(LOG_ERROR, "HEADLESS: Script line %d: shoot needs an aim offset", lineNumber);
+                    return false;
+                }
+                step->buttons |= INPUT_SHOOT;
+                step->aimOffset = (Vector2){(float)atof(x), (float)atof(y)};
+            }
+            else
+            {
+                TraceLog(LOG_ERROR, "HEADLESS: Script line %d: unknown button '%s'", lineNumber, token);
+                return false;
+            }
+        }
+        script->stepCount++;
+    }
+
+    if (script->stepCount == 0)
+    {
+        TraceLog(LOG_ERROR, "HEADLESS: Script has no steps");
+        return false;
+    }
+    return true;
+}
+
+// Input for the next tick, advancing (and looping) the script.
+static PlayerInput NextScriptInput(InputScript *script, const Entity *player)
+{
+    const ScriptStep *step = &script->steps[script->step];
+    PlayerInput input = {0};
+    input.buttons = step->buttons & (INPUT_LEFT | INPUT_RIGHT);
+    if (script->stepTick == 0)
+    {
+        input.buttons = step->buttons;
+        input.aimWorld = (Vector2){player->position.x + step->aimOffset.x, player->position.y + step->aimOffset.y};
+    }
+
+    if (++script->stepTick == step->ticks)
+    {
+        script->stepTick = 0;
+        script->step = (script->step + 1) % script->stepCount;
+    }
+    return input;
+}
+
+// Run the script against a level for up to tickCount ticks, stopping early
+// if the run ends (the player dies or wins). Returns false if the level
+// couldn't be loaded.
+static bool RunScriptedLevel(const char *levelFilename, int tickCount, uint32_t seed, InputScript *script,
+                             const char *recordPath, bool recordChecksums)
+{
+    strncpy(gameState->currentLevelFilename, levelFilename, sizeof(gameState->currentLevelFilename) - 1);
+    if (!LoadLevel(gameState->currentLevelFilename, &mapTiles,
+                   &gameState->player, &gameState->enemies, &gameState->enemyCount,
+                   &gameState->bossEnemy, &gameState->checkpoints, &gameState->checkpointCount))
+    {
+        TraceLog(LOG_ERROR, "HEADLESS: Failed to load level: %s", levelFilename);
+        return false;
+    }
+    gameState->currentCheckpointIndex = -1;
+    gameState->currentState = PLAY;
+    ResetSimulation(gameState);
+    SetRandomSeed(seed);
+
+    ReplayRecorder recorder = {0};
+    if (recordPath != NULL)
+        BeginReplayRecording(&recorder, recordPath, gameState->currentLevelFilename, seed, recordChecksums);
+
+    int ticks = 0;
+    long long shots = 0;
+    double start = NowSeconds();
+    while (ticks < tickCount && gameState->currentState == PLAY)
+    {
+        PlayerInput input = NextScriptInput(script, &gameState->player);
+        SimEvents events;
+        SimulatePlayTick(gameState, &input, HEADLESS_TICK_DT, &events);
+        RecordReplayTick(&recorder, &input, HEADLESS_TICK_DT, gameState);
+        shots += events.shotsFired;
+        ticks++;
+    }
+    double elapsed = NowSeconds() - start;
+    EndReplayRecording(&recorder);
+
+    const EntityArchetype *enemies = &gameState->entities.archetypes[ARCHETYPE_ENEMY];
+    int enemiesAlive = 0;
+    for (int i = 0; i < enemies->count; i++)
+        enemiesAlive += (enemies->combat[i].health > 0);
+
+    if (ticks < tickCount)
+        TraceLog(LOG_INFO, "HEADLESS: Run ended after %d of %d ticks", ticks, tickCount);
+    TraceLog(LOG_INFO, "HEADLESS: %d ticks in %.3f s (%.0f ticks/s), final hash %08x",
+             ticks, elapsed, (elapsed > 0.0) ? ticks / elapsed : 0.0, HashGameState(gameState));
+    TraceLog(LOG_INFO, "HEADLESS: Player at (%.1f, %.1f) with %d hp, %d enemies alive, %d bullets, %lld shots fired",
+             gameState->player.position.x, gameState->player.position.y, gameState->player.health,
+             enemiesAlive, GetBulletCount(&gameState->bullets), shots);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *levelFilename = NULL;
+    const char *replayPath = NULL;
+    const char *scriptPath = NULL;
+    const char *recordPath = NULL;
+    const char *packPath = NULL;
+    bool recordChecksums = false;
+    bool verifyReplay = false;
+    int tickCount = DEFAULT_HEADLESS_TICKS;
+    uint32_t seed = DEFAULT_HEADLESS_SEED;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            tickCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc)
+            scriptPath = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--checksums") == 0)
+            recordChecksums = true;
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--verify") == 0)
+            verifyReplay = true;
+        else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc)
+            packPath = argv[++i];
+        else if (argv[i][0] != '-' && levelFilename == NULL)
+            levelFilename = argv[i];
+        else
+        {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if ((levelFilename == NULL) == (replayPath == NULL))
+    {
+        fprintf(stderr, "usage: headless <level> [--ticks N] [--seed S] [--script file] [--record file [--checksums]] "
+                        "[--pack file]\n"
+                        "       headless --replay file [--verify] [--pack file]\n");
+        return 2;
+    }
+
+    InputScript script;
+    if (levelFilename != NULL)
+    {
+        bool parsed;
+        if (scriptPath != NULL)
+        {
+            char *text = LoadFileText(scriptPath);
+            if (!text)
+            {
+                TraceLog(LOG_ERROR, "HEADLESS: Can't read script %s", scriptPath);
+                return 1;
+            }
+            parsed = ParseInputScript(text, &script);
+            UnloadFileText(text);
+        }
+        else
+        {
+            parsed = ParseInputScript(defaultScript, &script);
+        }
+        if (!parsed)
+            return 1;
+    }
+
+    arena_init(&gameArena, GAME_ARENA_SIZE);
+    arena_init(&assetArena, 2 * GAME_ARENA_SIZE);
+    gameState = (GameState *)arena_alloc(&gameArena, sizeof(GameState));
+    if (!gameState)
+    {
+        TraceLog(LOG_ERROR, "Failed to allocate memory for gameState");
+        return 1;
+    }
+    memset(gameState, 0, sizeof(GameState));
+
+    if (packPath != NULL && !OpenAssetPack(packPath, false))
+    {
+        TraceLog(LOG_ERROR, "HEADLESS: Can't read asset pack %s", packPath);
+        return 1;
+    }
+
+    // Nothing is drawn, so nothing is uploaded: assets only need their data.
+    skipTextureUpload = true;
+    if (!LoadEntityAssets("./res/entities/", &entityAssets, &entityAssetCount))
+        TraceLog(LOG_ERROR, "HEADLESS: Failed to load entity assets from ./res/entities");
+    UpdateEntityAssetIndex(0);
+    if (!LoadBulletPatterns("./res/patterns/", &bulletPatterns, &bulletPatternCount))
+        TraceLog(LOG_WARNING, "No bullet patterns found in ./res/patterns");
+
+    int result;
+    if (replayPath != NULL)
+        result = (RunReplayPlayback(replayPath, verifyReplay) == 0) ? 0 : 1;
+    else
+        result = RunScriptedLevel(levelFilename, tickCount, seed, &script, recordPath, recordChecksums) ? 0 : 1;
+
+    CloseAssetPack();
+    arena_destroy(&gameArena);
+    arena_destroy(&assetArena);
+    return result;
+}
@@ -0,0 +1,124 @@
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "file_watch.h"
+
+#define MAX_WATCHED_DIRECTORIES 16
+
+struct DirectoryWatch
+{
+    int inotifyFd;
+    int wakeFd; // eventfd that WakeDirectoryWatch signals.
+    int count;
+    int descriptors[MAX_WATCHED_DIRECTORIES];
+    char directories[MAX_WATCHED_DIRECTORIES][MAX_FILE_PATH];
+};
+
+DirectoryWatch *OpenDirectoryWatch(const char *const *directories, int count)
+{
+    DirectoryWatch *watch = (DirectoryWatch *)calloc(1, sizeof(DirectoryWatch));
+    if (!watch)
+        return NULL;
+
+    watch->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    watch->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (watch->inotifyFd < 0 || watch->wakeFd < 0)
+    {
+        CloseDirectoryWatch(watch);
+        return NULL;
+    }
+
+    // Saves either rewrite the file (close after write) or replace it with a
+    // renamed temporary, depending on the program doing them.
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO;
+    for (int i = 0; i < count && watch->count < MAX_WATCHED_DIRECTORIES; i++)
+    {
+        int wd = inotify_add_watch(watch->inotifyFd, directories[i], mask);
+        if (wd < 0)
+            continue;
+
+        // Store the directory without its trailing separator.
+        char *dir = watch->directories[watch->count];
+        snprintf(dir, MAX_FILE_PATH, "%s", directories[i]);
+        size_t len = strlen(dir);
+        while (len > 1 && (dir[len - 1] == '/' || dir[len - 1] == '\\'))
+            dir[--len] = '\0';
+        watch->descriptors[watch->count++] = wd;
+    }
+
+    if (watch->count == 0)
+    {
+        CloseDirectoryWatch(watch);
+        return NULL;
+    }
+    return watch;
+}
+
+static const char *FindWatchedDirectory(const DirectoryWatch *watch, int wd)
+{
+    for (int i = 0; i < watch->count; i++)
+    {
+        if (watch->descriptors[i] == wd)
+            return watch->directories[i];
+    }
+    return NULL;
+}
+
+int WaitDirectoryChanges(DirectoryWatch *watch, char paths[][MAX_FILE_PATH], int maxPaths, int timeoutMs)
+{
+    struct pollfd fds[2] = {{watch->inotifyFd, POLLIN, 0}, {watch->wakeFd, POLLIN, 0}};
+    int ready = poll(fds, 2, timeoutMs);
+    if (ready < 0)
+        return (errno == EINTR) ? 0 : -1;
+    if (fds[1].revents & POLLIN)
+        return -1;
+    if (ready == 0 || !(fds[0].revents & POLLIN))
+        return 0;
+
+    // Events are variable-length; the buffer must be aligned for inotify_event.
+    alignas(struct inotify_event) char buffer[4096];
+    int stored = 0;
+    for (;;)
+    {
+        ssize_t len = read(watch->inotifyFd, buffer, sizeof(buffer));
+        if (len <= 0)
+            break;
+
+        for (char *p = buffer; p < buffer + len;)
+        {
+            struct inotify_event *event = (struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + event->len;
+
+            const char *dir = FindWatchedDirectory(watch, event->wd);
+            if (!dir || event->len == 0 || (event->mask & IN_ISDIR) || stored >= maxPaths)
+                continue;
+            snprintf(paths[stored++], MAX_FILE_PATH, "%s/%s", dir, event->name);
+        }
+    }
+    return stored;
+}
+
+void WakeDirectoryWatch(DirectoryWatch *watch)
+{
+    uint64_t one = 1;
+    if (watch && watch->wakeFd >= 0)
+        (void)!write(watch->wakeFd, &one, sizeof(one));
+}
+
+void CloseDirectoryWatch(DirectoryWatch *watch)
+{
+    if (!watch)
+        return;
+    // Closing the inotify descriptor drops all of its watches.
+    if (watch->inotifyFd >= 0)
+        close(watch->inotifyFd);
+    if (watch->wakeFd >= 0)
+        close(watch->wakeFd);
+    free(watch);
+}
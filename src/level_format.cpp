@@ -0,0 +1,181 @@
+#include <string.h>
+#include <raylib.h>
+#include "level_format.h"
+#include "memory_arena.h"
+
+static size_t GetLevelRecordSize(uint32_t type)
+{
+    switch (type)
+    {
+    case LEVEL_SECTION_TILES:
+        return sizeof(uint32_t);
+    case LEVEL_SECTION_ENTITIES:
+        return sizeof(LevelEntityRecord);
+    case LEVEL_SECTION_CHECKPOINTS:
+        return sizeof(LevelCheckpointRecord);
+    case LEVEL_SECTION_SPAWNERS:
+        return sizeof(LevelSpawnerRecord);
+    case LEVEL_SECTION_TILES_RLE:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+bool IsBinaryLevel(const void *data, size_t size)
+{
+    return size >= 4 && memcmp(data, LEVEL_MAGIC, 4) == 0;
+}
+
+const LevelFileHeader *ValidateBinaryLevel(const void *data, size_t size)
+{
+    const LevelFileHeader *header = (const LevelFileHeader *)data;
+    if (size < sizeof(LevelFileHeader) || !IsBinaryLevel(data, size))
+    {
+        TraceLog(LOG_ERROR, "LEVEL: Truncated or not a binary level");
+        return NULL;
+    }
+    if (header->version == 0 || header->version > LEVEL_VERSION)
+    {
+        TraceLog(LOG_ERROR, "LEVEL: Unsupported version %u (newest known is %d)", header->version, LEVEL_VERSION);
+        return NULL;
+    }
+    // The tilemap is built in the game arena whatever section the tiles come
+    // from, so the map has to fit it: its row pointers plus its tiles.
+    if (header->width == 0 || header->height == 0 || header->width > INT32_MAX || header->height > INT32_MAX ||
+        (uint64_t)header->height * (sizeof(unsigned int *) + (uint64_t)header->width * sizeof(uint32_t)) >
+            GAME_ARENA_SIZE)
+    {
+        TraceLog(LOG_ERROR, "LEVEL: Bad map size %ux%u", header->width, header->height);
+        return NULL;
+    }
+    if ((uint64_t)header->sectionCount * sizeof(LevelSection) > size - sizeof(LevelFileHeader))
+    {
+        TraceLog(LOG_ERROR, "LEVEL: Section table runs past the end of the file");
+        return NULL;
+    }
+
+    const LevelSection *sections = (const LevelSection *)(header + 1);
+    for (uint32_t i = 0; i < header->sectionCount; i++)
+    {
+        const LevelSection *section = &sections[i];
+        if (section->offset > size || section->size > size - section->offset ||
+            section->offset % LEVEL_SECTION_ALIGN != 0)
+        {
+            TraceLog(LOG_ERROR, "LEVEL: Section %u is out of bounds", i);
+            return NULL;
+        }
+        size_t recordSize = GetLevelRecordSize(section->type);
+        if (recordSize != 0 && (uint64_t)section->count * recordSize != section->size)
+        {
+            TraceLog(LOG_ERROR, "LEVEL: Section %u holds %llu bytes for %u records", i,
+                     (unsigned long long)section->size, section->count);
+            return NULL;
+        }
+        if (section->type == LEVEL_SECTION_TILES &&
+            (uint64_t)header->width * header->height != section->count)
+        {
+            TraceLog(LOG_ERROR, "LEVEL: Tile section holds %u tiles for a %ux%u map",
+                     section->count, header->width, header->height);
+            return NULL;
+        }
+    }
+    return header;
+}
+
+const LevelSection *FindLevelSection(const void *data, LevelSectionType type)
+{
+    const LevelFileHeader *header = (const LevelFileHeader *)data;
+    const LevelSection *sections = (const LevelSection *)(header + 1);
+    for (uint32_t i = 0; i < header->sectionCount; i++)
+    {
+        if (sections[i].type == (uint32_t)type)
+            return &sections[i];
+    }
+    return NULL;
+}
+
+static size_t PutVarint(unsigned char *out, size_t at, uint32_t value)
+{
+    do
+    {
+        unsigned char byte = value & 0x7F;
+        value >>= 7;
+        if (out)
+            out[at] = byte | (value ? 0x80 : 0);
+        at++;
+    } while (value);
+    return at;
+}
+
+size_t EncodeLevelTilesRle(unsigned int *const *rows, int width, int height, unsigned char *out)
+{
+    size_t at = 0;
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned int *row = rows[y];
+        for (int x = 0; x < width;)
+        {
+            int run = 1;
+            while (x + run < width && row[x + run] == row[x])
+                run++;
+            at = PutVarint(out, at, (uint32_t)run);
+            at = PutVarint(out, at, row[x]);
+            x += run;
+        }
+    }
+    return at;
+}
+
+static inline bool GetVarint(const unsigned char **cursor, const unsigned char *end, uint32_t *value)
+{
+    const unsigned char *p = *cursor;
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7)
+    {
+        unsigned char byte = *p++;
+        v |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *cursor = p;
+            *value = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DecodeLevelTilesRle(const unsigned char *data, size_t size, unsigned int **rows, int width, int height)
+{
+    const unsigned char *p = data;
+    const unsigned char *end = data + size;
+    for (int y = 0; y < height; y++)
+    {
+        unsigned int *row = rows[y];
+        for (int x = 0; x < width;)
+        {
+            uint32_t run, tile;
+            if (!GetVarint(&p, end, &run) || !GetVarint(&p, end, &tile) || run == 0 || run > (uint32_t)(width - x))
+            {
+                TraceLog(LOG_ERROR, "LEVEL: Bad tile run in row %d", y);
+                return false;
+            }
+            if (tile == 0)
+            {
+                memset(row + x, 0, sizeof(unsigned int) * run);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < run; i++)
+                    row[x + i] = tile;
+            }
+            x += (int)run;
+        }
+    }
+    if (p != end)
+    {
+        TraceLog(LOG_ERROR, "LEVEL: %d bytes after the last tile run", (int)(end - p));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,127 @@
+#ifndef LEVEL_FORMAT_H
+#define LEVEL_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LEVEL_MAGIC "GGLV"
+// Version 2 added LEVEL_SECTION_TILES_RLE. Older versions still load.
+#define LEVEL_VERSION 2
+
+// Sections start on this boundary, so the tile array can be used straight
+// from a mapping of the file.
+#define LEVEL_SECTION_ALIGN 16
+
+// File layout: LevelFileHeader, sectionCount LevelSections, then the sections
+// at their offsets. Everything is little-endian. Unknown section types are
+// skipped, so later versions can add sections old loaders ignore. A level
+// has one of the two tile sections.
+typedef enum LevelSectionType
+{
+    LEVEL_SECTION_TILES = 1,       // width * height uint32 tiles, row-major.
+    LEVEL_SECTION_ENTITIES = 2,    // LevelEntityRecords.
+    LEVEL_SECTION_CHECKPOINTS = 3, // LevelCheckpointRecords.
+    LEVEL_SECTION_SPAWNERS = 4,    // LevelSpawnerRecords.
+    LEVEL_SECTION_TILES_RLE = 5    // Run-length encoded tiles; count is the size in bytes.
+} LevelSectionType;
+
+typedef struct LevelFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t sectionCount;
+    uint32_t reserved;
+} LevelFileHeader;
+
+typedef struct LevelSection
+{
+    uint32_t type;
+    uint32_t count; // Records in the section.
+    uint64_t offset;
+    uint64_t size;  // Bytes; count * the record size.
+} LevelSection;
+
+// Which of the level's entity slots a record fills.
+typedef enum LevelEntityRole
+{
+    LEVEL_ROLE_PLAYER = 0,
+    LEVEL_ROLE_ENEMY,
+    LEVEL_ROLE_BOSS
+} LevelEntityRole;
+
+// The fields a level stores for an entity; the rest is runtime state.
+typedef struct LevelEntityRecord
+{
+    uint64_t assetId;
+    uint32_t role;
+    int32_t kind;
+    int32_t physicsType;
+    float baseX, baseY;
+    float leftBound, rightBound;
+    int32_t health;
+    float speed;
+    float shootCooldown;
+    float radius;
+    uint32_t reserved;
+} LevelEntityRecord;
+
+typedef struct LevelCheckpointRecord
+{
+    float x, y;
+} LevelCheckpointRecord;
+
+typedef struct LevelSpawnerRecord
+{
+    uint64_t assetId;
+    int32_t mode;
+    float x, y;
+    float spread;
+    float interval;
+    int32_t perWave;
+    int32_t total;
+    int32_t maxAlive;
+    float triggerRadius;
+    uint32_t reserved;
+} LevelSpawnerRecord;
+
+static_assert(sizeof(LevelFileHeader) == 24, "LevelFileHeader layout");
+static_assert(sizeof(LevelSection) == 24, "LevelSection layout");
+static_assert(sizeof(LevelEntityRecord) == 56, "LevelEntityRecord layout");
+static_assert(sizeof(LevelCheckpointRecord) == 8, "LevelCheckpointRecord layout");
+static_assert(sizeof(LevelSpawnerRecord) == 48, "LevelSpawnerRecord layout");
+
+// True if data starts with the binary level magic; anything else is read as
+// a text level.
+bool IsBinaryLevel(const void *data, size_t size);
+
+// Check the header and that every section lies inside the file with a size
+// that matches its record count. Returns the header, or NULL (logging why).
+const LevelFileHeader *ValidateBinaryLevel(const void *data, size_t size);
+
+// The first section of the given type in a validated file, or NULL.
+const LevelSection *FindLevelSection(const void *data, LevelSectionType type);
+
+// LEVEL_SECTION_TILES_RLE: each row in turn as (run length, tile) pairs of
+// LEB128 varints, with the runs of a row adding up to exactly width. Empty
+// space and long platforms cost a couple of bytes per run instead of four per
+// tile, but the tiles have to be decoded rather than used in place.
+
+// Encode the rows into out, returning the encoded size. With out NULL only
+// the size is computed, to size the buffer.
+size_t EncodeLevelTilesRle(unsigned int *const *rows, int width, int height, unsigned char *out);
+
+// Decode straight into the rows of a width x height tilemap. Returns false
+// if the data is short, has a run crossing the end of a row, or has bytes
+// left over.
+bool DecodeLevelTilesRle(const unsigned char *data, size_t size, unsigned int **rows, int width, int height);
+
+// Round a file offset up to the next section boundary.
+static inline uint64_t AlignLevelOffset(uint64_t offset)
+{
+    return (offset + LEVEL_SECTION_ALIGN - 1) & ~(uint64_t)(LEVEL_SECTION_ALIGN - 1);
+}
+
+#endif
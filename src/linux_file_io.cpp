@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "file_io.h"
+
+// Large enough that a directory of a few hundred assets is read by a single
+// getdents64 call (plus the one that reports the end).
+#define DIRENT_BUFFER_SIZE (32 * 1024)
+
+// The record getdents64 fills in; glibc doesn't declare it.
+typedef struct LinuxDirent64
+{
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+} LinuxDirent64;
+
+bool EnsureDirectoryExists(const char *dirPath)
+{
+    if (mkdir(dirPath, 0755) != 0 && errno != EEXIST)
+        return false;
+    return true;
+}
+
+static bool EndsWith(const char *str, size_t strLen, const char *suffix, size_t sufLen)
+{
+    if (sufLen > strLen)
+        return false;
+    return strcasecmp(str + strLen - sufLen, suffix) == 0;
+}
+
+// Regular files only. Some filesystems leave d_type unknown, and a link
+// counts as what it points at, so those are asked about relative to the
+// directory already open.
+static bool IsFileEntry(int dirFd, const LinuxDirent64 *entry)
+{
+    if (entry->d_type == DT_REG)
+        return true;
+    if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK)
+        return false;
+    struct stat info;
+    return fstatat(dirFd, entry->d_name, &info, 0) == 0 && S_ISREG(info.st_mode);
+}
+
+bool AppendFileListName(MemoryArena *arena, FileList *list, const char *name, size_t length)
+{
+    int needed = list->namesSize + (int)length + 1;
+    if (needed > list->namesCapacity)
+    {
+        int capacity = (list->namesCapacity > 0) ? list->namesCapacity * 2 : 1024;
+        while (capacity < needed)
+            capacity *= 2;
+        char *names = (char *)arena_realloc(arena, list->names, capacity);
+        if (!names)
+            return false;
+        list->names = names;
+        list->namesCapacity = capacity;
+    }
+    if (list->count == list->offsetsCapacity)
+    {
+        int capacity = (list->offsetsCapacity > 0) ? list->offsetsCapacity * 2 : 64;
+        int *offsets = (int *)arena_realloc(arena, list->offsets, sizeof(int) * capacity);
+        if (!offsets)
+            return false;
+        list->offsets = offsets;
+        list->offsetsCapacity = capacity;
+    }
+    memcpy(list->names + list->namesSize, name, length + 1);
+    list->offsets[list->count++] = list->namesSize;
+    list->namesSize = needed;
+    return true;
+}
+
+bool ScanDirectory(MemoryArena *arena, const char *directory, const char *extension, FileList *list)
+{
+    memset(list, 0, sizeof(*list));
+    int dirFd = openat(AT_FDCWD, directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0)
+        return false;
+
+    char *buffer = (char *)arena_alloc(arena, DIRENT_BUFFER_SIZE);
+    if (!buffer)
+    {
+        close(dirFd);
+        return false;
+    }
+
+    size_t extLen = strlen(extension);
+    bool ok = true;
+    for (;;)
+    {
+        long bytes = syscall(SYS_getdents64, dirFd, buffer, DIRENT_BUFFER_SIZE);
+        if (bytes <= 0)
+        {
+            ok = (bytes == 0);
+            break;
+        }
+        for (long offset = 0; offset < bytes;)
+        {
+            const LinuxDirent64 *entry = (const LinuxDirent64 *)(buffer + offset);
+            offset += entry->d_reclen;
+
+            size_t length = strlen(entry->d_name);
+            if (length >= MAX_FILE_PATH || !EndsWith(entry->d_name, length, extension, extLen))
+                continue;
+            if (!IsFileEntry(dirFd, entry))
+                continue;
+            if (!AppendFileListName(arena, list, entry->d_name, length))
+            {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok)
+            break;
+    }
+    arena_free(arena, buffer);
+    close(dirFd);
+
+    if (!ok)
+    {
+        FreeFileList(arena, list);
+        return false;
+    }
+    SortFileList(list);
+    return true;
+}
+
+void SortFileList(FileList *list)
+{
+    const char *names = list->names;
+    std::sort(list->offsets, list->offsets + list->count,
+              [names](int a, int b) { return strcmp(names + a, names + b) < 0; });
+}
+
+void FreeFileList(MemoryArena *arena, FileList *list)
+{
+    if (list->names)
+        arena_free(arena, list->names);
+    if (list->offsets)
+        arena_free(arena, list->offsets);
+    memset(list, 0, sizeof(*list));
+}
+
+bool IsRegularFile(const char *path)
+{
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISREG(info.st_mode);
+}
+
+bool MapFile(const char *path, MappedFile *file)
+{
+    memset(file, 0, sizeof(*file));
+    int fd = openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+    // The mapping keeps the file referenced after the descriptor is closed.
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    file->data = (unsigned char *)data;
+    file->size = (size_t)info.st_size;
+    return true;
+}
+
+void UnmapFile(MappedFile *file)
+{
+    if (file->data)
+        munmap(file->data, file->size);
+    memset(file, 0, sizeof(*file));
+}
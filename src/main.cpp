@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "game_storage.h"
 #include "game_rendering.h"
 #include "physics.h"
@@ -16,7 +17,16 @@
 #include "ai.h"
 #include "game_ui.h"
 #include "bullet.h"
+#include "bullet_pattern.h"
+#include "circle_batch.h"
+#include "particles.h"
+#include "sprite_batch.h"
 #include "editor_mode.h"
+#include "game_sim.h"
+#include "replay.h"
+#include "asset_reload.h"
+#include "sim_thread.h"
+#include "asset_pack.h"
 
 // Editor mode flag: true if built with EDITOR_BUILD.
 #ifdef EDITOR_BUILD
@@ -25,6 +35,14 @@ bool editorMode = true;
 bool editorMode = false;
 #endif
 
+// Editor and debug builds read loose files under res/ ahead of res.pak, so
+// edits show up without rebuilding the pack.
+#if defined(EDITOR_BUILD) || defined(DEBUG)
+static const bool preferLooseAssets = true;
+#else
+static const bool preferLooseAssets = false;
+#endif
+
 int entityAssetCount = 0;
 int levelFileCount = 0;
 char (*levelFiles)[MAX_FILE_PATH] = NULL;
@@ -33,20 +51,67 @@ Camera2D camera;
 EntityAsset *entityAssets = NULL;
 GameState *gameState = NULL;
 
-int main(void)
+// Hit, death and muzzle bursts in world space, and the victory screen's fireworks.
+static ParticleSystem effectParticles;
+static ParticleSystem fireworkParticles;
+static ParticleEmitter fireworkEmitter = {PARTICLE_EFFECT_FIREWORK, {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT / 2}, {0, 0}, 0.3f, 0.0f};
+
+// Burst for each SimEffectType.
+static const ParticleEffect simEffectParticles[] = {PARTICLE_EFFECT_HIT, PARTICLE_EFFECT_DEATH, PARTICLE_EFFECT_MUZZLE};
+
+static void EmitSimEffects(const SimEvents *events)
 {
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Platformer Test");
-    SetTargetFPS(60);
-    SetExitKey(0);
+    for (int i = 0; i < events->effectCount; i++)
+    {
+        const SimEffect *effect = &events->effects[i];
+        EmitParticleEffect(&effectParticles, simEffectParticles[effect->type], effect->position, effect->direction);
+    }
+}
 
-    // Setup ImGui with docking.
-    rlImGuiSetup(true);
-    ImGuiIO &io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+// Reset the per-run state of a freshly loaded level and enter PLAY, recording
+// the run when a replay path was given on the command line.
+static void BeginPlaySession(ReplayRecorder *recorder, const char *recordPath, bool recordChecksums)
+{
+    ResetSimulation(gameState);
+    ResetRenderSnapshot(gameState);
+    ClearParticles(&effectParticles);
+    if (recordPath != NULL)
+    {
+        EndReplayRecording(recorder);
+        uint32_t seed = (uint32_t)time(NULL);
+        SetRandomSeed(seed);
+        BeginReplayRecording(recorder, recordPath, gameState->currentLevelFilename, seed, recordChecksums);
+    }
+    gameState->currentState = PLAY;
+}
+
+int main(int argc, char **argv)
+{
+    // Command line: --record <file> [--checksums] records each level run,
+    // --replay <file> [--verify] plays one back without presenting it.
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    bool recordChecksums = false;
+    bool verifyReplay = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--checksums") == 0)
+            recordChecksums = true;
+        else if (strcmp(argv[i], "--verify") == 0)
+            verifyReplay = true;
+    }
 
     // Initialize memory arenas.
     arena_init(&gameArena, GAME_ARENA_SIZE);
     arena_init(&assetArena, 2 * GAME_ARENA_SIZE);
+    arena_init(&snapshotArena, RENDER_SNAPSHOT_ARENA_SIZE);
+
+    // Everything under res/ comes from the pack when there is one.
+    OpenAssetPack(ASSET_PACK_PATH, preferLooseAssets);
 
     // Allocate and initialize game state.
     gameState = (GameState *)arena_alloc(&gameArena, sizeof(GameState));
@@ -61,19 +126,48 @@ int main(void)
 
     gameState->currentCheckpointIndex = -1;
 
+    // Playback only simulates, so it runs headless: no window and no textures.
+    if (replayPath != NULL)
+    {
+        skipTextureUpload = true;
+        if (!LoadEntityAssets("./res/entities/", &entityAssets, &entityAssetCount))
+            TraceLog(LOG_ERROR, "MAIN: Failed to load entity assets from ./res/entities");
+        UpdateEntityAssetIndex(0);
+        if (!LoadBulletPatterns("./res/patterns/", &bulletPatterns, &bulletPatternCount))
+            TraceLog(LOG_WARNING, "No bullet patterns found in ./res/patterns");
+        int result = RunReplayPlayback(replayPath, verifyReplay);
+        CloseAssetPack();
+        arena_destroy(&gameArena);
+        arena_destroy(&assetArena);
+        arena_destroy(&snapshotArena);
+        return (result == 0) ? 0 : 1;
+    }
+
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Platformer Test");
+    SetTargetFPS(60);
+    SetExitKey(0);
+
+    // Setup ImGui with docking.
+    rlImGuiSetup(true);
+    ImGuiIO &io = ImGui::GetIO();
+    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+
     // Initialize audio.
     InitAudioDevice();
-    Music levelSelectMusic = LoadMusicStream("res/audio/level_select_music.mp3");
-    Music gameMusic = LoadMusicStream("res/audio/game_music.mp3");
-    Music victoryMusic = LoadMusicStream("res/audio/victory.mp3");
-    Sound defeatSound = LoadSound("res/audio/defeat.mp3");
-    Sound shotSound = LoadSound("res/audio/shot.mp3");
+    Music levelSelectMusic = LoadMusicAsset("res/audio/level_select_music.mp3");
+    Music gameMusic = LoadMusicAsset("res/audio/game_music.mp3");
+    Music victoryMusic = LoadMusicAsset("res/audio/victory.mp3");
+    Sound defeatSound = LoadSoundAsset("res/audio/defeat.mp3");
+    Sound shotSound = LoadSoundAsset("res/audio/shot.mp3");
     Music *currentTrack = NULL;
 
     Texture2D levelSelectBackground = LoadTextureWithCache("./res/sprites/level_select_bg.png");
     Texture2D logoTexture = LoadTextureWithCache("./res/sprites/logo.png");
     Texture2D checkpointActTexture = LoadTextureWithCache("./res/sprites/checkpoint_activated.png");
     Texture2D checkpointReadyTexture = LoadTextureWithCache("./res/sprites/checkpoint_ready.png");
+    LoadCircleBatch();
+    InitParticleSystem(&effectParticles, MAX_EFFECT_PARTICLES, (uint32_t)time(NULL));
+    InitParticleSystem(&fireworkParticles, MAX_FIREWORK_PARTICLES, (uint32_t)time(NULL) * 2654435761u);
 
     // Set default camera parameters.
     float mapPixelWidth = currentMapWidth * TILE_SIZE;
@@ -83,17 +177,9 @@ int main(void)
     camera.rotation = 0.0f;
     camera.zoom = 1.0f;
 
-    int jumpCount = 0;
-
-    // Boss and bullet variables.
-    bool bossActive = false;
-    int bossMeleeFlash = 0;
-    float enemyShootRange = 300.0f;
-    Bullet bullets[MAX_BULLETS] = {0};
-    const float bulletSpeed = 500.0f;
-    const float bulletRadius = 5.0f;
-    float totalTime = 0.0f;
     bool newGameConfirm = false;
+    bool showStats = false; // F3 stats overlay in PLAY.
+    ReplayRecorder recorder = {0};
     const char *checkpointFullPath = "./res/saves/%s.checkpoint";
 
     // Load level file list.
@@ -104,6 +190,7 @@ int main(void)
     {
         TraceLog(LOG_ERROR, "MAIN: Failed to load entity assets from ./res/entities");
     }
+    UpdateEntityAssetIndex(0);
 
     // Load tilesets.
     if (!LoadAllTilesets("./res/tiles/", &tilesets, &tilesetCount))
@@ -111,16 +198,56 @@ int main(void)
     else
         TraceLog(LOG_INFO, "Loaded %d tilesets successfully!", tilesetCount);
 
+    // Load bullet patterns.
+    if (!LoadBulletPatterns("./res/patterns/", &bulletPatterns, &bulletPatternCount))
+        TraceLog(LOG_WARNING, "No bullet patterns found in ./res/patterns");
+
+    // Recorded runs must play back against the assets they started with.
+    // Loose edits aren't read while the pack takes precedence, so there is
+    // nothing to reload then either.
+    if (recordPath == NULL && (!IsAssetPackOpen() || preferLooseAssets))
+        StartAssetReload();
+    StartSimThread();
+
     bool shouldExitWindow = false;
     while (!shouldExitWindow)
     {
         shouldExitWindow = WindowShouldClose();
         float deltaTime = GetFrameTime();
-        totalTime += deltaTime;
 
         Entity *player = &gameState->player;
         Entity *enemies = gameState->enemies;
         Entity *boss = &gameState->bossEnemy;
+
+        // Collect the tick handed to the worker last frame, which ran while
+        // that frame was drawn and presented, and present what it reported.
+        if (IsSimTickRunning())
+        {
+            const SimEvents *events = &EndSimTick()->events;
+
+            // One shot sound per tick, however many bullets a pattern fired.
+            if (events->shotsFired > 0)
+                PlaySound(shotSound);
+            EmitSimEffects(events);
+
+            if (events->checkpointReached >= 0)
+            {
+                char checkpointFile[256];
+                snprintf(checkpointFile, sizeof(checkpointFile), checkpointFullPath, gameState->currentLevelFilename);
+                SyncAuthoredEntities(gameState);
+                if (!SaveCheckpointState(checkpointFile, *player, enemies, *boss, gameState->checkpoints,
+                                         gameState->checkpointCount, events->checkpointReached))
+                {
+                    TraceLog(LOG_ERROR, "Failed to save checkpoint state!");
+                }
+            }
+        }
+
+        // A recorded run ends as soon as the level is no longer being played.
+        if (IsReplayRecording(&recorder) && gameState->currentState != PLAY && gameState->currentState != PAUSE)
+            EndReplayRecording(&recorder);
+
+        ApplyAssetReloads();
         Vector2 mousePos = GetMousePosition();
         Vector2 screenPos = GetScreenToWorld2D(mousePos, camera);
 
@@ -200,17 +327,21 @@ int main(void)
                     }
                     else
                     {
-
+                        // Recorded runs always start from the level's initial state.
                         char checkpointFile[256];
                         snprintf(checkpointFile, sizeof(checkpointFile), checkpointFullPath, gameState->currentLevelFilename);
-                        if (!LoadCheckpointState(checkpointFile, &gameState->player,
-                                                 &gameState->enemies, &gameState->bossEnemy,
-                                                 gameState->checkpoints, &gameState->checkpointCount, &gameState->currentCheckpointIndex))
+                        if (recordPath != NULL)
+                        {
+                            gameState->currentCheckpointIndex = -1;
+                        }
+                        else if (!LoadCheckpointState(checkpointFile, &gameState->player,
+                                                      &gameState->enemies, &gameState->bossEnemy,
+                                                      gameState->checkpoints, &gameState->checkpointCount, &gameState->currentCheckpointIndex))
                         {
                             gameState->currentCheckpointIndex = -1;
                             TraceLog(LOG_WARNING, "Failed to load checkpoint in init state.");
                         }
-                        gameState->currentState = PLAY;
+                        BeginPlaySession(&recorder, recordPath, recordChecksums);
                     }
                 }
             }
@@ -224,8 +355,9 @@ int main(void)
                 break;
             }
 
-            // Update camera based on player position.
-            camera.target = player->position;
+            // Update camera based on player position as of the last tick.
+            const RenderSnapshot *snapshot = GetRenderSnapshot();
+            camera.target = snapshot->player.position;
             camera.rotation = 0.0f;
             camera.zoom = 0.66f;
 
@@ -244,213 +376,45 @@ int main(void)
                 break;
             }
 
-            // Player movement and jumping.
-            player->velocity.x = 0;
-            if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT))
-            {
-                player->direction = -1;
-                player->velocity.x = -player->speed;
-            }
-            else if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT))
-            {
-                player->direction = 1;
-                player->velocity.x = player->speed;
-            }
-
-            // Determine if the player is on the ground.
-            bool grounded = CheckTileCollision(player->position, player->radius);
-            if (grounded && jumpCount > 0)
-            {
-                jumpCount = 0;
-            }
-
-            if (IsKeyPressed(KEY_SPACE) && jumpCount < 2)
-            {
-                // Allow a double jump if not grounded and jumpCount is less than 1.
-                player->velocity.y = PLAYER_JUMP_VELOCITY;
-                jumpCount++;
-            }
-
-            UpdateEntityPhysics(player, deltaTime, totalTime);
-
-            // Check for checkpoint collisions.
-            for (int i = 0; i < gameState->checkpointCount; i++)
-            {
-                Rectangle cpRect = {(float)gameState->checkpoints[i].x, (float)gameState->checkpoints[i].y,
-                    (float)TILE_SIZE, (float)(TILE_SIZE * 2)};
-                if (gameState->currentCheckpointIndex < i && CheckCollisionPointRec(player->position, cpRect))
-                {
-                    char checkpointFile[256];
-                    snprintf(checkpointFile, sizeof(checkpointFile), checkpointFullPath, gameState->currentLevelFilename);
-                    if (!SaveCheckpointState(checkpointFile, *player, enemies, *boss, gameState->checkpoints, gameState->checkpointCount, i))
-                    {
-                        TraceLog(LOG_ERROR, "Failed to save checkpoint state!");
-                    }
-                    else
-                    {
-                        gameState->currentCheckpointIndex = i;
-                    }
-                    break;
-                }
-            }
-
-            // Player shooting.
-            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
-            {
-                SpawnBullet(bullets, MAX_BULLETS, true, player->position, screenPos, bulletSpeed);
-                PlaySound(shotSound);
-            }
-
-            // Enemy logic.
-            for (int i = 0; i < gameState->enemyCount; i++)
-            {
-                Entity *e = &enemies[i];
-                if (e->health <= 0)
-                    continue;
-                if (e->physicsType == PHYS_GROUND)
-                    GroundEnemyAI(e, player, deltaTime);
-                else if (e->physicsType == PHYS_FLYING)
-                    FlyingEnemyAI(e, player, deltaTime, totalTime);
-                UpdateEntityPhysics(e, deltaTime, totalTime);
-                e->shootTimer += deltaTime;
-                if (player->health > 0)
-                {
-                    float dx = player->position.x - e->position.x;
-                    float dy = player->position.y - e->position.y;
-                    if ((dx * dx + dy * dy) < (enemyShootRange * enemyShootRange))
-                    {
-                        if (e->shootTimer >= e->shootCooldown)
-                        {
-                            SpawnBullet(bullets, MAX_BULLETS, false, e->position, player->position, bulletSpeed);
-                            PlaySound(shotSound);
-                            e->shootTimer = 0.0f;
-                        }
-                    }
-                }
-            }
-
-            // Boss spawning logic.
-            bool anyEnemiesAlive = false;
-            for (int i = 0; i < gameState->enemyCount; i++)
-            {
-                if (enemies[i].health > 0)
-                {
-                    anyEnemiesAlive = true;
-                    break;
-                }
-            }
-
-            bossActive = !anyEnemiesAlive && boss;
-
-            // Boss behavior.
-            if (bossActive)
-            {
-                if (boss->health > 0)
-                {
-                    int bossMaxHealth = GetEntityAssetById(boss->assetId)->baseHp;
-                    boss->shootTimer += deltaTime;
-                    if (boss->health >= (bossMaxHealth * 0.5f))
-                    {
-                        boss->physicsType = PHYS_GROUND;
-                        GroundEnemyAI(boss, player, deltaTime);
-                        UpdateEntityPhysics(boss, deltaTime, totalTime);
-                        float dx = player->position.x - boss->position.x;
-                        float dy = player->position.y - boss->position.y;
-                        if (sqrtf(dx * dx + dy * dy) < boss->radius + player->radius + 10.0f)
-                        {
-                            if (boss->shootTimer >= boss->shootCooldown * 2)
-                            {
-                                player->health -= 1;
-                                boss->shootTimer = 0;
-                                bossMeleeFlash = 10;
-                            }
-                        }
-                    }
-                    else if (boss->health >= (bossMaxHealth * 0.2f))
-                    {
-                        boss->physicsType = PHYS_FLYING;
-                        FlyingEnemyAI(boss, player, deltaTime, totalTime);
-                        UpdateEntityPhysics(boss, deltaTime, totalTime);
-                        if (boss->shootTimer >= boss->shootCooldown)
-                        {
-                            boss->shootTimer = 0;
-                            float dx = player->position.x - boss->position.x;
-                            float dy = player->position.y - boss->position.y;
-                            float len = sqrtf(dx * dx + dy * dy);
-                            Vector2 dir = {0, 0};
-                            if (len > 0.0f)
-                            {
-                                dir.x = dx / len;
-                                dir.y = dy / len;
-                            }
-                            SpawnBullet(bullets, MAX_BULLETS, false, boss->position, player->position, bulletSpeed);
-                            PlaySound(shotSound);
-                        }
-                    }
-                    else
-                    {
-                        boss->physicsType = PHYS_FLYING;
-                        FlyingEnemyAI(boss, player, deltaTime, totalTime);
-                        UpdateEntityPhysics(boss, deltaTime, totalTime);
-                        if (boss->shootTimer >= boss->shootCooldown / 2)
-                        {
-                            boss->shootTimer = 0;
-                            float centerAngle = atan2f(player->position.y - boss->position.y,
-                                                       player->position.x - boss->position.x);
-                            float fanSpread = 30.0f * DEG2RAD;
-                            float spacing = fanSpread / 2.0f;
-                            // Determine a target distance (arbitrary; adjust as needed)
-                            float targetDistance = 100.0f;
-                            for (int i = -2; i <= 2; i++)
-                            {
-                                float angle = centerAngle + i * spacing;
-                                Vector2 target;
-                                target.x = boss->position.x + cosf(angle) * targetDistance;
-                                target.y = boss->position.y + sinf(angle) * targetDistance;
-                                SpawnBullet(bullets, MAX_BULLETS, false, boss->position, target, bulletSpeed);
-                                PlaySound(shotSound);
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    bossActive = false;
-                    gameState->currentState = GAME_OVER;
-                }
-            }
-
-            UpdateBullets(bullets, MAX_BULLETS, deltaTime);
-            HandleBulletCollisions(bullets, MAX_BULLETS, player, enemies, gameState->enemyCount, boss, &bossActive, bulletRadius);
-
-            if (player->health <= 0)
-                gameState->currentState = GAME_OVER;
+            // The tick runs on the worker until the top of the next frame;
+            // from here on this frame only draws the snapshot of the last one.
+            PlayerInput input = ReadPlayerInput(screenPos);
+            Rectangle view = GetCameraView(&camera);
+            BeginSimTick(gameState, &input, deltaTime, view, &recorder);
+            UpdateParticles(&effectParticles, deltaTime);
 
             ClearBackground(DARKGRAY);
 
+            const Entity *shownPlayer = &snapshot->player;
             BeginMode2D(camera);
-            DrawTilemap(&camera);
-            DrawEntities(deltaTime, screenPos, player, enemies, gameState->enemyCount, boss, &bossMeleeFlash, bossActive);
-            for (int i = 0; i < MAX_BULLETS; i++)
-            {
-                if (bullets[i].active)
-                    DrawCircle((int)bullets[i].position.x, (int)bullets[i].position.y, bulletRadius, BLUE);
-            }
-            DrawCheckpoints(checkpointReadyTexture, checkpointActTexture, gameState->checkpoints, gameState->checkpointCount, gameState->currentCheckpointIndex);
+            BeginSpriteBatch(view);
+            DrawTilemap(&camera, false);
+            DrawCheckpoints(checkpointReadyTexture, checkpointActTexture, snapshot->checkpoints, snapshot->checkpointCount, snapshot->currentCheckpointIndex);
+            DrawEntities((Entity *)shownPlayer, NULL, 0, NULL, NULL, false);
+            DrawRenderEntities(snapshot->entities, snapshot->entityCount);
+            EndSpriteBatch();
+            DrawPlayerAim(screenPos, shownPlayer);
+            DrawBullets(snapshot->bulletX, snapshot->bulletY, snapshot->bulletCount, &camera, BULLET_RADIUS, BLUE);
+            DrawParticles(&effectParticles, view);
 
             EndMode2D();
             DrawText("Health", 10, 30, 10, BLACK);
             Vector2 barPos = {(float)(20 + MeasureText("Health", 10)), 30.0f};
-            DrawFilledBar(barPos, 200, 15, player->health / (float)GetEntityAssetById(player->assetId)->baseHp, BLACK, LIGHTGRAY);
-            if (bossActive && boss->health > 0)
+            DrawFilledBar(barPos, 200, 15, shownPlayer->health / (float)GetEntityAsset(shownPlayer->asset)->baseHp, BLACK, LIGHTGRAY);
+            if (snapshot->bossHealth > 0)
             {
                 int bossBarWidth = 300;
                 int bossBarHeight = 20;
                 float bossBarX = GetScreenWidth() / 2 - bossBarWidth / 2;
                 float bossBarY = 50;
-                DrawFilledBar((Vector2){bossBarX, bossBarY}, bossBarWidth, bossBarHeight, boss->health / (float)GetEntityAssetById(boss->assetId)->baseHp, DARKGRAY, RED);
-                DrawText(TextFormat("Boss HP: %d", boss->health), bossBarX, bossBarY - 25, 20, BLACK);
+                DrawFilledBar((Vector2){bossBarX, bossBarY}, bossBarWidth, bossBarHeight, snapshot->bossHealth / (float)snapshot->bossMaxHealth, DARKGRAY, RED);
+                DrawText(TextFormat("Boss HP: %d", snapshot->bossHealth), bossBarX, bossBarY - 25, 20, BLACK);
             }
+
+            if (IsKeyPressed(KEY_F3))
+                showStats = !showStats;
+            if (showStats)
+                DrawStatsOverlay(snapshot);
             break;
         }
         case PAUSE:
@@ -512,14 +476,13 @@ int main(void)
                                 TraceLog(LOG_ERROR, "Failed to load checkpoint state!");
                             }
 
-                            for (int i = 0; i < MAX_BULLETS; i++)
-                                bullets[i].active = false;
-                            player->health = GetEntityAssetById(player->assetId)->baseHp;
-                            player->velocity = (Vector2){0, 0};
                             for (int i = 0; i < gameState->enemyCount; i++)
                                 enemies[i].velocity = (Vector2){0, 0};
+                            ResetSimulation(gameState);
+                            player->health = GetEntityAsset(player->asset)->baseHp;
+                            player->velocity = (Vector2){0, 0};
+                            ResetRenderSnapshot(gameState);
                             camera.target = player->position;
-                            bossActive = false;
                             ResumeMusicStream(*currentTrack);
                             gameState->currentState = PLAY;
                         }
@@ -550,7 +513,7 @@ int main(void)
                             else
                             {
                                 gameState->currentCheckpointIndex = -1;
-                                gameState->currentState = PLAY;
+                                BeginPlaySession(&recorder, recordPath, recordChecksums);
                             }
                         }
                     }
@@ -594,7 +557,7 @@ int main(void)
                         }
                         else
                         {
-                            gameState->currentState = PLAY;
+                            BeginPlaySession(&recorder, recordPath, recordChecksums);
                         }
                     }
                     else if (IsKeyPressed(KEY_N))
@@ -615,7 +578,9 @@ int main(void)
                 }
 
                 ClearBackground(BLACK);
-                UpdateAndDrawFireworks();
+                UpdateParticleEmitter(&fireworkParticles, &fireworkEmitter, deltaTime);
+                UpdateParticles(&fireworkParticles, deltaTime);
+                DrawParticles(&fireworkParticles, (Rectangle){0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()});
 
                 // clear checkpoint since victory state reached.
                 char checkpointFile[256];
@@ -647,6 +612,7 @@ int main(void)
 
         rlImGuiEnd();
         EndDrawing();
+
         if (currentTrack != NULL && IsMusicStreamPlaying(*currentTrack))
         {
             if (shouldExitWindow)
@@ -657,8 +623,14 @@ int main(void)
     }
 
     // Shutdown and cleanup.
+    StopSimThread();
+    StopAssetReload();
+    EndReplayRecording(&recorder);
     rlImGuiShutdown();
     UnloadTexture(levelSelectBackground);
+    UnloadCircleBatch();
+    FreeParticleSystem(&effectParticles);
+    FreeParticleSystem(&fireworkParticles);
     ClearTextureCache();
     StopSound(shotSound);
     UnloadMusicStream(levelSelectMusic);
@@ -667,9 +639,11 @@ int main(void)
     UnloadSound(shotSound);
     UnloadSound(defeatSound);
     CloseAudioDevice();
+    CloseAssetPack();
     arena_free(&gameArena, gameState);
     arena_destroy(&gameArena);
     arena_destroy(&assetArena);
+    arena_destroy(&snapshotArena);
     CloseWindow();
     return 0;
 }
@@ -4,7 +4,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 
-#define GAME_ARENA_SIZE (1024 * 1024)
+#define GAME_ARENA_SIZE (16 * 1024 * 1024)
 
 typedef struct BlockHeader
 {
@@ -0,0 +1,465 @@
+#include "nav_graph.h"
+#include "game_rendering.h"
+#include "memory_arena.h"
+#include "tile.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAV_UNKNOWN -3
+
+static int NavTilePhysics(const NavGraph *nav, int x, int y)
+{
+    return GetTilePhysics(nav->tiles[y][x]);
+}
+
+// Free to move through: inside the map horizontally, and neither ground nor death.
+static bool IsNavPassable(const NavGraph *nav, int x, int y)
+{
+    if (x < 0 || x >= nav->width || y >= nav->height)
+        return false;
+    if (y < 0)
+        return true;
+    return NavTilePhysics(nav, x, y) == TILE_PHYS_NONE;
+}
+
+static bool IsNavWalkable(const NavGraph *nav, int x, int y)
+{
+    if (y < 0 || y + 1 >= nav->height || NavTilePhysics(nav, x, y + 1) != TILE_PHYS_GROUND)
+        return false;
+    for (int k = 0; k < NAV_CLEARANCE_TILES; k++)
+    {
+        if (!IsNavPassable(nav, x, y - k))
+            return false;
+    }
+    return true;
+}
+
+static int GetCellSpan(const NavGraph *nav, int x, int y)
+{
+    int local = nav->cellSpan[y * nav->width + x];
+    return (local < 0) ? -1 : nav->rowFirstSpan[y] + local;
+}
+
+// Scan one row into spans (when out is non-NULL) and refresh its cellSpan entries.
+static int ScanNavRow(NavGraph *nav, int y, NavSpan *out)
+{
+    int16_t *cells = &nav->cellSpan[y * nav->width];
+    int count = 0;
+    int x = 0;
+    while (x < nav->width)
+    {
+        if (!IsNavWalkable(nav, x, y))
+        {
+            cells[x++] = -1;
+            continue;
+        }
+        int x0 = x;
+        while (x < nav->width && IsNavWalkable(nav, x, y))
+            cells[x++] = (int16_t)count;
+        if (out)
+            out[count] = (NavSpan){y, x0, x - 1};
+        count++;
+    }
+    return count;
+}
+
+static void FreeNavSearchData(NavGraph *nav)
+{
+    arena_free(&gameArena, nav->links);
+    arena_free(&gameArena, nav->linkFirst);
+    arena_free(&gameArena, nav->gScore);
+    arena_free(&gameArena, nav->cameFrom);
+    arena_free(&gameArena, nav->entryX);
+    arena_free(&gameArena, nav->visited);
+    arena_free(&gameArena, nav->closed);
+    arena_free(&gameArena, nav->openHeap);
+    for (int i = 0; i < NAV_PATH_CACHE_GOALS; i++)
+        arena_free(&gameArena, nav->cache[i].nextLink);
+    nav->links = NULL;
+    nav->linkFirst = NULL;
+    nav->gScore = NULL;
+    nav->cameFrom = NULL;
+    nav->entryX = NULL;
+    nav->visited = NULL;
+    nav->closed = NULL;
+    nav->openHeap = NULL;
+    memset(nav->cache, 0, sizeof(nav->cache));
+    nav->linkCount = 0;
+}
+
+void FreeNavGraph(NavGraph *nav)
+{
+    FreeNavSearchData(nav);
+    arena_free(&gameArena, nav->spans);
+    arena_free(&gameArena, nav->rowFirstSpan);
+    arena_free(&gameArena, nav->cellSpan);
+    arena_free(&gameArena, nav->dirtyRows);
+    memset(nav, 0, sizeof(*nav));
+}
+
+static bool AddNavLink(NavLink **links, int *count, int *capacity, NavLink link)
+{
+    if (*count >= *capacity)
+    {
+        int newCapacity = (*capacity > 0) ? *capacity * 2 : 256;
+        NavLink *grown = (NavLink *)arena_realloc(&gameArena, *links, sizeof(NavLink) * newCapacity);
+        if (!grown)
+            return false;
+        *links = grown;
+        *capacity = newCapacity;
+    }
+    (*links)[(*count)++] = link;
+    return true;
+}
+
+static bool BuildNavLinks(NavGraph *nav)
+{
+    NavLink *links = NULL;
+    int count = 0;
+    int capacity = 0;
+    nav->linkFirst = (int *)arena_alloc(&gameArena, sizeof(int) * (nav->spanCount + 1));
+    if (!nav->linkFirst)
+        return false;
+
+    for (int s = 0; s < nav->spanCount; s++)
+    {
+        const NavSpan *a = &nav->spans[s];
+        nav->linkFirst[s] = count;
+
+        // Walk off either end and fall straight down.
+        int sides[2] = {a->x0 - 1, a->x1 + 1};
+        for (int side = 0; side < 2; side++)
+        {
+            int c = sides[side];
+            if (!IsNavPassable(nav, c, a->row) || !IsNavPassable(nav, c, a->row - 1))
+                continue;
+            for (int r = a->row + 1; r < nav->height; r++)
+            {
+                if (!IsNavPassable(nav, c, r))
+                    break;
+                int land = GetCellSpan(nav, c, r);
+                if (land >= 0)
+                {
+                    NavLink link = {s, land, (side == 0) ? a->x0 : a->x1, c, (float)(r - a->row + 1), NAV_LINK_FALL};
+                    if (!AddNavLink(&links, &count, &capacity, link))
+                    {
+                        arena_free(&gameArena, links);
+                        return false;
+                    }
+                    break;
+                }
+            }
+        }
+
+        // Jump to nearby spans that don't overlap this one horizontally.
+        int firstRow = (a->row - NAV_MAX_JUMP_UP < 0) ? 0 : a->row - NAV_MAX_JUMP_UP;
+        int lastRow = (a->row + NAV_MAX_JUMP_DOWN >= nav->height) ? nav->height - 1 : a->row + NAV_MAX_JUMP_DOWN;
+        for (int r = firstRow; r <= lastRow; r++)
+        {
+            for (int t = nav->rowFirstSpan[r]; t < nav->rowFirstSpan[r + 1]; t++)
+            {
+                const NavSpan *b = &nav->spans[t];
+                int gap, fromX, toX;
+                if (b->x0 > a->x1)
+                {
+                    gap = b->x0 - a->x1 - 1;
+                    fromX = a->x1;
+                    toX = b->x0;
+                }
+                else if (b->x1 < a->x0)
+                {
+                    gap = a->x0 - b->x1 - 1;
+                    fromX = a->x0;
+                    toX = b->x1;
+                }
+                else
+                {
+                    continue;
+                }
+                if (gap > NAV_MAX_JUMP_GAP)
+                    continue;
+                float cost = (float)(abs(toX - fromX) + abs(b->row - a->row)) + NAV_JUMP_COST;
+                NavLink link = {s, t, fromX, toX, cost, NAV_LINK_JUMP};
+                if (!AddNavLink(&links, &count, &capacity, link))
+                {
+                    arena_free(&gameArena, links);
+                    return false;
+                }
+            }
+        }
+    }
+    nav->linkFirst[nav->spanCount] = count;
+    nav->links = links;
+    nav->linkCount = count;
+    return true;
+}
+
+static bool AllocNavSearchData(NavGraph *nav)
+{
+    int spans = (nav->spanCount > 0) ? nav->spanCount : 1;
+    nav->gScore = (float *)arena_alloc(&gameArena, sizeof(float) * spans);
+    nav->cameFrom = (int *)arena_alloc(&gameArena, sizeof(int) * spans);
+    nav->entryX = (int *)arena_alloc(&gameArena, sizeof(int) * spans);
+    nav->visited = (unsigned int *)arena_alloc(&gameArena, sizeof(unsigned int) * spans);
+    nav->closed = (unsigned int *)arena_alloc(&gameArena, sizeof(unsigned int) * spans);
+    // Entries are never decreased in place, so the heap can hold one per link.
+    nav->openHeap = (NavOpenEntry *)arena_alloc(&gameArena, sizeof(NavOpenEntry) * (nav->linkCount + 1));
+    if (!nav->gScore || !nav->cameFrom || !nav->entryX || !nav->visited || !nav->closed || !nav->openHeap)
+        return false;
+    memset(nav->visited, 0, sizeof(unsigned int) * spans);
+    memset(nav->closed, 0, sizeof(unsigned int) * spans);
+    nav->searchStamp = 0;
+    for (int i = 0; i < NAV_PATH_CACHE_GOALS; i++)
+        nav->cache[i].goal = -1;
+    return true;
+}
+
+void UpdateNavGraph(NavGraph *nav)
+{
+    if (!mapTiles || currentMapWidth <= 0 || currentMapHeight <= 0)
+        return;
+
+    if (nav->tiles != mapTiles || nav->width != currentMapWidth || nav->height != currentMapHeight)
+    {
+        FreeNavGraph(nav);
+        nav->tiles = mapTiles;
+        nav->width = currentMapWidth;
+        nav->height = currentMapHeight;
+        nav->cellSpan = (int16_t *)arena_alloc(&gameArena, sizeof(int16_t) * nav->width * nav->height);
+        nav->rowFirstSpan = (int *)arena_alloc(&gameArena, sizeof(int) * (nav->height + 1));
+        nav->dirtyRows = (uint8_t *)arena_alloc(&gameArena, nav->height);
+        if (!nav->cellSpan || !nav->rowFirstSpan || !nav->dirtyRows)
+        {
+            TraceLog(LOG_ERROR, "NAV: Failed to allocate a %dx%d navigation graph!", nav->width, nav->height);
+            FreeNavGraph(nav);
+            return;
+        }
+        memset(nav->rowFirstSpan, 0, sizeof(int) * (nav->height + 1));
+        memset(nav->dirtyRows, 1, nav->height);
+        nav->dirty = true;
+    }
+    if (!nav->dirty)
+        return;
+
+    // Count spans per row: rescan dirty rows, keep the rest.
+    // On failure the dirty rows are left as they are, so the next update retries.
+    int *rowCounts = (int *)arena_alloc(&gameArena, sizeof(int) * nav->height);
+    if (!rowCounts)
+    {
+        TraceLog(LOG_ERROR, "NAV: Failed to allocate span counts for %d rows!", nav->height);
+        return;
+    }
+    int total = 0;
+    for (int y = 0; y < nav->height; y++)
+    {
+        rowCounts[y] = nav->dirtyRows[y] ? ScanNavRow(nav, y, NULL)
+                                         : nav->rowFirstSpan[y + 1] - nav->rowFirstSpan[y];
+        total += rowCounts[y];
+    }
+
+    NavSpan *spans = (NavSpan *)arena_alloc(&gameArena, sizeof(NavSpan) * (total > 0 ? total : 1));
+    if (!spans)
+    {
+        TraceLog(LOG_ERROR, "NAV: Failed to allocate %d spans!", total);
+        arena_free(&gameArena, rowCounts);
+        return;
+    }
+    int next = 0;
+    for (int y = 0; y < nav->height; y++)
+    {
+        if (nav->dirtyRows[y])
+            ScanNavRow(nav, y, &spans[next]);
+        else
+            memcpy(&spans[next], &nav->spans[nav->rowFirstSpan[y]], sizeof(NavSpan) * rowCounts[y]);
+        next += rowCounts[y];
+    }
+    // rowFirstSpan is only rewritten once the old spans are no longer read.
+    next = 0;
+    for (int y = 0; y < nav->height; y++)
+    {
+        nav->rowFirstSpan[y] = next;
+        next += rowCounts[y];
+    }
+    nav->rowFirstSpan[nav->height] = next;
+    arena_free(&gameArena, rowCounts);
+    arena_free(&gameArena, nav->spans);
+    nav->spans = spans;
+    nav->spanCount = total;
+    memset(nav->dirtyRows, 0, nav->height);
+    nav->dirty = false;
+
+    FreeNavSearchData(nav);
+    if (!BuildNavLinks(nav) || !AllocNavSearchData(nav))
+    {
+        TraceLog(LOG_ERROR, "NAV: Failed to allocate navigation links!");
+        FreeNavSearchData(nav);
+        // The spans are current; the next update keeps them and retries the links.
+        nav->dirty = true;
+        return;
+    }
+    nav->searchCount = 0;
+    TraceLog(LOG_INFO, "NAV: %d spans, %d links", nav->spanCount, nav->linkCount);
+}
+
+void MarkNavTileDirty(NavGraph *nav, int tileX, int tileY)
+{
+    if (!nav->dirtyRows || tileX < 0 || tileX >= nav->width)
+        return;
+    // A tile is the floor of the row above it and clearance for the rows below.
+    for (int y = tileY - 1; y <= tileY + NAV_CLEARANCE_TILES - 1; y++)
+    {
+        if (y >= 0 && y < nav->height)
+            nav->dirtyRows[y] = 1;
+    }
+    nav->dirty = true;
+}
+
+int FindNavSpanAt(const NavGraph *nav, Vector2 pos, float radius)
+{
+    if (!nav->spans)
+        return -1;
+    int x = (int)floorf(pos.x / TILE_SIZE);
+    int y = (int)floorf((pos.y + radius - 1.0f) / TILE_SIZE);
+    if (x < 0 || x >= nav->width)
+        return -1;
+    if (y < 0)
+        y = 0;
+    for (; y < nav->height; y++)
+    {
+        int span = GetCellSpan(nav, x, y);
+        if (span >= 0)
+            return span;
+        if (!IsNavPassable(nav, x, y))
+            return -1;
+    }
+    return -1;
+}
+
+static NavPathCache *GetNavPathCache(NavGraph *nav, int goalSpan)
+{
+    NavPathCache *oldest = &nav->cache[0];
+    for (int i = 0; i < NAV_PATH_CACHE_GOALS; i++)
+    {
+        NavPathCache *entry = &nav->cache[i];
+        if (entry->goal == goalSpan)
+        {
+            entry->lastUsed = ++nav->cacheClock;
+            return entry;
+        }
+        if (entry->lastUsed < oldest->lastUsed)
+            oldest = entry;
+    }
+
+    if (!oldest->nextLink)
+    {
+        oldest->nextLink = (int *)arena_alloc(&gameArena, sizeof(int) * nav->spanCount);
+        if (!oldest->nextLink)
+            return NULL;
+    }
+    for (int i = 0; i < nav->spanCount; i++)
+        oldest->nextLink[i] = NAV_UNKNOWN;
+    oldest->nextLink[goalSpan] = NAV_ARRIVED;
+    oldest->goal = goalSpan;
+    oldest->lastUsed = ++nav->cacheClock;
+    return oldest;
+}
+
+static float NavHeuristic(const NavGraph *nav, int span, int x, int goalSpan)
+{
+    const NavSpan *goal = &nav->spans[goalSpan];
+    int gx = (x < goal->x0) ? goal->x0 : (x > goal->x1) ? goal->x1 : x;
+    return (float)(abs(gx - x) + abs(goal->row - nav->spans[span].row));
+}
+
+// A* from start to goal over spans. Walking along a span costs the columns
+// crossed between where the agent entered it and the link it leaves by.
+static void SearchNavPath(NavGraph *nav, NavPathCache *cache, int start, int startX, int goal)
+{
+    nav->searchCount++;
+    unsigned int stamp = ++nav->searchStamp;
+    nav->visited[start] = stamp;
+    nav->closed[start] = stamp;
+    nav->gScore[start] = 0.0f;
+    nav->entryX[start] = startX;
+    nav->cameFrom[start] = -1;
+
+    // Open entries name the link that reached a span; entries whose link is
+    // no longer the span's best are skipped when popped.
+    NavOpenEntry *heap = nav->openHeap;
+    int heapSize = 0;
+    int current = start;
+    while (current != goal)
+    {
+        for (int l = nav->linkFirst[current]; l < nav->linkFirst[current + 1]; l++)
+        {
+            const NavLink *link = &nav->links[l];
+            int to = link->to;
+            if (nav->closed[to] == stamp)
+                continue;
+            float g = nav->gScore[current] + (float)abs(link->fromX - nav->entryX[current]) + link->cost;
+            if (nav->visited[to] == stamp && g >= nav->gScore[to])
+                continue;
+            nav->visited[to] = stamp;
+            nav->gScore[to] = g;
+            nav->entryX[to] = link->toX;
+            nav->cameFrom[to] = l;
+
+            NavOpenEntry entry = {g + NavHeuristic(nav, to, link->toX, goal), l};
+            int i = heapSize++;
+            while (i > 0 && heap[(i - 1) / 2].priority > entry.priority)
+            {
+                heap[i] = heap[(i - 1) / 2];
+                i = (i - 1) / 2;
+            }
+            heap[i] = entry;
+        }
+
+        current = -1;
+        while (heapSize > 0 && current < 0)
+        {
+            int l = heap[0].link;
+            NavOpenEntry last = heap[--heapSize];
+            int i = 0;
+            for (;;)
+            {
+                int child = i * 2 + 1;
+                if (child >= heapSize)
+                    break;
+                if (child + 1 < heapSize && heap[child + 1].priority < heap[child].priority)
+                    child++;
+                if (last.priority <= heap[child].priority)
+                    break;
+                heap[i] = heap[child];
+                i = child;
+            }
+            heap[i] = last;
+
+            int to = nav->links[l].to;
+            if (nav->closed[to] != stamp && nav->cameFrom[to] == l)
+                current = to;
+        }
+        if (current < 0)
+        {
+            cache->nextLink[start] = NAV_NO_PATH;
+            return;
+        }
+        nav->closed[current] = stamp;
+    }
+
+    // Every span on the path now knows its next link toward the goal.
+    for (int span = goal; span != start; span = nav->links[nav->cameFrom[span]].from)
+        cache->nextLink[nav->links[nav->cameFrom[span]].from] = nav->cameFrom[span];
+}
+
+int GetNavNextLink(NavGraph *nav, int fromSpan, int fromX, int goalSpan)
+{
+    if (!nav->links || fromSpan < 0 || goalSpan < 0)
+        return NAV_NO_PATH;
+    NavPathCache *cache = GetNavPathCache(nav, goalSpan);
+    if (!cache)
+        return NAV_NO_PATH;
+    if (cache->nextLink[fromSpan] == NAV_UNKNOWN)
+        SearchNavPath(nav, cache, fromSpan, fromX, goalSpan);
+    return cache->nextLink[fromSpan];
+}
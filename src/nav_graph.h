@@ -0,0 +1,111 @@
+#ifndef NAV_GRAPH_H
+#define NAV_GRAPH_H
+
+#include <raylib.h>
+#include <stdint.h>
+
+// Free tiles an agent needs above the floor it stands on.
+#define NAV_CLEARANCE_TILES 2
+// Reach of a ground enemy jump, in tiles.
+#define NAV_MAX_JUMP_UP 2
+#define NAV_MAX_JUMP_DOWN 2
+#define NAV_MAX_JUMP_GAP 1
+// Extra cost of a jump over walking the same distance, in tiles.
+#define NAV_JUMP_COST 2.0f
+// Number of goal spans whose paths are cached at once.
+#define NAV_PATH_CACHE_GOALS 8
+
+// Results of GetNavNextLink besides a link index.
+#define NAV_ARRIVED -1
+#define NAV_NO_PATH -2
+
+typedef enum NavLinkType
+{
+    NAV_LINK_FALL = 0, // Walk off the end of the span and drop.
+    NAV_LINK_JUMP,
+} NavLinkType;
+
+// A maximal run of walkable tiles in one row: cells [x0, x1] of row, each
+// with a ground tile below and NAV_CLEARANCE_TILES free tiles at and above it.
+typedef struct NavSpan
+{
+    int row;
+    int x0;
+    int x1;
+} NavSpan;
+
+// Leave span from at column fromX and land on span to at column toX.
+typedef struct NavLink
+{
+    int from;
+    int to;
+    int fromX;
+    int toX;
+    float cost;
+    NavLinkType type;
+} NavLink;
+
+// Next link toward one goal span for every span a search has reached.
+typedef struct NavPathCache
+{
+    int goal;
+    unsigned int lastUsed;
+    int *nextLink;
+} NavPathCache;
+
+typedef struct NavOpenEntry
+{
+    float priority;
+    int link;
+} NavOpenEntry;
+
+// Platform graph built from the tile collision data. Spans are stored row by
+// row; links are grouped by their source span (linkFirst[s] .. linkFirst[s + 1]).
+// Editing tiles only rescans the rows around them; links are then rebuilt
+// from the span list, which is far smaller than the tile grid.
+typedef struct NavGraph
+{
+    unsigned int **tiles; // Tilemap the graph was built from.
+    int width;
+    int height;
+
+    NavSpan *spans;
+    int spanCount;
+    int *rowFirstSpan;  // height + 1 entries.
+    int16_t *cellSpan;  // Span index within its row per cell, or -1.
+    uint8_t *dirtyRows;
+    bool dirty;
+
+    NavLink *links;
+    int linkCount;
+    int *linkFirst; // spanCount + 1 entries.
+
+    // A* scratch, sized to the graph.
+    float *gScore;
+    int *cameFrom;
+    int *entryX;
+    unsigned int *visited; // Equal to searchStamp once reached by the current search.
+    unsigned int *closed;
+    unsigned int searchStamp;
+    NavOpenEntry *openHeap;
+
+    NavPathCache cache[NAV_PATH_CACHE_GOALS];
+    unsigned int cacheClock;
+    int searchCount; // A* searches run since the graph was built.
+} NavGraph;
+
+// Bring the graph up to date with mapTiles: a full build for a new map,
+// otherwise only the rows marked dirty. Drops all cached paths if anything changed.
+void UpdateNavGraph(NavGraph *nav);
+void MarkNavTileDirty(NavGraph *nav, int tileX, int tileY);
+void FreeNavGraph(NavGraph *nav);
+
+// Span under a circle at pos, or the first span below it when airborne. -1 if none.
+int FindNavSpanAt(const NavGraph *nav, Vector2 pos, float radius);
+
+// First link to take from fromSpan (starting at column fromX) toward goalSpan.
+// Returns a link index, NAV_ARRIVED or NAV_NO_PATH. Paths are cached per goal
+// and shared by every agent heading to the same span.
+int GetNavNextLink(NavGraph *nav, int fromSpan, int fromX, int goalSpan);
+
+#endif
@@ -0,0 +1,296 @@
+#include "particles.h"
+#include "memory_arena.h"
+#include <math.h>
+#include <string.h>
+
+#if PARTICLE_KERNEL_WIDTH > 1
+#include <immintrin.h>
+#endif
+
+const ParticleBurst particleEffects[PARTICLE_EFFECT_COUNT] = {
+    // count, speed, spread, life, size, gravity, color, jitter, random color
+    {10, 80.0f, 220.0f, 0.6f, 0.15f, 0.35f, 1.5f, 3.0f, 300.0f, {255, 220, 120, 255}, 30, false},    // Hit
+    {48, 60.0f, 260.0f, PI, 0.4f, 0.9f, 2.0f, 4.0f, 400.0f, {140, 255, 90, 255}, 40, false},         // Death
+    {6, 150.0f, 300.0f, 0.35f, 0.05f, 0.12f, 1.5f, 2.5f, 0.0f, {255, 240, 180, 255}, 15, false},     // Muzzle flash
+    {80, 60.0f, 300.0f, PI, 1.0f, 3.0f, 1.5f, 2.5f, 40.0f, {255, 255, 255, 255}, 40, true},          // Firework
+};
+
+// xorshift32; the seed must never be zero.
+static float RandomUnit(uint32_t *seed)
+{
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+static float RandomRange(uint32_t *seed, float lo, float hi)
+{
+    return lo + (hi - lo) * RandomUnit(seed);
+}
+
+static unsigned char JitterChannel(uint32_t *seed, unsigned char value, int jitter)
+{
+    int v = value + (int)RandomRange(seed, (float)-jitter, (float)jitter + 1.0f);
+    return (unsigned char)((v < 0) ? 0 : (v > 255) ? 255 : v);
+}
+
+void InitParticleSystem(ParticleSystem *system, int limit, uint32_t seed)
+{
+    memset(system, 0, sizeof(ParticleSystem));
+    system->limit = limit;
+    system->seed = (seed != 0) ? seed : 0x9E3779B9u;
+}
+
+void FreeParticleSystem(ParticleSystem *system)
+{
+    // Every array shares the block that starts at posX.
+    if (system->posX)
+        arena_free(&assetArena, system->posX);
+    int limit = system->limit;
+    uint32_t seed = system->seed;
+    InitParticleSystem(system, limit, seed);
+}
+
+void ClearParticles(ParticleSystem *system)
+{
+    system->count = 0;
+}
+
+// Double the capacity until it holds at least minCapacity particles (clamped
+// to the limit), moving the live particles into one new block that holds all
+// the arrays and the kernel mask.
+static bool GrowParticleSystem(ParticleSystem *system, int minCapacity)
+{
+    int newCapacity = (system->capacity > 0) ? system->capacity * 2 : PARTICLE_POOL_INITIAL_CAPACITY;
+    while (newCapacity < minCapacity)
+        newCapacity *= 2;
+    if (newCapacity > system->limit)
+        newCapacity = system->limit;
+    if (newCapacity <= system->capacity)
+        return false;
+
+    float *block = (float *)arena_alloc(&assetArena, (sizeof(float) * 8 + sizeof(Color)) * newCapacity +
+                                                         PARTICLE_MASK_BYTES(newCapacity));
+    if (!block)
+    {
+        TraceLog(LOG_ERROR, "Failed to grow particle system to %d particles!", newCapacity);
+        return false;
+    }
+
+    float *oldBlock = system->posX;
+    float **arrays[8] = {&system->posX, &system->posY, &system->velX, &system->velY,
+                         &system->gravity, &system->life, &system->fade, &system->size};
+    Color *color = (Color *)(block + newCapacity * 8);
+    for (int a = 0; a < 8; a++)
+    {
+        float *moved = block + newCapacity * a;
+        if (*arrays[a])
+            memcpy(moved, *arrays[a], sizeof(float) * system->count);
+        *arrays[a] = moved;
+    }
+    if (oldBlock)
+    {
+        memcpy(color, system->color, sizeof(Color) * system->count);
+        arena_free(&assetArena, oldBlock);
+    }
+    system->color = color;
+    system->mask = (uint8_t *)(color + newCapacity);
+    system->capacity = newCapacity;
+    return true;
+}
+
+int EmitParticleBurst(ParticleSystem *system, const ParticleBurst *burst, Vector2 position, Vector2 direction)
+{
+    int count = burst->count;
+    if (count > system->limit - system->count)
+        count = system->limit - system->count;
+    if (count <= 0)
+        return 0;
+    if (system->count + count > system->capacity && !GrowParticleSystem(system, system->count + count))
+        return 0;
+
+    uint32_t *seed = &system->seed;
+    float baseAngle = (direction.x == 0.0f && direction.y == 0.0f) ? -PI / 2 : atan2f(direction.y, direction.x);
+    Color base = burst->color;
+    if (burst->randomColor)
+    {
+        // One bright channel mix per burst, like the old fireworks' 100..255 range.
+        base = (Color){(unsigned char)RandomRange(seed, 100.0f, 256.0f), (unsigned char)RandomRange(seed, 100.0f, 256.0f),
+                       (unsigned char)RandomRange(seed, 100.0f, 256.0f), 255};
+    }
+
+    for (int n = 0; n < count; n++)
+    {
+        int i = system->count + n;
+        float angle = baseAngle + RandomRange(seed, -burst->spread, burst->spread);
+        float speed = RandomRange(seed, burst->speedMin, burst->speedMax);
+        float lifetime = RandomRange(seed, burst->lifeMin, burst->lifeMax);
+        system->posX[i] = position.x;
+        system->posY[i] = position.y;
+        system->velX[i] = cosf(angle) * speed;
+        system->velY[i] = sinf(angle) * speed;
+        system->gravity[i] = burst->gravity;
+        system->life[i] = lifetime;
+        system->fade[i] = (lifetime > 0.0f) ? 1.0f / lifetime : 1.0f;
+        system->size[i] = RandomRange(seed, burst->sizeMin, burst->sizeMax);
+        system->color[i] = (Color){JitterChannel(seed, base.r, burst->colorJitter),
+                                   JitterChannel(seed, base.g, burst->colorJitter),
+                                   JitterChannel(seed, base.b, burst->colorJitter), base.a};
+    }
+    system->count += count;
+    return count;
+}
+
+int EmitParticleEffect(ParticleSystem *system, ParticleEffect effect, Vector2 position, Vector2 direction)
+{
+    return EmitParticleBurst(system, &particleEffects[effect], position, direction);
+}
+
+void UpdateParticleEmitter(ParticleSystem *system, ParticleEmitter *emitter, float deltaTime)
+{
+    emitter->timer += deltaTime;
+    while (emitter->interval > 0.0f && emitter->timer >= emitter->interval)
+    {
+        emitter->timer -= emitter->interval;
+        Vector2 origin = {RandomRange(&system->seed, emitter->area.x, emitter->area.x + emitter->area.width),
+                          RandomRange(&system->seed, emitter->area.y, emitter->area.y + emitter->area.height)};
+        EmitParticleEffect(system, emitter->effect, origin, emitter->direction);
+    }
+}
+
+// Scalar tail shared by the SIMD kernel. start must be a multiple of 8 so
+// every mask byte is written whole.
+static int IntegrateParticleRange(ParticleSystem *system, int start, float deltaTime, uint8_t *deadMask)
+{
+    int expired = 0;
+    for (int base = start; base < system->count; base += 8)
+    {
+        unsigned bits = 0;
+        int end = (base + 8 < system->count) ? base + 8 : system->count;
+        for (int i = base; i < end; i++)
+        {
+            float vy = system->velY[i] + system->gravity[i] * deltaTime;
+            system->velY[i] = vy;
+            system->posX[i] += system->velX[i] * deltaTime;
+            system->posY[i] += vy * deltaTime;
+            float life = system->life[i] - deltaTime;
+            system->life[i] = life;
+            if (life <= 0.0f)
+            {
+                bits |= 1u << (i - base);
+                expired++;
+            }
+        }
+        deadMask[base >> 3] = (uint8_t)bits;
+    }
+    return expired;
+}
+
+int IntegrateParticlesScalar(ParticleSystem *system, float deltaTime, uint8_t *deadMask)
+{
+    return IntegrateParticleRange(system, 0, deltaTime, deadMask);
+}
+
+#if PARTICLE_KERNEL_WIDTH > 1 && defined(__AVX__)
+
+int IntegrateParticlesSimd(ParticleSystem *system, float deltaTime, uint8_t *deadMask)
+{
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 zero = _mm256_setzero_ps();
+    int expired = 0;
+    int i = 0;
+    for (; i + 8 <= system->count; i += 8)
+    {
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(system->velY + i), _mm256_mul_ps(_mm256_loadu_ps(system->gravity + i), dt));
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(system->posX + i), _mm256_mul_ps(_mm256_loadu_ps(system->velX + i), dt));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(system->posY + i), _mm256_mul_ps(vy, dt));
+        __m256 life = _mm256_sub_ps(_mm256_loadu_ps(system->life + i), dt);
+        _mm256_storeu_ps(system->velY + i, vy);
+        _mm256_storeu_ps(system->posX + i, x);
+        _mm256_storeu_ps(system->posY + i, y);
+        _mm256_storeu_ps(system->life + i, life);
+        unsigned bits = (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(life, zero, _CMP_LE_OQ));
+        deadMask[i >> 3] = (uint8_t)bits;
+        expired += __builtin_popcount(bits);
+    }
+    return expired + IntegrateParticleRange(system, i, deltaTime, deadMask);
+}
+
+#elif PARTICLE_KERNEL_WIDTH > 1
+
+int IntegrateParticlesSimd(ParticleSystem *system, float deltaTime, uint8_t *deadMask)
+{
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+    int expired = 0;
+    int i = 0;
+    for (; i + 8 <= system->count; i += 8)
+    {
+        unsigned bits = 0;
+        for (int half = 0; half < 8; half += 4)
+        {
+            int j = i + half;
+            __m128 vy = _mm_add_ps(_mm_loadu_ps(system->velY + j), _mm_mul_ps(_mm_loadu_ps(system->gravity + j), dt));
+            __m128 x = _mm_add_ps(_mm_loadu_ps(system->posX + j), _mm_mul_ps(_mm_loadu_ps(system->velX + j), dt));
+            __m128 y = _mm_add_ps(_mm_loadu_ps(system->posY + j), _mm_mul_ps(vy, dt));
+            __m128 life = _mm_sub_ps(_mm_loadu_ps(system->life + j), dt);
+            _mm_storeu_ps(system->velY + j, vy);
+            _mm_storeu_ps(system->posX + j, x);
+            _mm_storeu_ps(system->posY + j, y);
+            _mm_storeu_ps(system->life + j, life);
+            bits |= (unsigned)_mm_movemask_ps(_mm_cmple_ps(life, zero)) << half;
+        }
+        deadMask[i >> 3] = (uint8_t)bits;
+        expired += __builtin_popcount(bits);
+    }
+    return expired + IntegrateParticleRange(system, i, deltaTime, deadMask);
+}
+
+#else
+
+int IntegrateParticlesSimd(ParticleSystem *system, float deltaTime, uint8_t *deadMask)
+{
+    return IntegrateParticleRange(system, 0, deltaTime, deadMask);
+}
+
+#endif
+
+static void RemoveParticle(ParticleSystem *system, int index)
+{
+    int last = --system->count;
+    system->posX[index] = system->posX[last];
+    system->posY[index] = system->posY[last];
+    system->velX[index] = system->velX[last];
+    system->velY[index] = system->velY[last];
+    system->gravity[index] = system->gravity[last];
+    system->life[index] = system->life[last];
+    system->fade[index] = system->fade[last];
+    system->size[index] = system->size[last];
+    system->color[index] = system->color[last];
+}
+
+void CompactParticles(ParticleSystem *system, const uint8_t *mask)
+{
+    // Walk backwards so every particle swapped into a hole has already been
+    // visited and is known to be alive.
+    for (int byteIndex = PARTICLE_MASK_BYTES(system->count) - 1; byteIndex >= 0; byteIndex--)
+    {
+        unsigned bits = mask[byteIndex];
+        if (bits == 0)
+            continue;
+        for (int bit = 7; bit >= 0; bit--)
+        {
+            if (bits & (1u << bit))
+                RemoveParticle(system, byteIndex * 8 + bit);
+        }
+    }
+}
+
+void UpdateParticles(ParticleSystem *system, float deltaTime)
+{
+    if (system->count > 0 && IntegrateParticlesSimd(system, deltaTime, system->mask) > 0)
+        CompactParticles(system, system->mask);
+}
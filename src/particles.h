@@ -0,0 +1,101 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <raylib.h>
+#include <stdint.h>
+
+#define PARTICLE_POOL_INITIAL_CAPACITY 256
+#define MAX_EFFECT_PARTICLES 16384
+#define MAX_FIREWORK_PARTICLES 8192
+
+// Particles handled per kernel iteration: one AVX or two SSE registers.
+#if defined(__AVX__) || defined(__SSE2__)
+#define PARTICLE_KERNEL_WIDTH 8
+#else
+#define PARTICLE_KERNEL_WIDTH 1
+#endif
+
+// Bytes needed for a particle mask covering count particles (one bit per particle).
+#define PARTICLE_MASK_BYTES(count) (((count) + 7) / 8)
+
+// Live particles as parallel arrays, kept dense in [0, count) like a
+// BulletPool: bursts append and dead particles are swap-removed. Storage
+// doubles on demand up to limit. Particles are presentation only; they never
+// feed back into the simulation and draw their randomness from seed, not
+// from raylib's generator.
+typedef struct ParticleSystem
+{
+    float *posX;
+    float *posY;
+    float *velX;
+    float *velY;
+    float *gravity; // Downward acceleration in pixels per second squared.
+    float *life;    // Seconds left.
+    float *fade;    // 1 / lifetime, so life * fade runs from 1 down to 0.
+    float *size;    // Radius at spawn; shrinks to half by the end of its life.
+    Color *color;
+    uint8_t *mask;
+    int count;
+    int capacity;
+    int limit;
+    uint32_t seed;
+} ParticleSystem;
+
+// How one burst spawns its particles. Ranges are picked uniformly per particle.
+typedef struct ParticleBurst
+{
+    int count;
+    float speedMin, speedMax; // Pixels per second.
+    float spread;             // Half-angle in radians around the burst direction; PI for all around.
+    float lifeMin, lifeMax;   // Seconds.
+    float sizeMin, sizeMax;   // Radius in pixels.
+    float gravity;
+    Color color;
+    int colorJitter;  // Per channel, added or subtracted at random.
+    bool randomColor; // Pick one bright color per burst instead of color.
+} ParticleBurst;
+
+typedef enum ParticleEffect
+{
+    PARTICLE_EFFECT_HIT = 0,
+    PARTICLE_EFFECT_DEATH,
+    PARTICLE_EFFECT_MUZZLE,
+    PARTICLE_EFFECT_FIREWORK,
+    PARTICLE_EFFECT_COUNT
+} ParticleEffect;
+
+extern const ParticleBurst particleEffects[PARTICLE_EFFECT_COUNT];
+
+// Fires a burst every interval seconds at a random point inside area.
+typedef struct ParticleEmitter
+{
+    ParticleEffect effect;
+    Rectangle area;
+    Vector2 direction;
+    float interval;
+    float timer;
+} ParticleEmitter;
+
+void InitParticleSystem(ParticleSystem *system, int limit, uint32_t seed);
+void FreeParticleSystem(ParticleSystem *system);
+void ClearParticles(ParticleSystem *system);
+
+// Spawn a burst at position, aimed along direction (need not be normalized;
+// zero means straight up). Returns how many particles fit under the limit.
+int EmitParticleBurst(ParticleSystem *system, const ParticleBurst *burst, Vector2 position, Vector2 direction);
+int EmitParticleEffect(ParticleSystem *system, ParticleEffect effect, Vector2 position, Vector2 direction);
+void UpdateParticleEmitter(ParticleSystem *system, ParticleEmitter *emitter, float deltaTime);
+
+// Integrate every particle over deltaTime seconds (velocity, then position)
+// and set its bit in deadMask once its life runs out. Returns the number of
+// bits set.
+int IntegrateParticlesScalar(ParticleSystem *system, float deltaTime, uint8_t *deadMask);
+int IntegrateParticlesSimd(ParticleSystem *system, float deltaTime, uint8_t *deadMask);
+
+// Swap-remove every particle whose bit is set in mask.
+void CompactParticles(ParticleSystem *system, const uint8_t *mask);
+
+// Integrate and remove the expired particles.
+void UpdateParticles(ParticleSystem *system, float deltaTime);
+
+#endif
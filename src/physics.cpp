@@ -130,60 +130,97 @@ bool CheckTileCollision(Vector2 pos, float radius)
     // Test the bottom center point of the entity’s circle
     Vector2 bottom = {pos.x, pos.y + radius};
     unsigned int tileId = GetTileAt(bottom);
-    if (tileId == 0)
-        return false;
+    return GetTilePhysics(tileId) == TILE_PHYS_GROUND;
+}
 
-    // Decode tile physics for that tile
-    int tilePhysics = TILE_PHYS_NONE;
-    if (tileId >= 0x100000)
-    {
-        tilePhysics = (tileId >> 16) & 0xF;
-    }
-    else
+bool HasLineOfSight(Vector2 from, Vector2 to, int *tilesVisited)
+{
+    int x = (int)floorf(from.x / TILE_SIZE);
+    int y = (int)floorf(from.y / TILE_SIZE);
+    int endX = (int)floorf(to.x / TILE_SIZE);
+    int endY = (int)floorf(to.y / TILE_SIZE);
+    float dx = to.x - from.x;
+    float dy = to.y - from.y;
+    int stepX = (dx > 0) ? 1 : -1;
+    int stepY = (dy > 0) ? 1 : -1;
+
+    // Distance along the segment (0..1) to the next vertical and horizontal tile edge.
+    float deltaX = (dx != 0) ? fabsf(TILE_SIZE / dx) : INFINITY;
+    float deltaY = (dy != 0) ? fabsf(TILE_SIZE / dy) : INFINITY;
+    float nextX = (dx != 0) ? ((stepX > 0) ? (x + 1) * TILE_SIZE - from.x : from.x - x * TILE_SIZE) / fabsf(dx) : INFINITY;
+    float nextY = (dy != 0) ? ((stepY > 0) ? (y + 1) * TILE_SIZE - from.y : from.y - y * TILE_SIZE) / fabsf(dy) : INFINITY;
+
+    int visited = 0;
+    bool clear = true;
+    while (x != endX || y != endY)
     {
-        if (tileId == 1)
-            tilePhysics = TILE_PHYS_GROUND;
-        else if (tileId == 2)
-            tilePhysics = TILE_PHYS_DEATH;
+        if (nextX < nextY)
+        {
+            nextX += deltaX;
+            x += stepX;
+        }
+        else
+        {
+            nextY += deltaY;
+            y += stepY;
+        }
+        visited++;
+        // Safety net against float drift walking past the end tile.
+        if ((x == endX && y == endY) || visited > currentMapWidth + currentMapHeight)
+            break;
+        if (x < 0 || x >= currentMapWidth || y < 0 || y >= currentMapHeight)
+            continue;
+        if (GetTilePhysics(mapTiles[y][x]) == TILE_PHYS_GROUND)
+        {
+            clear = false;
+            break;
+        }
     }
-    return (tilePhysics == TILE_PHYS_GROUND);
+    if (tilesVisited)
+        *tilesVisited = visited;
+    return clear;
 }
 
-void UpdateEntityPhysics(Entity *e, float dt, float totalTime)
+// bob is the flying offset from basePos, PHYSICS_AMPLITUDE * sinf(totalTime *
+// PHYSICS_FREQUENCY); it is the same for every flyer, so passes over many
+// bodies work it out once.
+static void StepBody(PhysicsType type, float radius, Vector2 *position, Vector2 *basePos, Vector2 *velocity,
+                     int *health, EntityState *state, float dt, float bob)
 {
-    switch (e->physicsType)
+    switch (type)
     {
     case PHYS_GROUND:
     {
         // Apply gravity.
-        e->velocity.y += PHYSICS_GRAVITY * dt;
+        velocity->y += PHYSICS_GRAVITY * dt;
         
-        e->position.x += e->velocity.x * dt;
-        e->position.y += e->velocity.y * dt;
+        position->x += velocity->x * dt;
+        position->y += velocity->y * dt;
         // Resolve collisions with tiles.
-        ResolveCircleTileCollisions(&e->position, &e->velocity, &e->health, e->radius);
+        ResolveCircleTileCollisions(position, velocity, health, radius);
 
         // Update entity state (idle, walk, etc.)
-        bool onGround = (fabsf(e->velocity.y) < 0.001f) || CheckTileCollision(e->position, e->radius);
+        bool onGround = (fabsf(velocity->y) < 0.001f) || CheckTileCollision(*position, radius);
         if (!onGround)
         {
-            e->state = (e->velocity.y < 0.0f) ? ENTITY_STATE_ASCEND : ENTITY_STATE_FALL;
+            *state = (velocity->y < 0.0f) ? ENTITY_STATE_ASCEND : ENTITY_STATE_FALL;
         }
-        else if (fabsf(e->velocity.x) > 0.1f)
+        else if (fabsf(velocity->x) > 0.1f)
         {
-            e->state = ENTITY_STATE_WALK;
+            *state = ENTITY_STATE_WALK;
         }
         else
         {
-            e->state = ENTITY_STATE_IDLE;
+            *state = ENTITY_STATE_IDLE;
         }
         break;
     }
     case PHYS_FLYING:
     {
-        e->position.x += e->velocity.x * dt;
-        e->position.y = e->basePos.y + PHYSICS_AMPLITUDE * sinf(totalTime * PHYSICS_FREQUENCY);
-        e->state = (fabsf(e->velocity.x) > 0.1f) ? ENTITY_STATE_WALK : ENTITY_STATE_IDLE;
+        position->x += velocity->x * dt;
+        basePos->y += velocity->y * dt;
+        position->y = basePos->y + bob;
+        *state = (fabsf(velocity->x) > 0.1f) ? ENTITY_STATE_WALK : ENTITY_STATE_IDLE;
         break;
     }
     default:
@@ -191,9 +228,34 @@ void UpdateEntityPhysics(Entity *e, float dt, float totalTime)
     }
 
     // If the entity falls below the map, kill it.
-    if (e->position.y - e->radius > currentMapHeight * TILE_SIZE)
+    if (position->y - radius > currentMapHeight * TILE_SIZE)
+    {
+        *health = 0;
+    }
+}
+
+void UpdateBodyPhysics(PhysicsType type, float radius, Vector2 *position, Vector2 *basePos, Vector2 *velocity,
+                       int *health, EntityState *state, float dt, float totalTime)
+{
+    float bob = (type == PHYS_FLYING) ? PHYSICS_AMPLITUDE * sinf(totalTime * PHYSICS_FREQUENCY) : 0.0f;
+    StepBody(type, radius, position, basePos, velocity, health, state, dt, bob);
+}
+
+void UpdateEntityPhysics(Entity *e, float dt, float totalTime)
+{
+    UpdateBodyPhysics(e->physicsType, e->radius, &e->position, &e->basePos, &e->velocity,
+                      &e->health, &e->state, dt, totalTime);
+}
+
+void UpdateArchetypePhysics(EntityArchetype *arch, float dt, float totalTime)
+{
+    float bob = PHYSICS_AMPLITUDE * sinf(totalTime * PHYSICS_FREQUENCY);
+    for (int n = 0; n < arch->liveCount; n++)
     {
-        e->health = 0;
+        int i = arch->live[n];
+        PhysicsComponent *body = &arch->physics[i];
+        StepBody(body->type, body->radius, &arch->position[i], &arch->basePos[i], &arch->velocity[i],
+                 &arch->combat[i].health, &body->state, dt, bob);
     }
 }
 
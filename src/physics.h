@@ -3,6 +3,7 @@
 
 #include <raylib.h>
 #include "entity.h"
+#include "entity_store.h"
 
 #define PHYSICS_GRAVITY 1000.0f
 #define PHYSICS_AMPLITUDE 30.0f
@@ -11,7 +12,16 @@
 
 void ResolveCircleTileCollisions(Vector2 *pos, Vector2 *vel, int *health, float radius);
 bool CheckTileCollision(Vector2 pos, float radius);
+// Walk the tiles on the segment from -> to; true when no ground tile blocks it.
+// tilesVisited (optional) receives the number of tiles stepped through.
+bool HasLineOfSight(Vector2 from, Vector2 to, int *tilesVisited);
+// Move one body by its physics type: gravity and tile collisions on the
+// ground, a sine bob in the air. Kills it (health 0) below the map.
+void UpdateBodyPhysics(PhysicsType type, float radius, Vector2 *position, Vector2 *basePos, Vector2 *velocity,
+                       int *health, EntityState *state, float dt, float totalTime);
 void UpdateEntityPhysics(Entity *e, float dt, float totalTime);
+// Physics for the archetype's live rows (see GatherLiveRows).
+void UpdateArchetypePhysics(EntityArchetype *arch, float dt, float totalTime);
 void UpdateEntities(Entity *entities, int count, float dt, float totalTime);
 
 #endif
@@ -0,0 +1,114 @@
+#include "render_snapshot.h"
+#include "game_state.h"
+#include <string.h>
+
+MemoryArena snapshotArena;
+
+// Grow *array to hold at least count elements of size bytes, doubling.
+static bool ReserveSnapshotArray(void **array, int *capacity, int count, size_t size)
+{
+    if (count <= *capacity)
+        return true;
+    int newCapacity = (*capacity > 0) ? *capacity * 2 : 256;
+    while (newCapacity < count)
+        newCapacity *= 2;
+    void *grown = arena_realloc(&snapshotArena, *array, size * newCapacity);
+    if (!grown)
+    {
+        TraceLog(LOG_ERROR, "Render snapshot can't grow to %d entries!", newCapacity);
+        return false;
+    }
+    *array = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+static void CaptureArchetype(const EntityArchetype *arch, RenderSnapshot *snapshot)
+{
+    if (!ReserveSnapshotArray((void **)&snapshot->entities, &snapshot->entityCapacity,
+                              snapshot->entityCount + arch->count, sizeof(RenderEntity)))
+        return;
+    for (int i = 0; i < arch->count; i++)
+    {
+        if (arch->combat[i].health <= 0)
+            continue;
+        const PhysicsComponent *body = &arch->physics[i];
+        snapshot->entities[snapshot->entityCount++] =
+            (RenderEntity){arch->asset[i], arch->position[i], body->radius, body->direction, body->state, arch->anim[i]};
+    }
+}
+
+static void CaptureBullets(const BulletStore *store, RenderSnapshot *snapshot)
+{
+    snapshot->bulletCount = 0;
+    int total = GetBulletCount(store);
+    if (total > snapshot->bulletCapacity)
+    {
+        // Both arrays share one block starting at bulletX; the old contents
+        // are about to be overwritten, so nothing is copied.
+        int capacity = (snapshot->bulletCapacity > 0) ? snapshot->bulletCapacity * 2 : 256;
+        while (capacity < total)
+            capacity *= 2;
+        if (snapshot->bulletX)
+            arena_free(&snapshotArena, snapshot->bulletX);
+        snapshot->bulletX = (float *)arena_alloc(&snapshotArena, sizeof(float) * 2 * capacity);
+        snapshot->bulletY = snapshot->bulletX ? snapshot->bulletX + capacity : NULL;
+        snapshot->bulletCapacity = snapshot->bulletX ? capacity : 0;
+        if (!snapshot->bulletX)
+        {
+            TraceLog(LOG_ERROR, "Render snapshot can't grow to %d bullets!", capacity);
+            return;
+        }
+    }
+
+    for (int p = 0; p < BULLET_OWNER_COUNT; p++)
+    {
+        const BulletPool *pool = &store->pools[p];
+        if (pool->count == 0)
+            continue;
+        memcpy(snapshot->bulletX + snapshot->bulletCount, pool->posX, sizeof(float) * pool->count);
+        memcpy(snapshot->bulletY + snapshot->bulletCount, pool->posY, sizeof(float) * pool->count);
+        snapshot->bulletCount += pool->count;
+    }
+}
+
+void CaptureRenderSnapshot(const GameState *state, RenderSnapshot *snapshot)
+{
+    const EntityArchetype *enemies = &state->entities.archetypes[ARCHETYPE_ENEMY];
+    const EntityArchetype *boss = &state->entities.archetypes[ARCHETYPE_BOSS];
+
+    snapshot->currentState = state->currentState;
+    snapshot->player = state->player;
+    snapshot->entityCount = 0;
+    CaptureArchetype(enemies, snapshot);
+    if (state->bossActive)
+        CaptureArchetype(boss, snapshot);
+    CaptureBullets(&state->bullets, snapshot);
+
+    snapshot->checkpointCount = 0;
+    if (ReserveSnapshotArray((void **)&snapshot->checkpoints, &snapshot->checkpointCapacity, state->checkpointCount,
+                             sizeof(Vector2)))
+    {
+        if (state->checkpointCount > 0)
+            memcpy(snapshot->checkpoints, state->checkpoints, sizeof(Vector2) * state->checkpointCount);
+        snapshot->checkpointCount = state->checkpointCount;
+    }
+    snapshot->currentCheckpointIndex = state->currentCheckpointIndex;
+    snapshot->bossActive = state->bossActive;
+    snapshot->bossHealth = 0;
+    snapshot->bossMaxHealth = 1;
+    if (state->bossActive && boss->count > 0 && boss->combat[0].health > 0)
+    {
+        snapshot->bossHealth = boss->combat[0].health;
+        snapshot->bossMaxHealth = GetEntityAsset(boss->asset[0])->baseHp;
+    }
+
+    snapshot->aiThinks = state->ai.thinks;
+    snapshot->aiQueueDepth = state->ai.queueDepth;
+    snapshot->aiCostUs = state->ai.costUs;
+    snapshot->aiMeasuredUs = state->ai.measuredUs;
+    snapshot->aiOverrunTicks = state->ai.overrunTicks;
+    snapshot->navSearches = state->nav.searchCount;
+    snapshot->enemyRows = enemies->count;
+    snapshot->enemyCapacity = enemies->capacity;
+}
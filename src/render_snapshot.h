@@ -0,0 +1,68 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <raylib.h>
+#include "entity.h"
+#include "game_sim.h"
+
+#define RENDER_SNAPSHOT_ARENA_SIZE (8 * 1024 * 1024)
+
+// Just what drawing one entity needs.
+typedef struct RenderEntity
+{
+    EntityAssetHandle asset;
+    Vector2 position;
+    float radius;
+    int direction;
+    EntityState state;
+    AnimationComponent anim;
+} RenderEntity;
+
+// Everything the PLAY screen draws, copied out of the GameState after a
+// tick, so the main thread can draw it while the next tick runs (see
+// sim_thread.h). Arrays grow in the snapshot arena and are reused.
+typedef struct RenderSnapshot
+{
+    GameStateType currentState;
+    Entity player;
+
+    // Living enemies in row order, then the boss while it is active.
+    RenderEntity *entities;
+    int entityCount;
+    int entityCapacity;
+
+    float *bulletX;
+    float *bulletY;
+    int bulletCount;
+    int bulletCapacity;
+
+    Vector2 *checkpoints;
+    int checkpointCount;
+    int checkpointCapacity;
+    int currentCheckpointIndex;
+    bool bossActive;
+    int bossHealth;
+    int bossMaxHealth;
+
+    // Stats overlay.
+    int aiThinks;
+    int aiQueueDepth;
+    float aiCostUs;
+    float aiMeasuredUs;
+    int aiOverrunTicks;
+    int navSearches;
+    int enemyRows;
+    int enemyCapacity;
+
+    // What the tick that produced the snapshot reported.
+    SimEvents events;
+} RenderSnapshot;
+
+// Snapshot storage. Only touched by whichever thread is capturing, never by
+// both at once, so it is kept apart from the game and asset arenas.
+extern MemoryArena snapshotArena;
+
+// Copy the drawable parts of state into snapshot. Leaves snapshot->events alone.
+void CaptureRenderSnapshot(const GameState *state, RenderSnapshot *snapshot);
+
+#endif
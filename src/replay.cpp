@@ -0,0 +1,242 @@
+#include <string.h>
+#include "replay.h"
+#include "game_storage.h"
+#include "timing.h"
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static uint32_t HashBytes(uint32_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Only the simulated fields are hashed; animation state and padding are not.
+static uint32_t HashEntity(uint32_t hash, const Entity *e)
+{
+    hash = HashBytes(hash, &e->position, sizeof(e->position));
+    hash = HashBytes(hash, &e->velocity, sizeof(e->velocity));
+    hash = HashBytes(hash, &e->health, sizeof(e->health));
+    hash = HashBytes(hash, &e->shootTimer, sizeof(e->shootTimer));
+    hash = HashBytes(hash, &e->direction, sizeof(e->direction));
+    return hash;
+}
+
+// Same fields as HashEntity, from an entity store row.
+static uint32_t HashEntityRow(uint32_t hash, const EntityArchetype *arch, int row)
+{
+    hash = HashBytes(hash, &arch->position[row], sizeof(arch->position[row]));
+    hash = HashBytes(hash, &arch->velocity[row], sizeof(arch->velocity[row]));
+    hash = HashBytes(hash, &arch->combat[row].health, sizeof(arch->combat[row].health));
+    hash = HashBytes(hash, &arch->combat[row].shootTimer, sizeof(arch->combat[row].shootTimer));
+    hash = HashBytes(hash, &arch->physics[row].direction, sizeof(arch->physics[row].direction));
+    return hash;
+}
+
+uint32_t HashGameState(const GameState *state)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    const EntityArchetype *enemies = &state->entities.archetypes[ARCHETYPE_ENEMY];
+    const EntityArchetype *boss = &state->entities.archetypes[ARCHETYPE_BOSS];
+    hash = HashEntity(hash, &state->player);
+    // Dead rows leave the store, so the row counts are part of the state.
+    hash = HashBytes(hash, &enemies->count, sizeof(enemies->count));
+    for (int i = 0; i < enemies->count; i++)
+        hash = HashEntityRow(hash, enemies, i);
+    hash = HashBytes(hash, &boss->count, sizeof(boss->count));
+    for (int i = 0; i < boss->count; i++)
+        hash = HashEntityRow(hash, boss, i);
+    for (int i = 0; i < state->spawnerCount; i++)
+    {
+        const EntitySpawner *spawner = &state->spawners[i];
+        hash = HashBytes(hash, &spawner->timer, sizeof(spawner->timer));
+        hash = HashBytes(hash, &spawner->spawned, sizeof(spawner->spawned));
+        hash = HashBytes(hash, &spawner->alive, sizeof(spawner->alive));
+    }
+    for (int p = 0; p < BULLET_OWNER_COUNT; p++)
+    {
+        const BulletPool *pool = &state->bullets.pools[p];
+        hash = HashBytes(hash, &pool->count, sizeof(pool->count));
+        hash = HashBytes(hash, pool->posX, sizeof(float) * pool->count);
+        hash = HashBytes(hash, pool->posY, sizeof(float) * pool->count);
+        hash = HashBytes(hash, pool->velX, sizeof(float) * pool->count);
+        hash = HashBytes(hash, pool->velY, sizeof(float) * pool->count);
+    }
+    hash = HashBytes(hash, &state->currentCheckpointIndex, sizeof(state->currentCheckpointIndex));
+    hash = HashBytes(hash, &state->jumpCount, sizeof(state->jumpCount));
+    return hash;
+}
+
+bool BeginReplayRecording(ReplayRecorder *rec, const char *path, const char *levelFilename,
+                          uint32_t seed, bool checksums)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->file = fopen(path, "wb");
+    if (!rec->file)
+    {
+        TraceLog(LOG_ERROR, "REPLAY: Failed to open %s for recording!", path);
+        return false;
+    }
+    memcpy(rec->header.magic, REPLAY_MAGIC, sizeof(rec->header.magic));
+    rec->header.version = REPLAY_VERSION;
+    rec->header.flags = checksums ? REPLAY_FLAG_CHECKSUMS : 0;
+    rec->header.seed = seed;
+    rec->header.tickCount = 0;
+    snprintf(rec->header.levelFilename, sizeof(rec->header.levelFilename), "%s", levelFilename);
+
+    // The tick count is patched in by EndReplayRecording.
+    fwrite(&rec->header, sizeof(rec->header), 1, rec->file);
+    TraceLog(LOG_INFO, "REPLAY: Recording %s (seed %u) to %s", levelFilename, seed, path);
+    return true;
+}
+
+void RecordReplayTick(ReplayRecorder *rec, const PlayerInput *input, float deltaTime, const GameState *state)
+{
+    if (!rec->file)
+        return;
+    fwrite(&deltaTime, sizeof(deltaTime), 1, rec->file);
+    fwrite(&input->buttons, sizeof(input->buttons), 1, rec->file);
+    // Aim is only read when shooting, so it is only stored then.
+    if (input->buttons & INPUT_SHOOT)
+    {
+        fwrite(&input->aimWorld.x, sizeof(float), 1, rec->file);
+        fwrite(&input->aimWorld.y, sizeof(float), 1, rec->file);
+    }
+    if (rec->header.flags & REPLAY_FLAG_CHECKSUMS)
+    {
+        uint32_t hash = HashGameState(state);
+        fwrite(&hash, sizeof(hash), 1, rec->file);
+    }
+    rec->header.tickCount++;
+}
+
+void EndReplayRecording(ReplayRecorder *rec)
+{
+    if (!rec->file)
+        return;
+    fseek(rec->file, 0, SEEK_SET);
+    fwrite(&rec->header, sizeof(rec->header), 1, rec->file);
+    fclose(rec->file);
+    rec->file = NULL;
+    TraceLog(LOG_INFO, "REPLAY: Recorded %u ticks", rec->header.tickCount);
+}
+
+bool IsReplayRecording(const ReplayRecorder *rec)
+{
+    return rec->file != NULL;
+}
+
+bool OpenReplay(ReplayPlayer *player, const char *path)
+{
+    memset(player, 0, sizeof(*player));
+    player->file = fopen(path, "rb");
+    if (!player->file)
+    {
+        TraceLog(LOG_ERROR, "REPLAY: Failed to open replay %s!", path);
+        return false;
+    }
+    if (fread(&player->header, sizeof(player->header), 1, player->file) != 1 ||
+        memcmp(player->header.magic, REPLAY_MAGIC, sizeof(player->header.magic)) != 0)
+    {
+        TraceLog(LOG_ERROR, "REPLAY: %s is not a replay file!", path);
+        CloseReplay(player);
+        return false;
+    }
+    if (player->header.version != REPLAY_VERSION)
+    {
+        TraceLog(LOG_ERROR, "REPLAY: %s has version %u, expected %u!", path, player->header.version, REPLAY_VERSION);
+        CloseReplay(player);
+        return false;
+    }
+    player->header.levelFilename[sizeof(player->header.levelFilename) - 1] = '\0';
+    return true;
+}
+
+bool ReadReplayTick(ReplayPlayer *player, PlayerInput *input, float *deltaTime, uint32_t *expectedHash)
+{
+    if (!player->file || player->tick >= player->header.tickCount)
+        return false;
+
+    memset(input, 0, sizeof(*input));
+    if (fread(deltaTime, sizeof(*deltaTime), 1, player->file) != 1 ||
+        fread(&input->buttons, sizeof(input->buttons), 1, player->file) != 1)
+        return false;
+    if (input->buttons & INPUT_SHOOT)
+    {
+        if (fread(&input->aimWorld.x, sizeof(float), 1, player->file) != 1 ||
+            fread(&input->aimWorld.y, sizeof(float), 1, player->file) != 1)
+            return false;
+    }
+    if (player->header.flags & REPLAY_FLAG_CHECKSUMS)
+    {
+        uint32_t hash = 0;
+        if (fread(&hash, sizeof(hash), 1, player->file) != 1)
+            return false;
+        if (expectedHash)
+            *expectedHash = hash;
+    }
+    player->tick++;
+    return true;
+}
+
+void CloseReplay(ReplayPlayer *player)
+{
+    if (player->file)
+        fclose(player->file);
+    player->file = NULL;
+}
+
+int RunReplayPlayback(const char *path, bool verify)
+{
+    ReplayPlayer replay;
+    if (!OpenReplay(&replay, path))
+        return -1;
+
+    strcpy(gameState->currentLevelFilename, replay.header.levelFilename);
+    if (!LoadLevel(gameState->currentLevelFilename, &mapTiles,
+                   &gameState->player, &gameState->enemies, &gameState->enemyCount,
+                   &gameState->bossEnemy, &gameState->checkpoints, &gameState->checkpointCount))
+    {
+        TraceLog(LOG_ERROR, "REPLAY: Failed to load level: %s", gameState->currentLevelFilename);
+        CloseReplay(&replay);
+        return -1;
+    }
+    gameState->currentCheckpointIndex = -1;
+    gameState->currentState = PLAY;
+    ResetSimulation(gameState);
+    SetRandomSeed(replay.header.seed);
+
+    bool checkHashes = verify && (replay.header.flags & REPLAY_FLAG_CHECKSUMS);
+    if (verify && !checkHashes)
+        TraceLog(LOG_WARNING, "REPLAY: %s has no checksums, nothing to verify.", path);
+
+    int divergedAt = 0;
+    PlayerInput input;
+    float deltaTime = 0.0f;
+    uint32_t expectedHash = 0;
+    double start = NowSeconds();
+    while (ReadReplayTick(&replay, &input, &deltaTime, &expectedHash))
+    {
+        SimEvents events;
+        SimulatePlayTick(gameState, &input, deltaTime, &events);
+        if (checkHashes && divergedAt == 0 && HashGameState(gameState) != expectedHash)
+        {
+            divergedAt = (int)replay.tick;
+            TraceLog(LOG_WARNING, "REPLAY: State diverged at tick %d", divergedAt);
+        }
+    }
+    double elapsed = NowSeconds() - start;
+
+    if (replay.tick != replay.header.tickCount)
+        TraceLog(LOG_WARNING, "REPLAY: Truncated file, played %u of %u ticks", replay.tick, replay.header.tickCount);
+    TraceLog(LOG_INFO, "REPLAY: %u ticks in %.3f s (%.0f ticks/s), final hash %08x",
+             replay.tick, elapsed, (elapsed > 0.0) ? replay.tick / elapsed : 0.0, HashGameState(gameState));
+    CloseReplay(&replay);
+    return divergedAt;
+}
@@ -0,0 +1,62 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "game_sim.h"
+
+#define REPLAY_MAGIC "GGRP"
+#define REPLAY_VERSION 2
+
+// Header flags.
+#define REPLAY_FLAG_CHECKSUMS 0x1
+
+// File layout: ReplayHeader followed by tickCount variable-length ticks.
+// Each tick is: float deltaTime, uint8 buttons, then float aimX/aimY only
+// when INPUT_SHOOT is set, then a uint32 state hash when checksums are on.
+typedef struct ReplayHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t seed;
+    uint32_t tickCount;
+    char levelFilename[256];
+} ReplayHeader;
+
+typedef struct ReplayRecorder
+{
+    FILE *file;
+    ReplayHeader header;
+} ReplayRecorder;
+
+typedef struct ReplayPlayer
+{
+    FILE *file;
+    ReplayHeader header;
+    uint32_t tick;
+} ReplayPlayer;
+
+// Hash of everything the PLAY tick mutates, used to detect divergence.
+uint32_t HashGameState(const GameState *state);
+
+bool BeginReplayRecording(ReplayRecorder *rec, const char *path, const char *levelFilename,
+                          uint32_t seed, bool checksums);
+// Append one tick. Call after SimulatePlayTick so the hash covers the result.
+void RecordReplayTick(ReplayRecorder *rec, const PlayerInput *input, float deltaTime, const GameState *state);
+void EndReplayRecording(ReplayRecorder *rec);
+bool IsReplayRecording(const ReplayRecorder *rec);
+
+bool OpenReplay(ReplayPlayer *player, const char *path);
+// Read the next tick. Returns false at end of file. expectedHash is only
+// written when the replay carries checksums.
+bool ReadReplayTick(ReplayPlayer *player, PlayerInput *input, float *deltaTime, uint32_t *expectedHash);
+void CloseReplay(ReplayPlayer *player);
+
+// Load the replay's level and run every tick without presenting anything.
+// Returns the number of the first divergent tick, 0 when the run matched
+// (or carried no checksums) and -1 when the replay could not be started.
+int RunReplayPlayback(const char *path, bool verify);
+
+#endif
@@ -0,0 +1,141 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "sim_thread.h"
+#include "animation.h"
+
+typedef struct SimTickRequest
+{
+    GameState *state;
+    PlayerInput input;
+    float deltaTime;
+    Rectangle view;
+    ReplayRecorder *recorder;
+} SimTickRequest;
+
+// snapshots[front] is drawn by the main thread; the tick writes the other one.
+static RenderSnapshot snapshots[2];
+static int front = 0;
+
+static std::thread simThread;
+static bool simThreadRunning = false;
+
+// Guards request, tickPending and stopRequested.
+static std::mutex simMutex;
+static std::condition_variable simWake; // A tick was handed over, or stop.
+static std::condition_variable simDone; // The tick finished.
+static SimTickRequest request;
+static bool tickPending = false;
+static bool stopRequested = false;
+
+// Main thread only.
+static bool tickRunning = false;
+
+static void RunSimTick(const SimTickRequest *req)
+{
+    RenderSnapshot *back = &snapshots[1 - front];
+    SimulatePlayTick(req->state, &req->input, req->deltaTime, &back->events);
+    RecordReplayTick(req->recorder, &req->input, req->deltaTime, req->state);
+    UpdateEntityAnimations(req->state, req->view, req->deltaTime);
+    CaptureRenderSnapshot(req->state, back);
+}
+
+static void SimWorker(void)
+{
+    std::unique_lock<std::mutex> lock(simMutex);
+    for (;;)
+    {
+        simWake.wait(lock, [] { return tickPending || stopRequested; });
+        if (stopRequested)
+            return;
+
+        SimTickRequest req = request;
+        lock.unlock();
+        RunSimTick(&req);
+        lock.lock();
+        tickPending = false;
+        simDone.notify_one();
+    }
+}
+
+bool StartSimThread(void)
+{
+    if (simThreadRunning)
+        return true;
+    if (std::thread::hardware_concurrency() < 2)
+    {
+        TraceLog(LOG_INFO, "SIM: One core; ticks run on the main thread.");
+        return false;
+    }
+    stopRequested = false;
+    simThread = std::thread(SimWorker);
+    simThreadRunning = true;
+    return true;
+}
+
+void StopSimThread(void)
+{
+    if (!simThreadRunning)
+        return;
+    if (tickRunning)
+        EndSimTick();
+    {
+        std::lock_guard<std::mutex> lock(simMutex);
+        stopRequested = true;
+    }
+    simWake.notify_one();
+    simThread.join();
+    simThreadRunning = false;
+}
+
+void BeginSimTick(GameState *state, const PlayerInput *input, float deltaTime, Rectangle view,
+                  ReplayRecorder *recorder)
+{
+    SimTickRequest req = {state, *input, deltaTime, view, recorder};
+    tickRunning = true;
+    if (!simThreadRunning)
+    {
+        RunSimTick(&req);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(simMutex);
+        request = req;
+        tickPending = true;
+    }
+    simWake.notify_one();
+}
+
+bool IsSimTickRunning(void)
+{
+    return tickRunning;
+}
+
+const RenderSnapshot *EndSimTick(void)
+{
+    if (!tickRunning)
+        return &snapshots[front];
+    if (simThreadRunning)
+    {
+        std::unique_lock<std::mutex> lock(simMutex);
+        simDone.wait(lock, [] { return !tickPending; });
+    }
+    tickRunning = false;
+    front = 1 - front;
+    return &snapshots[front];
+}
+
+const RenderSnapshot *GetRenderSnapshot(void)
+{
+    return &snapshots[front];
+}
+
+void ResetRenderSnapshot(const GameState *state)
+{
+    RenderSnapshot *snapshot = &snapshots[front];
+    snapshot->events.shotsFired = 0;
+    snapshot->events.checkpointReached = -1;
+    snapshot->events.effectCount = 0;
+    CaptureRenderSnapshot(state, snapshot);
+}
@@ -0,0 +1,36 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <raylib.h>
+#include <stdbool.h>
+#include "render_snapshot.h"
+#include "replay.h"
+
+// PLAY ticks on a worker thread. raylib's window, input and GL calls stay on
+// the main thread; each frame the main thread hands the worker one tick
+// (BeginSimTick), draws the snapshot of the previous tick and presents, then
+// collects the tick (EndSimTick) before it touches the GameState again. The
+// worker simulates, records the replay tick, advances animations and
+// captures the result into the back snapshot; EndSimTick makes that the
+// front one. Between Begin and End the main thread must not read or write
+// the GameState or allocate from gameArena.
+//
+// Without a worker (single core, or the thread failed to start) the tick
+// runs inside BeginSimTick, with the same results.
+bool StartSimThread(void);
+void StopSimThread(void);
+
+void BeginSimTick(GameState *state, const PlayerInput *input, float deltaTime, Rectangle view,
+                  ReplayRecorder *recorder);
+bool IsSimTickRunning(void);
+// Wait for the tick and return its snapshot, which is now the front one.
+const RenderSnapshot *EndSimTick(void);
+
+// Snapshot of the last finished tick; the one to draw.
+const RenderSnapshot *GetRenderSnapshot(void);
+
+// Capture state straight into the front snapshot with no events, e.g. when
+// a level (re)starts. No tick may be running.
+void ResetRenderSnapshot(const GameState *state);
+
+#endif
@@ -0,0 +1,133 @@
+#include "spawner.h"
+#include "ai.h"
+
+static const char *spawnerModeStrings[SPAWNER_MODE_COUNT] = {"Wave", "Timed", "Trigger"};
+
+const char *GetSpawnerModeString(SpawnerMode mode)
+{
+    return (mode >= 0 && mode < SPAWNER_MODE_COUNT) ? spawnerModeStrings[mode] : "Unknown";
+}
+
+EntitySpawner MakeEntitySpawner(uint64_t assetId, Vector2 position)
+{
+    EntitySpawner spawner = {0};
+    spawner.assetId = assetId;
+    spawner.asset = FindEntityAssetHandle(assetId);
+    spawner.mode = SPAWNER_WAVE;
+    spawner.position = position;
+    spawner.spread = 200.0f;
+    spawner.interval = 3.0f;
+    spawner.perWave = 4;
+    spawner.total = 12;
+    spawner.maxAlive = 0;
+    spawner.triggerRadius = 400.0f;
+    return spawner;
+}
+
+void ResetSpawners(EntitySpawner *spawners, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        EntitySpawner *s = &spawners[i];
+        s->triggered = s->mode != SPAWNER_TRIGGER;
+        s->timer = 0.0f;
+        s->spawned = 0;
+        s->alive = 0;
+    }
+}
+
+bool IsSpawnerFinished(const EntitySpawner *spawner)
+{
+    return spawner->total > 0 && spawner->spawned >= spawner->total;
+}
+
+// Enemy the spawner makes: the asset's base stats, patrolling around x.
+static Entity MakeSpawnedEntity(const EntitySpawner *spawner, const EntityAsset *asset, float x)
+{
+    Entity e = {0};
+    e.assetId = spawner->assetId;
+    e.asset = spawner->asset;
+    e.kind = ENTITY_ENEMY;
+    e.physicsType = asset->physicsType;
+    e.radius = asset->baseRadius;
+    e.health = asset->baseHp;
+    e.speed = asset->baseSpeed;
+    e.shootCooldown = asset->baseAttackSpeed;
+    e.basePos = (Vector2){x, spawner->position.y};
+    e.position = e.basePos;
+    e.direction = -1;
+    e.state = ENTITY_STATE_IDLE;
+    e.leftBound = x - 50;
+    e.rightBound = x + 50;
+    return e;
+}
+
+// Add one wave; fewer enemies when the total or the alive cap would be passed.
+static int SpawnWave(EntitySpawner *spawner, int index, EntityArchetype *arch)
+{
+    int n = spawner->perWave;
+    if (spawner->total > 0 && n > spawner->total - spawner->spawned)
+        n = spawner->total - spawner->spawned;
+    if (spawner->maxAlive > 0 && n > spawner->maxAlive - spawner->alive)
+        n = spawner->maxAlive - spawner->alive;
+    if (n <= 0 || !IsEntityAssetHandleValid(spawner->asset))
+        return 0;
+
+    // Spread the wave evenly over the strip so runs stay deterministic.
+    const EntityAsset *asset = GetEntityAsset(spawner->asset);
+    int added = 0;
+    for (int k = 0; k < n; k++)
+    {
+        float x = spawner->position.x + spawner->spread * ((k + 0.5f) / n - 0.5f);
+        Entity e = MakeSpawnedEntity(spawner, asset, x);
+        int row = AddEntityRow(arch, &e, -1);
+        if (row < 0)
+            break;
+        arch->spawner[row] = index;
+        InitEnemyBrain(arch, row);
+        added++;
+    }
+    spawner->spawned += added;
+    spawner->alive += added;
+    return added;
+}
+
+int UpdateSpawners(EntitySpawner *spawners, int count, EntityArchetype *arch, Vector2 playerPos, float dt)
+{
+    int total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        EntitySpawner *s = &spawners[i];
+        if (IsSpawnerFinished(s))
+            continue;
+        if (!s->triggered)
+        {
+            float dx = playerPos.x - s->position.x;
+            float dy = playerPos.y - s->position.y;
+            if (dx * dx + dy * dy > s->triggerRadius * s->triggerRadius)
+                continue;
+            s->triggered = true;
+        }
+
+        // Waves wait for the previous one to die before the interval starts.
+        bool waitsForClear = s->mode != SPAWNER_TIMED;
+        if (waitsForClear && s->alive > 0)
+            continue;
+        s->timer -= dt;
+        if (s->timer > 0.0f)
+            continue;
+        total += SpawnWave(s, i, arch);
+        s->timer = s->interval;
+    }
+    return total;
+}
+
+void ReleaseSpawnedRows(EntitySpawner *spawners, int count, const EntityArchetype *arch)
+{
+    for (int i = 0; i < arch->count; i++)
+    {
+        int s = arch->spawner[i];
+        if (arch->combat[i].health <= 0 && s >= 0 && s < count)
+            spawners[s].alive--;
+    }
+}
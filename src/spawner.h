@@ -0,0 +1,58 @@
+#ifndef SPAWNER_H
+#define SPAWNER_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include "entity.h"
+#include "entity_store.h"
+
+typedef enum SpawnerMode
+{
+    SPAWNER_WAVE = 0, // Next wave once the last one is dead (after interval).
+    SPAWNER_TIMED,    // A wave every interval, up to maxAlive alive at once.
+    SPAWNER_TRIGGER,  // Waves like SPAWNER_WAVE once the player comes within triggerRadius.
+    SPAWNER_MODE_COUNT
+} SpawnerMode;
+
+// Level-placed source of enemies made from one entity asset during PLAY.
+// Spawned enemies go into the entity store and are dropped from it once
+// dead, so the per-tick cost follows the enemies alive, not those ever spawned.
+typedef struct EntitySpawner
+{
+    uint64_t assetId;        // Persistent reference, as saved in level files.
+    EntityAssetHandle asset; // Resolved from assetId at load.
+    SpawnerMode mode;
+    Vector2 position;
+    float spread;        // Width of the strip enemies appear in, centered on position.
+    float interval;      // Seconds between waves.
+    int perWave;
+    int total;           // Enemies to spawn in all; 0 never runs out.
+    int maxAlive;        // Cap on this spawner's enemies alive at once; 0 for none.
+    float triggerRadius;
+
+    // Runtime, reset by ResetSpawners.
+    bool triggered;
+    float timer;         // Seconds until the next wave may come.
+    int spawned;
+    int alive;
+} EntitySpawner;
+
+const char *GetSpawnerModeString(SpawnerMode mode);
+
+// Defaults for a spawner placed in the editor.
+EntitySpawner MakeEntitySpawner(uint64_t assetId, Vector2 position);
+
+void ResetSpawners(EntitySpawner *spawners, int count);
+
+// True once the spawner has sent all its enemies; endless ones never finish.
+bool IsSpawnerFinished(const EntitySpawner *spawner);
+
+// Advance the spawners' timers and add the waves that are due to arch.
+// Returns the number of enemies spawned.
+int UpdateSpawners(EntitySpawner *spawners, int count, EntityArchetype *arch, Vector2 playerPos, float dt);
+
+// Tell the spawner of each dead row in arch that it lost an enemy. Call
+// before the dead rows are removed.
+void ReleaseSpawnedRows(EntitySpawner *spawners, int count, const EntityArchetype *arch);
+
+#endif
@@ -0,0 +1,175 @@
+#include "sprite_batch.h"
+#include "memory_arena.h"
+#include <rlgl.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct SpriteRecord
+{
+    Texture2D texture;
+    Rectangle src;
+    Rectangle dst;
+    Color tint;
+    bool flipX;
+} SpriteRecord;
+
+// The frame's records, plus sort keys and record indices with scratch copies
+// for the radix passes. Grown in the asset arena, which lives for the whole run.
+static SpriteRecord *records;
+static uint32_t *keys;
+static uint32_t *order;
+static uint32_t *scratchKeys;
+static uint32_t *scratchOrder;
+static int spriteCount;
+static int spriteCapacity;
+static Rectangle batchView;
+static SpriteBatchStats lastStats;
+
+static bool ReserveSprites(int count)
+{
+    if (count <= spriteCapacity)
+        return true;
+
+    int capacity = (spriteCapacity > 0) ? spriteCapacity * 2 : 1024;
+    while (capacity < count)
+        capacity *= 2;
+
+    SpriteRecord *grownRecords = (SpriteRecord *)arena_realloc(&assetArena, records, sizeof(SpriteRecord) * capacity);
+    if (!grownRecords)
+        return false;
+    records = grownRecords;
+
+    uint32_t **sortBuffers[4] = {&keys, &order, &scratchKeys, &scratchOrder};
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t *grown = (uint32_t *)arena_realloc(&assetArena, *sortBuffers[i], sizeof(uint32_t) * capacity);
+        if (!grown)
+            return false;
+        *sortBuffers[i] = grown;
+    }
+    spriteCapacity = capacity;
+    return true;
+}
+
+void BeginSpriteBatch(Rectangle view)
+{
+    batchView = view;
+    spriteCount = 0;
+}
+
+void PushSprite(SpriteLayer layer, Texture2D texture, Rectangle src, Rectangle dst, Color tint, bool flipX)
+{
+    if (texture.id == 0 || dst.x + dst.width < batchView.x || dst.x > batchView.x + batchView.width ||
+        dst.y + dst.height < batchView.y || dst.y > batchView.y + batchView.height)
+        return;
+
+    if (!ReserveSprites(spriteCount + 1))
+    {
+        TraceLog(LOG_ERROR, "Sprite batch is out of memory; sprite dropped!");
+        return;
+    }
+
+    int i = spriteCount++;
+    records[i] = (SpriteRecord){texture, src, dst, tint, flipX};
+    keys[i] = ((uint32_t)layer << 24) | (texture.id & 0xFFFFFF);
+    order[i] = (uint32_t)i;
+}
+
+// Stable LSD radix sort of keys/order, one byte per pass. A pass where every
+// key has the same byte (the layer byte of a one-layer frame, the high texture
+// bytes nearly always) is skipped.
+static void SortSprites(void)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        int counts[256];
+        memset(counts, 0, sizeof(counts));
+        for (int i = 0; i < spriteCount; i++)
+            counts[(keys[i] >> shift) & 0xFF]++;
+        if (counts[(keys[0] >> shift) & 0xFF] == spriteCount)
+            continue;
+
+        int offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            int c = counts[b];
+            counts[b] = offset;
+            offset += c;
+        }
+        for (int i = 0; i < spriteCount; i++)
+        {
+            int dst = counts[(keys[i] >> shift) & 0xFF]++;
+            scratchKeys[dst] = keys[i];
+            scratchOrder[dst] = order[i];
+        }
+
+        uint32_t *swap = keys;
+        keys = scratchKeys;
+        scratchKeys = swap;
+        swap = order;
+        order = scratchOrder;
+        scratchOrder = swap;
+    }
+}
+
+// Same quad as DrawTexturePro with no origin or rotation.
+static void EmitSpriteQuad(const SpriteRecord *s)
+{
+    float width = (float)s->texture.width;
+    float height = (float)s->texture.height;
+    float left = s->src.x / width;
+    float right = (s->src.x + s->src.width) / width;
+    float top = s->src.y / height;
+    float bottom = (s->src.y + s->src.height) / height;
+    if (s->flipX)
+    {
+        float swap = left;
+        left = right;
+        right = swap;
+    }
+
+    rlColor4ub(s->tint.r, s->tint.g, s->tint.b, s->tint.a);
+    rlTexCoord2f(left, top);
+    rlVertex2f(s->dst.x, s->dst.y);
+    rlTexCoord2f(left, bottom);
+    rlVertex2f(s->dst.x, s->dst.y + s->dst.height);
+    rlTexCoord2f(right, bottom);
+    rlVertex2f(s->dst.x + s->dst.width, s->dst.y + s->dst.height);
+    rlTexCoord2f(right, top);
+    rlVertex2f(s->dst.x + s->dst.width, s->dst.y);
+}
+
+void EndSpriteBatch(void)
+{
+    lastStats = (SpriteBatchStats){spriteCount, 0};
+    if (spriteCount == 0)
+        return;
+
+    SortSprites();
+
+    unsigned int boundTexture = 0;
+    for (int i = 0; i < spriteCount; i++)
+    {
+        const SpriteRecord *s = &records[order[i]];
+        if (s->texture.id != boundTexture)
+        {
+            if (boundTexture != 0)
+                rlEnd();
+            boundTexture = s->texture.id;
+            lastStats.textureRuns++;
+            rlSetTexture(boundTexture);
+            rlBegin(RL_QUADS);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+        }
+        EmitSpriteQuad(s);
+    }
+    rlEnd();
+    rlSetTexture(0);
+    rlDrawRenderBatchActive();
+    spriteCount = 0;
+}
+
+SpriteBatchStats GetSpriteBatchStats(void)
+{
+    return lastStats;
+}
@@ -0,0 +1,36 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <raylib.h>
+#include <stdbool.h>
+
+// Draw order of world sprites, back to front.
+typedef enum SpriteLayer
+{
+    SPRITE_LAYER_TILES = 0,      // Background tiles.
+    SPRITE_LAYER_PROPS = 1,      // Checkpoints and other level props.
+    SPRITE_LAYER_ENTITIES = 2,   // Player, enemies and the boss.
+    SPRITE_LAYER_FOREGROUND = 3, // Tiles flagged as foreground.
+    SPRITE_LAYER_EFFECTS = 4,
+    SPRITE_LAYER_COUNT
+} SpriteLayer;
+
+// World sprites submitted between Begin and End are recorded instead of drawn.
+// End sorts the records by layer, then by texture (a stable radix sort, so
+// sprites keep their submission order within a layer and texture), and draws
+// each run of one texture as a single batch of quads. Sprites entirely
+// outside the view are dropped when pushed.
+void BeginSpriteBatch(Rectangle view);
+void PushSprite(SpriteLayer layer, Texture2D texture, Rectangle src, Rectangle dst, Color tint, bool flipX);
+void EndSpriteBatch(void);
+
+// Counts from the last EndSpriteBatch, for the stats overlay.
+typedef struct SpriteBatchStats
+{
+    int sprites;     // Sprites drawn.
+    int textureRuns; // Texture binds it took to draw them.
+} SpriteBatchStats;
+
+SpriteBatchStats GetSpriteBatchStats(void);
+
+#endif
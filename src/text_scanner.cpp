@@ -0,0 +1,260 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "text_scanner.h"
+
+#if TEXT_SCANNER_SIMD
+#include <immintrin.h>
+#endif
+
+// fscanf's idea of whitespace in the C locale: space and \t \n \v \f \r.
+static inline bool IsSpace(char c)
+{
+    return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+static inline bool IsDigit(char c)
+{
+    return (unsigned char)(c - '0') <= 9;
+}
+
+static inline bool IsAlpha(char c)
+{
+    return (unsigned char)((c | 0x20) - 'a') <= 'z' - 'a';
+}
+
+void SkipWhitespace(TextScanner *scanner)
+{
+    const char *p = scanner->cursor;
+    while (p < scanner->end && IsSpace(*p))
+        p++;
+    scanner->cursor = p;
+}
+
+bool ScanKeyword(TextScanner *scanner, const char *keyword)
+{
+    SkipWhitespace(scanner);
+    size_t length = strlen(keyword);
+    const char *p = scanner->cursor;
+    if ((size_t)(scanner->end - p) < length || memcmp(p, keyword, length) != 0)
+        return false;
+    if (p + length < scanner->end && !IsSpace(p[length]))
+        return false;
+    scanner->cursor = p + length;
+    return true;
+}
+
+// Optional sign then decimal digits, wrapping on overflow. Returns the end of
+// the number, or NULL if there are no digits.
+static const char *ParseInteger(const char *p, const char *end, unsigned long long *value, bool *negative)
+{
+    *negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        *negative = (*p == '-');
+        p++;
+    }
+    if (p == end || !IsDigit(*p))
+        return NULL;
+    unsigned long long v = 0;
+    while (p < end && IsDigit(*p))
+        v = v * 10 + (unsigned)(*p++ - '0');
+    *value = v;
+    return p;
+}
+
+bool ScanInt(TextScanner *scanner, int *value)
+{
+    SkipWhitespace(scanner);
+    unsigned long long v;
+    bool negative;
+    const char *p = ParseInteger(scanner->cursor, scanner->end, &v, &negative);
+    if (!p)
+        return false;
+    unsigned int bits = (unsigned int)v;
+    *value = (int)(negative ? 0u - bits : bits);
+    scanner->cursor = p;
+    return true;
+}
+
+bool ScanUInt64(TextScanner *scanner, uint64_t *value)
+{
+    SkipWhitespace(scanner);
+    unsigned long long v;
+    bool negative;
+    const char *p = ParseInteger(scanner->cursor, scanner->end, &v, &negative);
+    if (!p)
+        return false;
+    *value = negative ? 0ull - v : v;
+    scanner->cursor = p;
+    return true;
+}
+
+// Numbers past the fast path (exponents, long mantissas, inf/nan, hex) go
+// through strtof, on a NUL-terminated copy of the token.
+static bool ScanFloatSlow(TextScanner *scanner, float *value)
+{
+    char token[64];
+    size_t length = 0;
+    const char *p = scanner->cursor;
+    while (p + length < scanner->end && !IsSpace(p[length]) && length < sizeof(token) - 1)
+    {
+        token[length] = p[length];
+        length++;
+    }
+    token[length] = '\0';
+    char *stop;
+    float v = strtof(token, &stop);
+    if (stop == token)
+        return false;
+    *value = v;
+    scanner->cursor = p + (stop - token);
+    return true;
+}
+
+bool ScanFloat(TextScanner *scanner, float *value)
+{
+    // Exact in a float, so mantissa / power is one correctly rounded
+    // division: the same float strtof returns.
+    static const float powersOfTen[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    const int maxScale = (int)(sizeof(powersOfTen) / sizeof(powersOfTen[0])) - 1;
+
+    SkipWhitespace(scanner);
+    const char *p = scanner->cursor;
+    const char *end = scanner->end;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int scale = 0;
+    while (p < end && IsDigit(*p))
+    {
+        mantissa = mantissa * 10 + (unsigned)(*p++ - '0');
+        digits++;
+    }
+    if (p < end && *p == '.')
+    {
+        p++;
+        while (p < end && IsDigit(*p))
+        {
+            mantissa = mantissa * 10 + (unsigned)(*p++ - '0');
+            digits++;
+            scale++;
+        }
+    }
+    if ((p < end && IsAlpha(*p)) || digits > 18 || mantissa > (1u << 24) || scale > maxScale)
+        return ScanFloatSlow(scanner, value);
+    if (digits == 0)
+        return false;
+
+    float v = (float)mantissa / powersOfTen[scale];
+    *value = negative ? -v : v;
+    scanner->cursor = p;
+    return true;
+}
+
+int ScanUIntArrayScalar(TextScanner *scanner, unsigned int *values, int count)
+{
+    int read = 0;
+    int v;
+    while (read < count && ScanInt(scanner, &v))
+        values[read++] = (unsigned int)v;
+    return read;
+}
+
+#if TEXT_SCANNER_SIMD
+
+// Bit i set where byte i is whitespace.
+static inline unsigned WhitespaceMask(__m128i bytes)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i controlRange = _mm_set1_epi8('\r' - '\t');
+    __m128i isSpace = _mm_cmpeq_epi8(bytes, space);
+    __m128i offset = _mm_sub_epi8(bytes, tab);
+    __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(offset, controlRange), offset);
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(isSpace, isControl));
+}
+
+// Bit i set where byte i is a decimal digit.
+static inline unsigned DigitMask(__m128i bytes)
+{
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    __m128i offset = _mm_sub_epi8(bytes, zero);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(offset, nine), offset));
+}
+
+int ScanUIntArraySimd(TextScanner *scanner, unsigned int *values, int count)
+{
+    const char *p = scanner->cursor;
+    const char *end = scanner->end;
+    int read = 0;
+    while (read < count)
+    {
+        // p is always at whitespace or the start of a token. Every token
+        // that ends inside the next 16 bytes is found from their masks, with
+        // no per-byte tests between tokens.
+        int consumed = 0;
+        if (end - p >= 16)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)p);
+            unsigned space = WhitespaceMask(bytes);
+            unsigned digit = DigitMask(bytes);
+            unsigned token = ~space & 0xFFFFu;
+            unsigned starts = token & ~(token << 1);
+            consumed = 16;
+            while (starts)
+            {
+                int start = __builtin_ctz(starts);
+                unsigned after = space >> start;
+                unsigned bits = after ? ((1u << __builtin_ctz(after)) - 1) << start : 0;
+                if (!after || (bits & ~digit))
+                {
+                    // Runs past the block, or isn't plain digits: ScanInt takes it.
+                    consumed = start;
+                    break;
+                }
+                int length = __builtin_ctz(after);
+                unsigned v = 0;
+                for (int i = 0; i < length; i++)
+                    v = v * 10 + (unsigned)(p[start + i] - '0');
+                values[read++] = v;
+                if (read == count)
+                {
+                    consumed = start + length;
+                    break;
+                }
+                starts &= starts - 1;
+            }
+            p += consumed;
+        }
+        if (read == count)
+            break;
+        if (consumed == 0)
+        {
+            scanner->cursor = p;
+            int v;
+            if (!ScanInt(scanner, &v))
+                return read;
+            values[read++] = (unsigned int)v;
+            p = scanner->cursor;
+        }
+    }
+    scanner->cursor = p;
+    return read;
+}
+
+#else
+
+int ScanUIntArraySimd(TextScanner *scanner, unsigned int *values, int count)
+{
+    return ScanUIntArrayScalar(scanner, values, count);
+}
+
+#endif
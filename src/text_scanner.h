@@ -0,0 +1,53 @@
+#ifndef TEXT_SCANNER_H
+#define TEXT_SCANNER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Whitespace is classified 16 bytes at a time where SSE2 is available.
+#if defined(__SSE2__)
+#define TEXT_SCANNER_SIMD 1
+#else
+#define TEXT_SCANNER_SIMD 0
+#endif
+
+// Reads whitespace-separated numbers and words out of a text buffer that is
+// already in memory, in place of an fscanf chain. The buffer needn't be NUL
+// terminated (a mapped file isn't). Every Scan function skips leading
+// whitespace first and returns false, without moving past the bad token, when
+// the next token isn't what it asked for; numbers parse as fscanf's %d, %llu
+// and %f would.
+typedef struct TextScanner
+{
+    const char *cursor;
+    const char *end;
+} TextScanner;
+
+static inline TextScanner MakeTextScanner(const void *data, size_t size)
+{
+    TextScanner scanner = {(const char *)data, (const char *)data + size};
+    return scanner;
+}
+
+void SkipWhitespace(TextScanner *scanner);
+
+// The next word if it is keyword; a different word is left unread.
+bool ScanKeyword(TextScanner *scanner, const char *keyword);
+bool ScanInt(TextScanner *scanner, int *value);
+bool ScanUInt64(TextScanner *scanner, uint64_t *value);
+bool ScanFloat(TextScanner *scanner, float *value);
+
+// Read count integers into values, for the tile block of a text level.
+// Returns how many were read; fewer than count means a bad or missing token.
+// The Simd version finds token boundaries a register at a time and gives the
+// same results; it is the Scalar one where TEXT_SCANNER_SIMD is 0.
+int ScanUIntArrayScalar(TextScanner *scanner, unsigned int *values, int count);
+int ScanUIntArraySimd(TextScanner *scanner, unsigned int *values, int count);
+
+static inline int ScanUIntArray(TextScanner *scanner, unsigned int *values, int count)
+{
+    return ScanUIntArraySimd(scanner, values, count);
+}
+
+#endif
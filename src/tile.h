@@ -14,6 +14,23 @@ typedef enum TilePhysicsType
     TILE_PHYS_DEATH = 2,
 } TilePhysicsType;
 
+// Physics type of a map tile id: composite ids (0x100000 and up) carry it in
+// bits 16-19; the legacy ids 1 and 2 are ground and death.
+static inline int GetTilePhysics(unsigned int tileId)
+{
+    if (tileId >= 0x100000)
+        return (tileId >> 16) & 0xF;
+    if (tileId == 1)
+        return TILE_PHYS_GROUND;
+    if (tileId == 2)
+        return TILE_PHYS_DEATH;
+    return TILE_PHYS_NONE;
+}
+
+// Set in a map tile's index bits (below the physics bits) to draw the tile
+// over entities instead of behind them.
+#define TILE_FOREGROUND_FLAG 0x8000
+
 typedef struct Tileset
 {
     uint64_t uniqueId;
@@ -31,6 +48,7 @@ extern int tilesetCount;
 extern int selectedTilesetIndex;
 extern int selectedTileIndex;
 extern int selectedTilePhysics;
+extern bool selectedTileForeground;
 
 void DrawTilesetListPanel();
 void DrawSelectedTilesetEditor();
@@ -38,6 +56,7 @@ void DrawSelectedTilesetEditor();
 bool SaveTilesetToJson(const char *directory, const char *filename, const Tileset *ts, bool allowOverwrite);
 bool SaveAllTilesets(const char *directory, Tileset *tilesets, int count, bool allowOverwrite);
 bool LoadTilesetFromJson(const char *filename, Tileset *ts);
+bool TilesetFromJson(const char *json, Tileset *ts);
 bool LoadAllTilesets(const char *directory, Tileset **tilesets, int *count);
 
 #endif
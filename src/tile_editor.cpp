@@ -2,17 +2,14 @@
 #include <string.h>
 #include <raylib.h>
 #include "tile.h"
-#include "file_io.h"
 #include "memory_arena.h"
-#include "game_state.h"
 #include "imgui.h"
 #include "game_storage.h"
 
 int selectedTilesetIndex = -1;
 int selectedTileIndex = -1;
 int selectedTilePhysics = TILE_PHYS_GROUND;
-int tilesetCount = 0;
-Tileset *tilesets = NULL;
+bool selectedTileForeground = false;
 
 void DrawTilesetListPanel()
 {
@@ -133,146 +130,6 @@ void DrawSelectedTilesetEditor()
     const char *physicsTypes[] = {"None", "Ground", "Death"};
     if (ImGui::Combo("Physics", &selectedTilePhysics, physicsTypes, IM_ARRAYSIZE(physicsTypes)))
         ;
+    ImGui::Checkbox("Foreground", &selectedTileForeground);
     ImGui::End();
 }
-
-bool SaveTilesetToJson(const char *directory, const char *filename, const Tileset *ts, bool allowOverwrite)
-{
-    if (!allowOverwrite)
-    {
-        FILE *checkFile = fopen(filename, "r");
-        if (checkFile != NULL)
-        {
-            TraceLog(LOG_ERROR, "File %s already exists, no overwrite allowed!", filename);
-            fclose(checkFile);
-            return false;
-        }
-    }
-    if (!EnsureDirectoryExists(directory))
-    {
-        TraceLog(LOG_ERROR, "Directory %s doesn't exist (or can't create)!", directory);
-        return false;
-    }
-    FILE *file = fopen(filename, "w");
-    if (!file)
-    {
-        TraceLog(LOG_ERROR, "Failed to open %s for writing!", filename);
-        return false;
-    }
-    fprintf(file,
-            "{\n"
-            "    \"name\": \"%s\",\n"
-            "    \"imagePath\": \"%s\",\n"
-            "    \"tileWidth\": %d,\n"
-            "    \"tileHeight\": %d,\n"
-            "    \"uniqueId\": %llu\n"
-            "}\n",
-            ts->name,
-            ts->imagePath,
-            ts->tileWidth,
-            ts->tileHeight,
-            ts->uniqueId);
-    fclose(file);
-    return true;
-}
-
-bool SaveAllTilesets(const char *directory, Tileset *tilesets, int count, bool allowOverwrite)
-{
-    bool error = false;
-    for (int i = 0; i < count; i++)
-    {
-        char filename[256];
-        int len = (int)strlen(directory);
-        const char *sep = (len > 0 && (directory[len - 1] == '/' || directory[len - 1] == '\\')) ? "" : "/";
-        snprintf(filename, sizeof(filename), "%s%s%s.tiles", directory, sep, tilesets[i].name);
-        if (!SaveTilesetToJson(directory, filename, &tilesets[i], allowOverwrite))
-        {
-            TraceLog(LOG_ERROR, "Failed to save tileset: %s", tilesets[i].name);
-            error = true;
-        }
-    }
-    return !error;
-}
-
-bool LoadTilesetFromJson(const char *filename, Tileset *ts)
-{
-    FILE *file = fopen(filename, "r");
-    if (!file)
-    {
-        return false;
-    }
-    char buffer[1024];
-    size_t size = fread(buffer, 1, sizeof(buffer) - 1, file);
-    buffer[size] = '\0';
-    fclose(file);
-
-    TraceLog(LOG_INFO, "Read file for tileset successfully");
-    int ret = sscanf(
-        buffer,
-        "{\n"
-        "    \"name\": \"%127[^\"]\",\n"
-        "    \"imagePath\": \"%255[^\"]\",\n"
-        "    \"tileWidth\": %d,\n"
-        "    \"tileHeight\": %d,\n"
-        "    \"uniqueId\": %llu\n"
-        "}\n",
-        ts->name,
-        ts->imagePath,
-        &ts->tileWidth,
-        &ts->tileHeight,
-        &ts->uniqueId);
-
-    if (ret != 5)
-    {
-        TraceLog(LOG_ERROR, "Tileset parse returned %d instead of 5", ret);
-        return false;
-    }
-
-    ts->texture = LoadTextureWithCache(ts->imagePath);
-    if (ts->texture.id == 0)
-        return false;
-    ts->tilesPerRow = ts->texture.width / ts->tileWidth;
-    ts->tilesPerColumn = ts->texture.height / ts->tileHeight;
-
-    int totalTiles = ts->tilesPerRow * ts->tilesPerColumn;
-    return true;
-}
-
-bool LoadAllTilesets(const char *directory, Tileset **tilesets, int *count)
-{
-    char fileList[256][256];
-    int numFiles = ListFilesInDirectory(directory, "*.tiles", fileList, 256);
-    if (numFiles <= 0)
-        return false;
-
-    if (*tilesets == NULL)
-        *tilesets = (Tileset *)arena_alloc(&assetArena, sizeof(Tileset) * numFiles);
-    else
-        *tilesets = (Tileset *)arena_realloc(&assetArena, *tilesets, sizeof(Tileset) * numFiles);
-
-    if (*tilesets == NULL)
-    {
-        TraceLog(LOG_ERROR, "Failed to allocate memory for tilesets (size %d)", numFiles);
-        return false;
-    }
-
-    int loadedCount = 0;
-    for (int i = 0; i < numFiles; i++)
-    {
-        char fullPath[256];
-        const char *fileName = fileList[i];
-        // If the filename starts with a slash or backslash, skip it.
-        if (fileName[0] == '\\' || fileName[0] == '/')
-            fileName++;
-
-        // Build the full path using the directory and the file name.
-        snprintf(fullPath, sizeof(fullPath), "%s%s", directory, fileName);
-
-        if (LoadTilesetFromJson(fullPath, &((*tilesets)[loadedCount])))
-            loadedCount++;
-        else
-            TraceLog(LOG_ERROR, "Failed to load tileset from file: %s", fullPath);
-    }
-    *count = loadedCount;
-    return true;
-}
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <string.h>
+#include <raylib.h>
+#include "tile.h"
+#include "file_io.h"
+#include "memory_arena.h"
+#include "game_storage.h"
+#include "asset_reload.h"
+#include "asset_pack.h"
+
+int tilesetCount = 0;
+Tileset *tilesets = NULL;
+
+bool SaveTilesetToJson(const char *directory, const char *filename, const Tileset *ts, bool allowOverwrite)
+{
+    if (!allowOverwrite)
+    {
+        FILE *checkFile = fopen(filename, "r");
+        if (checkFile != NULL)
+        {
+            TraceLog(LOG_ERROR, "File %s already exists, no overwrite allowed!", filename);
+            fclose(checkFile);
+            return false;
+        }
+    }
+    if (!EnsureDirectoryExists(directory))
+    {
+        TraceLog(LOG_ERROR, "Directory %s doesn't exist (or can't create)!", directory);
+        return false;
+    }
+    FILE *file = fopen(filename, "w");
+    if (!file)
+    {
+        TraceLog(LOG_ERROR, "Failed to open %s for writing!", filename);
+        return false;
+    }
+    fprintf(file,
+            "{\n"
+            "    \"name\": \"%s\",\n"
+            "    \"imagePath\": \"%s\",\n"
+            "    \"tileWidth\": %d,\n"
+            "    \"tileHeight\": %d,\n"
+            "    \"uniqueId\": %llu\n"
+            "}\n",
+            ts->name,
+            ts->imagePath,
+            ts->tileWidth,
+            ts->tileHeight,
+            ts->uniqueId);
+    fclose(file);
+    NoteAssetWritten(filename);
+    return true;
+}
+
+bool SaveAllTilesets(const char *directory, Tileset *tilesets, int count, bool allowOverwrite)
+{
+    bool error = false;
+    for (int i = 0; i < count; i++)
+    {
+        char filename[256];
+        int len = (int)strlen(directory);
+        const char *sep = (len > 0 && (directory[len - 1] == '/' || directory[len - 1] == '\\')) ? "" : "/";
+        snprintf(filename, sizeof(filename), "%s%s%s.tiles", directory, sep, tilesets[i].name);
+        if (!SaveTilesetToJson(directory, filename, &tilesets[i], allowOverwrite))
+        {
+            TraceLog(LOG_ERROR, "Failed to save tileset: %s", tilesets[i].name);
+            error = true;
+        }
+    }
+    return !error;
+}
+
+bool LoadTilesetFromJson(const char *filename, Tileset *ts)
+{
+    AssetFile file;
+    if (!LoadAssetFile(filename, &file))
+    {
+        return false;
+    }
+    char buffer[1024];
+    size_t size = (file.size < sizeof(buffer) - 1) ? file.size : sizeof(buffer) - 1;
+    memcpy(buffer, file.data, size);
+    buffer[size] = '\0';
+    UnloadAssetFile(&file);
+
+    TraceLog(LOG_INFO, "Read file for tileset successfully");
+    return TilesetFromJson(buffer, ts);
+}
+
+bool TilesetFromJson(const char *json, Tileset *ts)
+{
+    int ret = sscanf(
+        json,
+        "{\n"
+        "    \"name\": \"%127[^\"]\",\n"
+        "    \"imagePath\": \"%255[^\"]\",\n"
+        "    \"tileWidth\": %d,\n"
+        "    \"tileHeight\": %d,\n"
+        "    \"uniqueId\": %llu\n"
+        "}\n",
+        ts->name,
+        ts->imagePath,
+        &ts->tileWidth,
+        &ts->tileHeight,
+        &ts->uniqueId);
+
+    if (ret != 5)
+    {
+        TraceLog(LOG_ERROR, "Tileset parse returned %d instead of 5", ret);
+        return false;
+    }
+
+    ts->texture = LoadTextureWithCache(ts->imagePath);
+    if (ts->texture.id == 0)
+        return false;
+    ts->tilesPerRow = ts->texture.width / ts->tileWidth;
+    ts->tilesPerColumn = ts->texture.height / ts->tileHeight;
+
+    int totalTiles = ts->tilesPerRow * ts->tilesPerColumn;
+    return true;
+}
+
+bool LoadAllTilesets(const char *directory, Tileset **tilesets, int *count)
+{
+    FileList fileList;
+    ListAssetFiles(&assetArena, directory, ".tiles", &fileList);
+    int numFiles = fileList.count;
+    if (numFiles <= 0)
+    {
+        FreeFileList(&assetArena, &fileList);
+        return false;
+    }
+
+    if (*tilesets == NULL)
+        *tilesets = (Tileset *)arena_alloc(&assetArena, sizeof(Tileset) * numFiles);
+    else
+        *tilesets = (Tileset *)arena_realloc(&assetArena, *tilesets, sizeof(Tileset) * numFiles);
+
+    if (*tilesets == NULL)
+    {
+        TraceLog(LOG_ERROR, "Failed to allocate memory for tilesets (size %d)", numFiles);
+        FreeFileList(&assetArena, &fileList);
+        return false;
+    }
+
+    int loadedCount = 0;
+    for (int i = 0; i < numFiles; i++)
+    {
+        // Build the full path using the directory and the file name.
+        char fullPath[256];
+        snprintf(fullPath, sizeof(fullPath), "%s%s", directory, GetFileListName(&fileList, i));
+
+        if (LoadTilesetFromJson(fullPath, &((*tilesets)[loadedCount])))
+            loadedCount++;
+        else
+            TraceLog(LOG_ERROR, "Failed to load tileset from file: %s", fullPath);
+    }
+    FreeFileList(&assetArena, &fileList);
+    *count = loadedCount;
+    return true;
+}
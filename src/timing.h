@@ -0,0 +1,16 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <chrono>
+
+// Seconds on a steady clock, for measuring spans of time. raylib's GetTime is
+// the window's clock and reads 0 until a window is open, so code that also
+// runs headless (replay playback, the headless runner) and the benchmarks time
+// themselves with this.
+static inline double NowSeconds()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
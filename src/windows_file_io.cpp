@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <windows.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -5,19 +6,6 @@
 #include <stdbool.h>
 #include "file_io.h"
 
-typedef struct ListFilesData
-{
-    char (*files)[256];
-    int maxFiles;
-    int *pCount;
-} ListFilesData;
-
-typedef struct ExtCountData
-{
-    const char *extension;
-    int *pCount;
-} ExtCountData;
-
 // Safely builds a Windows path by appending fileOrPattern to directory.
 static void BuildWindowsPath(char *outBuffer, size_t outSize,
                              const char *directory, const char *fileOrPattern)
@@ -40,127 +28,141 @@ static void BuildWindowsPath(char *outBuffer, size_t outSize,
         snprintf(outBuffer, outSize, "%s\\%s", directory, fileOrPattern ? fileOrPattern : "");
 }
 
-// File enumerator callback function pointer.
-typedef void (*FileEnumeratorCallback)(const char *fullPath, void *userData);
+bool EnsureDirectoryExists(const char *dirPath)
+{
+    if (!CreateDirectoryA(dirPath, NULL))
+    {
+        DWORD err = GetLastError();
+        if (err != ERROR_ALREADY_EXISTS)
+            return false;
+    }
+    return true;
+}
 
-// Enumerates files (non-recursively) matching pattern in the given directory.
-static void EnumerateDirectoryNoRecursion(const char *directory, const char *pattern,
-                                          FileEnumeratorCallback fileCallback, void *userData)
+bool AppendFileListName(MemoryArena *arena, FileList *list, const char *name, size_t length)
 {
-    if (!directory || !pattern || !fileCallback)
-        return;
+    int needed = list->namesSize + (int)length + 1;
+    if (needed > list->namesCapacity)
+    {
+        int capacity = (list->namesCapacity > 0) ? list->namesCapacity * 2 : 1024;
+        while (capacity < needed)
+            capacity *= 2;
+        char *names = (char *)arena_realloc(arena, list->names, capacity);
+        if (!names)
+            return false;
+        list->names = names;
+        list->namesCapacity = capacity;
+    }
+    if (list->count == list->offsetsCapacity)
+    {
+        int capacity = (list->offsetsCapacity > 0) ? list->offsetsCapacity * 2 : 64;
+        int *offsets = (int *)arena_realloc(arena, list->offsets, sizeof(int) * capacity);
+        if (!offsets)
+            return false;
+        list->offsets = offsets;
+        list->offsetsCapacity = capacity;
+    }
+    memcpy(list->names + list->namesSize, name, length + 1);
+    list->offsets[list->count++] = list->namesSize;
+    list->namesSize = needed;
+    return true;
+}
 
+bool ScanDirectory(MemoryArena *arena, const char *directory, const char *extension, FileList *list)
+{
+    memset(list, 0, sizeof(*list));
+
+    // The wildcard does the extension match (case-insensitively, like the
+    // filesystem); large fetches return the directory in as few calls as possible.
+    char wildcard[64];
+    snprintf(wildcard, sizeof(wildcard), "*%s", extension);
     char searchPattern[MAX_PATH];
-    BuildWindowsPath(searchPattern, sizeof(searchPattern), directory, pattern);
+    BuildWindowsPath(searchPattern, sizeof(searchPattern), directory, wildcard);
 
     WIN32_FIND_DATAA findData;
-    HANDLE hFind = FindFirstFileA(searchPattern, &findData);
+    HANDLE hFind = FindFirstFileExA(searchPattern, FindExInfoBasic, &findData, FindExSearchNameMatch, NULL,
+                                    FIND_FIRST_EX_LARGE_FETCH);
     if (hFind == INVALID_HANDLE_VALUE)
-        return;
+        return GetLastError() == ERROR_FILE_NOT_FOUND;
 
+    bool ok = true;
     do
     {
         if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
             continue;
-
-        char fullPath[MAX_PATH];
-        BuildWindowsPath(fullPath, sizeof(fullPath), directory, findData.cFileName);
-        fileCallback(fullPath, userData);
+        size_t length = strlen(findData.cFileName);
+        if (length >= MAX_FILE_PATH)
+            continue;
+        if (!AppendFileListName(arena, list, findData.cFileName, length))
+        {
+            ok = false;
+            break;
+        }
     } while (FindNextFileA(hFind, &findData));
     FindClose(hFind);
-}
 
-bool EnsureDirectoryExists(const char *dirPath)
-{
-    if (!CreateDirectoryA(dirPath, NULL))
+    if (!ok)
     {
-        DWORD err = GetLastError();
-        if (err != ERROR_ALREADY_EXISTS)
-            return false;
+        FreeFileList(arena, list);
+        return false;
     }
+    SortFileList(list);
     return true;
 }
 
-static void AddFileToListCallback(const char *fullPath, void *userData)
+void SortFileList(FileList *list)
 {
-    ListFilesData *data = (ListFilesData *)userData;
-    if (!data || !data->pCount)
-        return;
-
-    int idx = *(data->pCount);
-    if (idx >= data->maxFiles)
-        return; 
-
-    const char *slash1 = strrchr(fullPath, '/');
-    const char *slash2 = strrchr(fullPath, '\\');
-    const char *baseName = NULL;
-    if (slash1 && slash2)
-        baseName = (slash1 > slash2) ? slash1 + 1 : slash2 + 1;
-    else if (slash1)
-        baseName = slash1 + 1;
-    else if (slash2)
-        baseName = slash2 + 1;
-    else
-        baseName = fullPath;
-
-    snprintf(data->files[idx], 256, "%s", baseName);
-    idx++;
-    *(data->pCount) = idx;
+    const char *names = list->names;
+    std::sort(list->offsets, list->offsets + list->count,
+              [names](int a, int b) { return strcmp(names + a, names + b) < 0; });
 }
 
-int ListFilesInDirectory(const char *directory, const char *extension,
-                         char fileList[][256], int maxFiles)
+void FreeFileList(MemoryArena *arena, FileList *list)
 {
-    if (!directory || !extension || maxFiles <= 0)
-        return 0;
-
-    int fileCount = 0;
-    ListFilesData data = {fileList, maxFiles, &fileCount};
-
-    char wildcard[64];
-    snprintf(wildcard, sizeof(wildcard), "*%s", extension);
-
-    EnumerateDirectoryNoRecursion(directory, wildcard, AddFileToListCallback, &data);
-    return fileCount;
+    if (list->names)
+        arena_free(arena, list->names);
+    if (list->offsets)
+        arena_free(arena, list->offsets);
+    memset(list, 0, sizeof(*list));
 }
 
-static bool EndsWith(const char *str, const char *suffix)
+bool IsRegularFile(const char *path)
 {
-    if (!str || !suffix)
-        return false;
-    size_t strLen = strlen(str);
-    size_t sufLen = strlen(suffix);
-    if (sufLen > strLen)
-        return false;
-    return _stricmp(str + strLen - sufLen, suffix) == 0;
+    DWORD attributes = GetFileAttributesA(path);
+    return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
 }
 
-static void CountExtensionCallback(const char *fullPath, void *userData)
+bool MapFile(const char *path, MappedFile *file)
 {
-    ExtCountData *data = (ExtCountData *)userData;
-    if (!data || !data->pCount)
-        return;
+    memset(file, 0, sizeof(*file));
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
 
-    const char *fname = strrchr(fullPath, '\\');
-    fname = fname ? fname + 1 : fullPath;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart <= 0)
+    {
+        CloseHandle(handle);
+        return false;
+    }
+    // The view keeps the mapping and the file open after their handles close.
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (!mapping)
+        return false;
+    void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data)
+        return false;
 
-    if (!data->extension || data->extension[0] == '\0')
-        (*data->pCount)++;
-    else if (EndsWith(fname, data->extension))
-        (*data->pCount)++;
+    file->data = (unsigned char *)data;
+    file->size = (size_t)size.QuadPart;
+    return true;
 }
 
-int CountFilesWithExtension(const char *dir, const char *extension)
+void UnmapFile(MappedFile *file)
 {
-    if (!dir || !extension || extension[0] == '\0')
-        return 0;
-
-    int count = 0;
-    ExtCountData data = {extension, &count};
-
-    char wildcard[64];
-    snprintf(wildcard, sizeof(wildcard), "*%s", extension);
-
-    EnumerateDirectoryNoRecursion(dir, wildcard, CountExtensionCallback, &data);
-    return count;
+    if (file->data)
+        UnmapViewOfFile(file->data);
+    memset(file, 0, sizeof(*file));
 }
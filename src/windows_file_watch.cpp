@@ -0,0 +1,141 @@
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "file_watch.h"
+
+#define MAX_WATCHED_DIRECTORIES 16
+
+typedef struct WatchedDirectory
+{
+    HANDLE handle;
+    OVERLAPPED overlapped;
+    char path[MAX_FILE_PATH];
+    // FILE_NOTIFY_INFORMATION records must be DWORD aligned.
+    DWORD buffer[2048];
+} WatchedDirectory;
+
+struct DirectoryWatch
+{
+    HANDLE wakeEvent; // Signaled by WakeDirectoryWatch.
+    int count;
+    WatchedDirectory directories[MAX_WATCHED_DIRECTORIES];
+};
+
+static const DWORD watchFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+// Queue the next overlapped read of the directory's changes.
+static bool IssueDirectoryRead(WatchedDirectory *dir)
+{
+    ResetEvent(dir->overlapped.hEvent);
+    return ReadDirectoryChangesW(dir->handle, dir->buffer, sizeof(dir->buffer), FALSE, watchFilter,
+                                 NULL, &dir->overlapped, NULL) != 0;
+}
+
+DirectoryWatch *OpenDirectoryWatch(const char *const *directories, int count)
+{
+    DirectoryWatch *watch = (DirectoryWatch *)calloc(1, sizeof(DirectoryWatch));
+    if (!watch)
+        return NULL;
+    watch->wakeEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+    for (int i = 0; i < count && watch->count < MAX_WATCHED_DIRECTORIES; i++)
+    {
+        WatchedDirectory *dir = &watch->directories[watch->count];
+        dir->handle = CreateFileA(directories[i], FILE_LIST_DIRECTORY,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                                  FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+        if (dir->handle == INVALID_HANDLE_VALUE)
+            continue;
+        dir->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+        if (!IssueDirectoryRead(dir))
+        {
+            CloseHandle(dir->overlapped.hEvent);
+            CloseHandle(dir->handle);
+            continue;
+        }
+
+        // Store the directory without its trailing separator.
+        snprintf(dir->path, sizeof(dir->path), "%s", directories[i]);
+        size_t len = strlen(dir->path);
+        while (len > 1 && (dir->path[len - 1] == '/' || dir->path[len - 1] == '\\'))
+            dir->path[--len] = '\0';
+        watch->count++;
+    }
+
+    if (watch->count == 0 || watch->wakeEvent == NULL)
+    {
+        CloseDirectoryWatch(watch);
+        return NULL;
+    }
+    return watch;
+}
+
+int WaitDirectoryChanges(DirectoryWatch *watch, char paths[][MAX_FILE_PATH], int maxPaths, int timeoutMs)
+{
+    HANDLE events[MAX_WATCHED_DIRECTORIES + 1];
+    events[0] = watch->wakeEvent;
+    for (int i = 0; i < watch->count; i++)
+        events[i + 1] = watch->directories[i].overlapped.hEvent;
+
+    DWORD result = WaitForMultipleObjects(watch->count + 1, events, FALSE,
+                                          (timeoutMs < 0) ? INFINITE : (DWORD)timeoutMs);
+    if (result == WAIT_TIMEOUT)
+        return 0;
+    if (result == WAIT_OBJECT_0 || result == WAIT_FAILED)
+        return -1;
+
+    // Collect every directory whose read completed, not only the first one.
+    int stored = 0;
+    for (int i = 0; i < watch->count; i++)
+    {
+        WatchedDirectory *dir = &watch->directories[i];
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(dir->handle, &dir->overlapped, &bytes, FALSE))
+            continue;
+
+        // Zero bytes means the buffer overflowed; those changes are lost.
+        const unsigned char *p = (const unsigned char *)dir->buffer;
+        while (bytes > 0)
+        {
+            const FILE_NOTIFY_INFORMATION *info = (const FILE_NOTIFY_INFORMATION *)p;
+            if ((info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED ||
+                 info->Action == FILE_ACTION_RENAMED_NEW_NAME) &&
+                stored < maxPaths)
+            {
+                char name[MAX_FILE_PATH];
+                int len = WideCharToMultiByte(CP_UTF8, 0, info->FileName, (int)(info->FileNameLength / sizeof(WCHAR)),
+                                              name, sizeof(name) - 1, NULL, NULL);
+                name[len] = '\0';
+                snprintf(paths[stored++], MAX_FILE_PATH, "%s/%s", dir->path, name);
+            }
+            if (info->NextEntryOffset == 0)
+                break;
+            p += info->NextEntryOffset;
+        }
+        IssueDirectoryRead(dir);
+    }
+    return stored;
+}
+
+void WakeDirectoryWatch(DirectoryWatch *watch)
+{
+    if (watch && watch->wakeEvent)
+        SetEvent(watch->wakeEvent);
+}
+
+void CloseDirectoryWatch(DirectoryWatch *watch)
+{
+    if (!watch)
+        return;
+    for (int i = 0; i < watch->count; i++)
+    {
+        WatchedDirectory *dir = &watch->directories[i];
+        CancelIo(dir->handle);
+        CloseHandle(dir->handle);
+        CloseHandle(dir->overlapped.hEvent);
+    }
+    if (watch->wakeEvent)
+        CloseHandle(watch->wakeEvent);
+    free(watch);
+}
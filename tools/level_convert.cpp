@@ -0,0 +1,115 @@
+/*******************************************************************************************
+ * Level converter: rewrites levels in ./res/levels as binary levels (see
+ * src/level_format.h), which load by mapping the file instead of parsing it.
+ *
+ *   level_convert [--raw] <level> [<level>...]
+ *   level_convert [--raw] <level> --out <name>
+ *
+ * Levels are named as in the level list, e.g. castle.level, and are rewritten in place
+ * unless --out names the file to write instead. Text and binary levels are both accepted,
+ * so this also switches binary levels between the run-length encoded tiles SaveLevel
+ * writes and the raw tiles --raw asks for. Run it from the directory holding res/, like
+ * the game.
+ *******************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <raylib.h>
+#include "game_storage.h"
+#include "file_io.h"
+
+bool editorMode = false;
+int entityAssetCount = 0;
+int levelFileCount = 0;
+char (*levelFiles)[MAX_FILE_PATH] = NULL;
+Camera2D camera;
+
+EntityAsset *entityAssets = NULL;
+GameState *gameState = NULL;
+
+static bool ConvertLevel(const char *levelFilename, const char *outputFilename)
+{
+    // Each level starts from an empty arena, as it does in the game.
+    arena_reset(&gameArena);
+    gameState = (GameState *)arena_alloc(&gameArena, sizeof(GameState));
+    if (!gameState)
+    {
+        TraceLog(LOG_ERROR, "Failed to allocate memory for gameState");
+        return false;
+    }
+    memset(gameState, 0, sizeof(GameState));
+
+    if (!LoadLevel(levelFilename, &mapTiles, &gameState->player, &gameState->enemies, &gameState->enemyCount,
+                   &gameState->bossEnemy, &gameState->checkpoints, &gameState->checkpointCount))
+        return false;
+    if (!SaveLevel(outputFilename, mapTiles, gameState->player, gameState->enemies, gameState->bossEnemy))
+        return false;
+
+    char outputPath[MAX_FILE_PATH + 16];
+    snprintf(outputPath, sizeof(outputPath), "./res/levels/%s", outputFilename);
+    MappedFile output;
+    size_t outputSize = MapFile(outputPath, &output) ? output.size : 0;
+    UnmapFile(&output);
+    printf("%s -> %s: %dx%d tiles (%s), %d enemies, %d checkpoints, %d spawners, %zu bytes\n", levelFilename,
+           outputFilename, currentMapWidth, currentMapHeight, saveRawLevelTiles ? "raw" : "run-length encoded",
+           gameState->enemyCount, gameState->checkpointCount, gameState->spawnerCount, outputSize);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *outputFilename = NULL;
+    int levelCount = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outputFilename = argv[++i];
+        else if (strcmp(argv[i], "--raw") == 0)
+            saveRawLevelTiles = true;
+        else if (argv[i][0] != '-')
+            levelCount++;
+        else
+        {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (levelCount == 0 || (outputFilename != NULL && levelCount != 1))
+    {
+        fprintf(stderr, "usage: level_convert [--raw] <level> [<level>...]\n"
+                        "       level_convert [--raw] <level> --out <name>\n");
+        return 2;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    arena_init(&gameArena, GAME_ARENA_SIZE);
+    arena_init(&assetArena, 2 * GAME_ARENA_SIZE);
+
+    // Entity assets are only needed to check the level's references; their textures aren't.
+    skipTextureUpload = true;
+    if (!LoadEntityAssets("./res/entities/", &entityAssets, &entityAssetCount))
+        TraceLog(LOG_WARNING, "No entity assets found in ./res/entities");
+    UpdateEntityAssetIndex(0);
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--out") == 0)
+        {
+            i++;
+            continue;
+        }
+        if (strcmp(argv[i], "--raw") == 0)
+            continue;
+        const char *levelFilename = argv[i];
+        if (!ConvertLevel(levelFilename, outputFilename ? outputFilename : levelFilename))
+        {
+            fprintf(stderr, "%s: conversion failed\n", levelFilename);
+            failures++;
+        }
+    }
+
+    arena_destroy(&gameArena);
+    arena_destroy(&assetArena);
+    return (failures == 0) ? 0 : 1;
+}
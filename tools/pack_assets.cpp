@@ -0,0 +1,193 @@
+/*******************************************************************************************
+ * Asset packer: bundles everything under res/ into one asset pack (see src/asset_pack.h),
+ * which the game maps at startup instead of opening every asset file on its own.
+ *
+ *   pack_assets [<res directory> [<pack>]]
+ *
+ * The defaults are res and res.pak, so running it from the directory holding res/ writes
+ * the res.pak the game looks for. Files are stored under the paths the game asks for them
+ * by (res/sprites/player.png, ...) whichever directory they were read from. res/saves is
+ * left out: saves are written by the game and always read from disk.
+ *******************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "asset_pack.h"
+
+namespace fs = std::filesystem;
+
+typedef struct PackFile
+{
+    std::string name; // As stored: "res/" and the path under the res directory.
+    std::string path; // Where it is read from.
+    uint64_t size;
+} PackFile;
+
+static uint64_t AlignPackOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+static bool CollectFiles(const char *resDirectory, std::vector<PackFile> *files)
+{
+    std::error_code error;
+    fs::recursive_directory_iterator it(resDirectory, error), end;
+    if (error)
+    {
+        fprintf(stderr, "Can't read %s: %s\n", resDirectory, error.message().c_str());
+        return false;
+    }
+    for (; it != end; it.increment(error))
+    {
+        if (error)
+        {
+            fprintf(stderr, "Can't read %s: %s\n", resDirectory, error.message().c_str());
+            return false;
+        }
+        std::string relative = it->path().lexically_relative(resDirectory).generic_string();
+        if (it->is_directory(error) && relative == "saves")
+        {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file(error))
+            continue;
+        PackFile file = {"res/" + relative, it->path().string(), (uint64_t)it->file_size(error)};
+        if (file.name.size() >= MAX_FILE_PATH)
+        {
+            fprintf(stderr, "Skipping %s: the path is too long\n", file.name.c_str());
+            continue;
+        }
+        files->push_back(file);
+    }
+    // Sorted, so the same res/ always gives the same pack.
+    std::sort(files->begin(), files->end(), [](const PackFile &a, const PackFile &b) { return a.name < b.name; });
+    return true;
+}
+
+static bool WritePadding(FILE *out, uint64_t *position, uint64_t target)
+{
+    static const unsigned char zeros[ASSET_PACK_ALIGN] = {0};
+    while (*position < target)
+    {
+        size_t padding = (size_t)std::min<uint64_t>(target - *position, sizeof(zeros));
+        if (fwrite(zeros, 1, padding, out) != padding)
+            return false;
+        *position += padding;
+    }
+    return true;
+}
+
+static bool WritePack(const char *packPath, const std::vector<PackFile> &files)
+{
+    uint32_t entryCount = (uint32_t)files.size();
+    uint32_t slotCount = 1;
+    while (slotCount < entryCount * 2)
+        slotCount *= 2;
+
+    AssetPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = entryCount;
+    header.slotCount = slotCount;
+    header.slotsOffset = sizeof(AssetPackHeader);
+    header.entriesOffset = AlignPackOffset(header.slotsOffset + sizeof(uint32_t) * slotCount, sizeof(uint64_t));
+    header.namesOffset = header.entriesOffset + sizeof(AssetPackEntry) * entryCount;
+
+    std::vector<AssetPackEntry> entries(entryCount);
+    std::string names;
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        AssetPackEntry *entry = &entries[i];
+        entry->pathHash = HashAssetPath(files[i].name.c_str());
+        entry->nameOffset = (uint32_t)names.size();
+        entry->nameLength = (uint32_t)files[i].name.size();
+        entry->size = files[i].size;
+        names += files[i].name;
+        names += '\0';
+    }
+    header.namesSize = names.size();
+
+    uint64_t offset = header.namesOffset + header.namesSize;
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        offset = AlignPackOffset(offset, ASSET_PACK_ALIGN);
+        entries[i].offset = offset;
+        offset += entries[i].size;
+    }
+
+    std::vector<uint32_t> slots(slotCount, 0);
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        uint32_t slot = (uint32_t)entries[i].pathHash & (slotCount - 1);
+        while (slots[slot] != 0)
+            slot = (slot + 1) & (slotCount - 1);
+        slots[slot] = i + 1;
+    }
+
+    FILE *out = fopen(packPath, "wb");
+    if (!out)
+    {
+        fprintf(stderr, "Can't open %s for writing\n", packPath);
+        return false;
+    }
+    uint64_t position = 0;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    position += sizeof(header);
+    ok = ok && fwrite(slots.data(), sizeof(uint32_t), slotCount, out) == slotCount;
+    position += sizeof(uint32_t) * slotCount;
+    ok = ok && WritePadding(out, &position, header.entriesOffset);
+    ok = ok && (entryCount == 0 || fwrite(entries.data(), sizeof(AssetPackEntry), entryCount, out) == entryCount);
+    ok = ok && fwrite(names.data(), 1, names.size(), out) == names.size();
+    position = header.namesOffset + header.namesSize;
+
+    for (uint32_t i = 0; ok && i < entryCount; i++)
+    {
+        ok = WritePadding(out, &position, entries[i].offset);
+        if (!ok || entries[i].size == 0)
+            continue;
+        MappedFile file;
+        if (!MapFile(files[i].path.c_str(), &file) || file.size != entries[i].size)
+        {
+            fprintf(stderr, "Can't read %s\n", files[i].path.c_str());
+            UnmapFile(&file);
+            ok = false;
+            break;
+        }
+        ok = fwrite(file.data, 1, file.size, out) == file.size;
+        position += file.size;
+        UnmapFile(&file);
+    }
+    if (fclose(out) != 0)
+        ok = false;
+    if (!ok)
+    {
+        fprintf(stderr, "Failed writing %s\n", packPath);
+        remove(packPath);
+        return false;
+    }
+    printf("%s: %u files, %llu bytes\n", packPath, entryCount, (unsigned long long)position);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 3 || (argc > 1 && argv[1][0] == '-'))
+    {
+        fprintf(stderr, "usage: pack_assets [<res directory> [<pack>]]\n");
+        return 2;
+    }
+    const char *resDirectory = (argc > 1) ? argv[1] : "res";
+    const char *packPath = (argc > 2) ? argv[2] : ASSET_PACK_PATH;
+
+    std::vector<PackFile> files;
+    if (!CollectFiles(resDirectory, &files))
+        return 1;
+    return WritePack(packPath, files) ? 0 : 1;
+}